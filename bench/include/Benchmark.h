@@ -0,0 +1,35 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_BENCH_BENCHMARK_H
+#define VIPER_BENCH_BENCHMARK_H 1
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bench
+{
+    // Best times over all iterations, since the slower ones only measure noise from the rest of the machine
+    struct Result
+    {
+        std::uint64_t bytes{ 0 }; // Of the main file, imported modules are counted in the parse time only
+        std::uint64_t tokens{ 0 };
+        std::uint64_t nodes{ 0 }; // Nodes and scopes created while parsing, including imported ones
+        double lexSeconds{ 0 };
+        double parseSeconds{ 0 };
+        double typeCheckSeconds{ 0 };
+        double emitSeconds{ 0 };
+        long peakMemoryKiB{ 0 };
+    };
+
+    // Lexes, parses, type checks and emits IR for mainFile, with its directory as the import search path.
+    // Runs in a child process so the peak memory is that of this corpus alone. Returns nothing if the corpus fails to compile
+    std::optional<Result> RunCorpus(const std::filesystem::path& mainFile, int iterations);
+
+    // One JSON object on a single line, so the results of a run can be read as JSON lines
+    std::string FormatResult(std::string_view name, const Result& result);
+}
+
+#endif // VIPER_BENCH_BENCHMARK_H
@@ -0,0 +1,28 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_BENCH_GENERATOR_H
+#define VIPER_BENCH_GENERATOR_H 1
+
+#include <filesystem>
+#include <string>
+
+namespace bench
+{
+    // The shape of a synthetic corpus. The same options always generate the same sources
+    struct CorpusOptions
+    {
+        std::string name;
+        int functions = 200;
+        int nestingDepth = 2; // Levels of if and while statements in each function body
+        int namespaceDepth = 0; // Namespaces the functions are nested in
+        int structs = 0;
+        int fields = 4; // Fields of each struct, all of which are summed by a method
+        int imports = 0; // Modules the main file imports, each defining a few exported functions
+        int expressionSize = 4; // Operands in each arithmetic expression
+    };
+
+    // Writes the corpus to directory and returns the path of its main file, which imports the rest
+    std::filesystem::path GenerateCorpus(const CorpusOptions& options, const std::filesystem::path& directory);
+}
+
+#endif // VIPER_BENCH_GENERATOR_H
@@ -0,0 +1,183 @@
+// Copyright 2024 solar-mist
+
+
+#include "Benchmark.h"
+
+#include "lexer/Lexer.h"
+#include "lexer/SourceManager.h"
+#include "lexer/TokenStream.h"
+
+#include "parser/Parser.h"
+#include "parser/ConstantFolder.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include "symbol/Import.h"
+#include "symbol/CompilationContext.h"
+
+#include "support/Arena.h"
+#include "support/TimeReport.h"
+
+#include <vipir/IR/IRBuilder.h>
+#include <vipir/Module.h>
+#include <vipir/ABI/SysV.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace bench
+{
+    static double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Counting nodes goes through the time report, which would slow parsing down, so only the warm-up run counts them
+    static Result RunOnce(const std::filesystem::path& mainFile, bool countNodes)
+    {
+        diagnostic::Diagnostics diag;
+        diag.setErrorSender("viper-bench");
+        diag.setFileName(mainFile.string());
+
+        CompilationContext context;
+        context.makeCurrent();
+
+        std::optional<support::TimeReport> timeReport;
+        if (countNodes)
+        {
+            timeReport.emplace();
+            timeReport->makeCurrent();
+        }
+
+        lexing::SourceManager sourceManager;
+        support::Arena arena;
+        symbol::ImportManager importManager(sourceManager, arena);
+        importManager.addSearchPath(mainFile.parent_path().string());
+
+        lexing::SourceBuffer* source = sourceManager.open(mainFile);
+        if (!source)
+        {
+            diag.fatalError(std::format("{}: could not read file", mainFile.string()));
+        }
+        diag.setText(source->getText());
+
+        Result result;
+        result.bytes = source->getText().size();
+
+        auto start = std::chrono::steady_clock::now();
+        lexing::Lexer lexer(*source, diag);
+        lexing::TokenStream tokens = lexer.lex();
+        result.lexSeconds = SecondsSince(start);
+        result.tokens = tokens.size();
+
+        start = std::chrono::steady_clock::now();
+        parser::Parser parser(tokens, diag, importManager, arena);
+        auto ast = parser.parse();
+        result.parseSeconds = SecondsSince(start);
+        if (timeReport)
+        {
+            result.nodes = timeReport->getAllocationCount();
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (auto& node : ast)
+        {
+            node->typeCheck(nullptr, diag);
+        }
+        parser::ConstantFolder folder(arena, diag); // Timed with type checking, the driver runs it straight after
+        for (auto& node : ast)
+        {
+            folder.fold(node, nullptr);
+        }
+        result.typeCheckSeconds = SecondsSince(start);
+
+        vipir::IRBuilder builder;
+        vipir::Module module(mainFile.string());
+        module.setABI<vipir::abi::SysV>();
+
+        start = std::chrono::steady_clock::now();
+        for (auto& node : ast)
+        {
+            node->emit(builder, module, nullptr, diag);
+        }
+        result.emitSeconds = SecondsSince(start);
+
+        return result;
+    }
+
+    std::optional<Result> RunCorpus(const std::filesystem::path& mainFile, int iterations)
+    {
+        int fds[2];
+        if (pipe(fds) < 0)
+        {
+            return std::nullopt;
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return std::nullopt;
+        }
+
+        if (pid == 0)
+        {
+            close(fds[0]);
+
+            Result best = RunOnce(mainFile, true);
+            for (int i = 0; i < iterations; ++i)
+            {
+                Result result = RunOnce(mainFile, false);
+                best.lexSeconds = i == 0 ? result.lexSeconds : std::min(best.lexSeconds, result.lexSeconds);
+                best.parseSeconds = i == 0 ? result.parseSeconds : std::min(best.parseSeconds, result.parseSeconds);
+                best.typeCheckSeconds = i == 0 ? result.typeCheckSeconds : std::min(best.typeCheckSeconds, result.typeCheckSeconds);
+                best.emitSeconds = i == 0 ? result.emitSeconds : std::min(best.emitSeconds, result.emitSeconds);
+            }
+
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            best.peakMemoryKiB = usage.ru_maxrss;
+
+            bool written = write(fds[1], &best, sizeof(best)) == sizeof(best);
+            _exit(written ? 0 : 1);
+        }
+
+        close(fds[1]);
+        Result result;
+        bool received = read(fds[0], &result, sizeof(result)) == sizeof(result);
+        close(fds[0]);
+
+        int status;
+        waitpid(pid, &status, 0);
+        if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    std::string FormatResult(std::string_view name, const Result& result)
+    {
+        auto perSecond = [](std::uint64_t count, double seconds) {
+            return seconds > 0 ? count / seconds : 0.0;
+        };
+        double frontEndSeconds = result.lexSeconds + result.parseSeconds + result.typeCheckSeconds + result.emitSeconds;
+
+        return std::format("{{\"corpus\":\"{}\",\"bytes\":{},\"tokens\":{},\"nodes\":{},"
+            "\"lex_seconds\":{:.6f},\"parse_seconds\":{:.6f},\"typecheck_seconds\":{:.6f},\"emit_seconds\":{:.6f},"
+            "\"tokens_per_second\":{:.0f},\"nodes_per_second\":{:.0f},\"bytes_per_second\":{:.0f},\"peak_memory_kib\":{}}}",
+            name, result.bytes, result.tokens, result.nodes,
+            result.lexSeconds, result.parseSeconds, result.typeCheckSeconds, result.emitSeconds,
+            perSecond(result.tokens, result.lexSeconds), perSecond(result.nodes, result.parseSeconds),
+            perSecond(result.bytes, frontEndSeconds), result.peakMemoryKiB);
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright 2024 solar-mist
+
+
+#include "Generator.h"
+
+#include <format>
+#include <fstream>
+
+namespace bench
+{
+    // Alternates the arguments and literals with every binary operator, so no two expressions are identical
+    static std::string Expression(int size, int seed)
+    {
+        static constexpr const char* operators[] = { " + ", " - ", " * ", " & ", " | ", " ^ " };
+
+        std::string expression = "a";
+        for (int i = 1; i < size; ++i)
+        {
+            expression += operators[(seed + i) % std::size(operators)];
+            switch ((seed + i) % 3)
+            {
+                case 0:
+                    expression += "a";
+                    break;
+                case 1:
+                    expression += "b";
+                    break;
+                default:
+                    expression += std::to_string((seed * 7 + i) % 100 + 1);
+                    break;
+            }
+        }
+        return expression;
+    }
+
+    static std::string Block(const CorpusOptions& options, int depth, int seed, const std::string& indent)
+    {
+        std::string block = std::format("{}x = x + ({});\n", indent, Expression(options.expressionSize, seed + depth));
+        if (depth == 0)
+        {
+            return block;
+        }
+
+        if (depth % 2 == 0)
+        {
+            block += std::format("{}while (x < {}) {{\n", indent, 1000 + depth);
+        }
+        else
+        {
+            block += std::format("{}if (x > {}) {{\n", indent, depth);
+        }
+        block += Block(options, depth - 1, seed, indent + "    ");
+        block += indent + "}\n";
+        return block;
+    }
+
+    static std::string Function(const CorpusOptions& options, int index, const std::string& indent)
+    {
+        std::string function = std::format("{}func @function{}(a: i32, b: i32) -> i32 {{\n", indent, index);
+        std::string bodyIndent = indent + "    ";
+
+        function += std::format("{}let x: i32 = {};\n", bodyIndent, Expression(options.expressionSize, index));
+        function += Block(options, options.nestingDepth, index, bodyIndent);
+        if (index > 0)
+        {
+            function += std::format("{}x = x + function{}(b, a);\n", bodyIndent, index - 1);
+        }
+        if (options.imports > 0)
+        {
+            function += std::format("{}x = x + imported{}(a);\n", bodyIndent, index % options.imports);
+        }
+        function += std::format("{}return x;\n{}}}\n\n", bodyIndent, indent);
+        return function;
+    }
+
+    static std::string Struct(const CorpusOptions& options, int index)
+    {
+        std::string declaration = std::format("using struct Struct{} {{\n", index);
+        std::string sum;
+        for (int i = 0; i < options.fields; ++i)
+        {
+            declaration += std::format("    field{}: i32;\n", i);
+            sum += std::format("{}this->field{}", i == 0 ? "" : " + ", i);
+        }
+        if (sum.empty())
+        {
+            sum = "0";
+        }
+
+        declaration += std::format("\n    func @sum() -> i32 = {};\n\n", sum);
+        declaration += "    func @scaled(factor: i32) -> i32 {\n";
+        declaration += "        return this->sum() * factor;\n";
+        declaration += "    }\n}\n\n";
+        return declaration;
+    }
+
+    std::filesystem::path GenerateCorpus(const CorpusOptions& options, const std::filesystem::path& directory)
+    {
+        std::filesystem::create_directories(directory);
+
+        std::string source;
+        for (int i = 0; i < options.imports; ++i)
+        {
+            source += std::format("import module{};\n", i);
+
+            std::ofstream module(directory / std::format("module{}.vpr", i));
+            module << std::format("export func @imported{}(a: i32) -> i32 {{\n    return a + {};\n}}\n", i, i);
+        }
+        if (options.imports > 0)
+        {
+            source += "\n";
+        }
+
+        for (int i = 0; i < options.structs; ++i)
+        {
+            source += Struct(options, i);
+        }
+
+        std::string indent;
+        for (int i = 0; i < options.namespaceDepth; ++i)
+        {
+            source += std::format("{}namespace Namespace{} {{\n", indent, i);
+            indent += "    ";
+        }
+        for (int i = 0; i < options.functions; ++i)
+        {
+            source += Function(options, i, indent);
+        }
+        for (int i = options.namespaceDepth; i > 0; --i)
+        {
+            indent.resize(indent.size() - 4);
+            source += indent + "}\n";
+        }
+
+        std::filesystem::path mainFile = directory / std::format("{}.vpr", options.name);
+        std::ofstream(mainFile) << source;
+        return mainFile;
+    }
+}
@@ -0,0 +1,307 @@
+// Copyright 2024 solar-mist
+
+
+// Compiles each benchmark program with and without -O, links and runs it, and reports the
+// cycles it ran for and the size of its .text. Both builds must exit with the same status
+
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <spawn.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace bench
+{
+    struct Run
+    {
+        std::uint64_t textBytes{ 0 };
+        std::optional<std::uint64_t> cycles; // Not every machine lets unprivileged processes count cycles
+        double seconds{ 0 };
+        int exitStatus{ 0 };
+    };
+
+    // Runs a command to completion and returns its exit status, or -1 if it couldn't be started or was killed
+    static int RunCommand(const std::vector<std::string>& command)
+    {
+        std::vector<char*> argv;
+        for (auto& arg : command)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) != 0)
+        {
+            return -1;
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    static std::optional<std::uint64_t> TextSize(const std::filesystem::path& objectFile)
+    {
+        std::ifstream stream(objectFile, std::ios::binary);
+        std::string image((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (image.size() < sizeof(Elf64_Ehdr) || std::memcmp(image.data(), ELFMAG, SELFMAG) != 0)
+        {
+            return std::nullopt;
+        }
+
+        Elf64_Ehdr header;
+        std::memcpy(&header, image.data(), sizeof(header));
+        if (header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr) > image.size() || header.e_shstrndx >= header.e_shnum)
+        {
+            return std::nullopt;
+        }
+
+        auto section = [&](int index) {
+            Elf64_Shdr sectionHeader;
+            std::memcpy(&sectionHeader, image.data() + header.e_shoff + index * sizeof(Elf64_Shdr), sizeof(sectionHeader));
+            return sectionHeader;
+        };
+
+        Elf64_Shdr names = section(header.e_shstrndx);
+        for (int i = 0; i < header.e_shnum; ++i)
+        {
+            Elf64_Shdr sectionHeader = section(i);
+            if (names.sh_offset + sectionHeader.sh_name < image.size() && std::strcmp(image.data() + names.sh_offset + sectionHeader.sh_name, ".text") == 0)
+            {
+                return sectionHeader.sh_size;
+            }
+        }
+        return 0;
+    }
+
+    // Counts the user-space cycles of the program alone, by enabling the counter when the child calls exec
+    static std::optional<Run> RunProgram(const std::filesystem::path& executable)
+    {
+        int fds[2];
+        if (pipe(fds) < 0)
+        {
+            return std::nullopt;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return std::nullopt;
+        }
+        if (pid == 0)
+        {
+            close(fds[1]);
+            char go;
+            if (read(fds[0], &go, 1) != 1)
+            {
+                _exit(127);
+            }
+            execl(executable.c_str(), executable.c_str(), nullptr);
+            _exit(127);
+        }
+        close(fds[0]);
+
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+        attributes.disabled = 1;
+        attributes.enable_on_exec = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        int counter = syscall(SYS_perf_event_open, &attributes, pid, -1, -1, 0);
+
+        auto start = std::chrono::steady_clock::now();
+        char go = 0;
+        bool started = write(fds[1], &go, 1) == 1;
+        close(fds[1]);
+
+        int status;
+        waitpid(pid, &status, 0);
+
+        Run run;
+        run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (counter >= 0)
+        {
+            std::uint64_t cycles;
+            if (read(counter, &cycles, sizeof(cycles)) == sizeof(cycles))
+            {
+                run.cycles = cycles;
+            }
+            close(counter);
+        }
+
+        if (!started || !WIFEXITED(status) || WEXITSTATUS(status) == 127)
+        {
+            return std::nullopt;
+        }
+        run.exitStatus = WEXITSTATUS(status);
+        return run;
+    }
+
+    // Best of several runs, since the slower ones only measure noise from the rest of the machine
+    static std::optional<Run> Measure(const std::filesystem::path& program, const std::filesystem::path& directory, bool optimize,
+        const std::string& compiler, const std::string& linker, int iterations)
+    {
+        std::string name = program.stem().string() + (optimize ? "-O" : "");
+        std::filesystem::path objectFile = directory / (name + ".o");
+        std::filesystem::path executable = directory / name;
+
+        std::vector<std::string> compile = { compiler, "-o", objectFile.string(), program.string() };
+        if (optimize)
+        {
+            compile.push_back("-O");
+        }
+        if (RunCommand(compile) != 0)
+        {
+            std::cerr << std::format("viper-runtime-bench: {} failed to compile\n", name);
+            return std::nullopt;
+        }
+        if (RunCommand({ linker, "-no-pie", "-o", executable.string(), objectFile.string() }) != 0)
+        {
+            std::cerr << std::format("viper-runtime-bench: {} failed to link\n", name);
+            return std::nullopt;
+        }
+
+        std::optional<Run> best;
+        for (int i = 0; i < iterations; ++i)
+        {
+            std::optional<Run> run = RunProgram(executable);
+            if (!run)
+            {
+                std::cerr << std::format("viper-runtime-bench: {} failed to run\n", name);
+                return std::nullopt;
+            }
+
+            if (!best)
+            {
+                best = run;
+                continue;
+            }
+            best->seconds = std::min(best->seconds, run->seconds);
+            if (best->cycles && run->cycles)
+            {
+                best->cycles = std::min(*best->cycles, *run->cycles);
+            }
+        }
+
+        best->textBytes = TextSize(objectFile).value_or(0);
+        return best;
+    }
+
+    static std::string FormatCycles(const std::optional<std::uint64_t>& cycles)
+    {
+        return cycles ? std::to_string(*cycles) : "null";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string compiler = VIPER_COMPILER;
+    std::string linker = "cc";
+    std::filesystem::path programs = VIPER_BENCH_PROGRAMS;
+    int iterations = 5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.starts_with("--compiler="))
+        {
+            compiler = arg.substr(11);
+        }
+        else if (arg.starts_with("--linker="))
+        {
+            linker = arg.substr(9);
+        }
+        else if (arg.starts_with("--programs="))
+        {
+            programs = arg.substr(11);
+        }
+        else if (arg.starts_with("--iterations="))
+        {
+            std::string count = arg.substr(13);
+            auto [end, ec] = std::from_chars(count.data(), count.data() + count.size(), iterations);
+            if (ec != std::errc() || end != count.data() + count.size() || iterations <= 0)
+            {
+                std::cerr << std::format("viper-runtime-bench: invalid iteration count: {}\n", count);
+                return 1;
+            }
+        }
+        else
+        {
+            std::cerr << "usage: viper-runtime-bench [--compiler=PATH] [--linker=PATH] [--programs=DIR] [--iterations=N]\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::filesystem::path> sources;
+    std::error_code ec;
+    for (auto& entry : std::filesystem::directory_iterator(programs, ec))
+    {
+        if (entry.path().extension() == ".vpr")
+        {
+            sources.push_back(entry.path());
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    if (sources.empty())
+    {
+        std::cerr << std::format("viper-runtime-bench: no programs in {}\n", programs.string());
+        return 1;
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / std::format("viper-runtime-bench-{}", getpid());
+    std::filesystem::create_directories(directory);
+
+    setenv("VIPER_NO_SERVER", "1", 1); // A compile server from another build could be running an older compiler
+
+    int status = 0;
+    for (auto& source : sources)
+    {
+        auto baseline = bench::Measure(source, directory, false, compiler, linker, iterations);
+        auto optimized = bench::Measure(source, directory, true, compiler, linker, iterations);
+        if (!baseline || !optimized)
+        {
+            status = 1;
+            continue;
+        }
+
+        bool sameResult = baseline->exitStatus == optimized->exitStatus;
+        if (!sameResult)
+        {
+            std::cerr << std::format("viper-runtime-bench: {} exits with {} but with {} when optimized\n",
+                source.stem().string(), baseline->exitStatus, optimized->exitStatus);
+            status = 1;
+        }
+
+        std::cout << std::format("{{\"program\":\"{}\",\"text_bytes\":{},\"text_bytes_optimized\":{},"
+            "\"cycles\":{},\"cycles_optimized\":{},\"seconds\":{:.6f},\"seconds_optimized\":{:.6f},\"exit_status\":{},\"same_result\":{}}}",
+            source.stem().string(), baseline->textBytes, optimized->textBytes,
+            bench::FormatCycles(baseline->cycles), bench::FormatCycles(optimized->cycles),
+            baseline->seconds, optimized->seconds, baseline->exitStatus, sameResult) << std::endl;
+    }
+
+    std::filesystem::remove_all(directory, ec);
+    return status;
+}
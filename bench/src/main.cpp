@@ -0,0 +1,129 @@
+// Copyright 2024 solar-mist
+
+
+#include "Benchmark.h"
+#include "Generator.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace bench
+{
+    // Each corpus stresses one part of the front end, the rest stays at the baseline's size
+    static std::vector<CorpusOptions> DefaultSuite()
+    {
+        std::vector<CorpusOptions> suite;
+        suite.push_back({ .name = "baseline" });
+        suite.push_back({ .name = "many-functions", .functions = 5000, .nestingDepth = 1 });
+        suite.push_back({ .name = "deep-nesting", .nestingDepth = 24 });
+        suite.push_back({ .name = "deep-namespaces", .functions = 1000, .namespaceDepth = 16 });
+        suite.push_back({ .name = "many-structs", .functions = 50, .structs = 1000, .fields = 16 });
+        suite.push_back({ .name = "import-fan-out", .imports = 128 });
+        suite.push_back({ .name = "long-expressions", .expressionSize = 256 });
+        return suite;
+    }
+
+    static void Usage()
+    {
+        std::cerr << "usage: viper-bench [--functions=N] [--depth=N] [--namespaces=N] [--structs=N] [--fields=N] [--imports=N]\n"
+                     "                   [--expression=N] [--iterations=N] [--directory=DIR] [--generate]\n"
+                     "Runs the default suite unless a corpus shape is given. --generate only writes the corpus to DIR\n";
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::CorpusOptions custom{ .name = "custom" };
+    bool useCustom = false;
+    bool generateOnly = false;
+    int iterations = 5;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / std::format("viper-bench-{}", getpid());
+    bool keepDirectory = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--generate")
+        {
+            generateOnly = true;
+            keepDirectory = true;
+            continue;
+        }
+
+        auto equals = arg.find('=');
+        if (!arg.starts_with("--") || equals == std::string::npos)
+        {
+            bench::Usage();
+        }
+        std::string option = arg.substr(2, equals - 2);
+        std::string value = arg.substr(equals + 1);
+
+        if (option == "directory")
+        {
+            directory = value;
+            keepDirectory = true;
+            continue;
+        }
+
+        int number;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (ec != std::errc() || end != value.data() + value.size() || number < 0)
+        {
+            bench::Usage();
+        }
+
+        if (option == "iterations")
+        {
+            iterations = number;
+            continue;
+        }
+
+        useCustom = true;
+        if (option == "functions") custom.functions = number;
+        else if (option == "depth") custom.nestingDepth = number;
+        else if (option == "namespaces") custom.namespaceDepth = number;
+        else if (option == "structs") custom.structs = number;
+        else if (option == "fields") custom.fields = number;
+        else if (option == "imports") custom.imports = number;
+        else if (option == "expression") custom.expressionSize = std::max(number, 1);
+        else bench::Usage();
+    }
+
+    std::vector<bench::CorpusOptions> corpora = useCustom ? std::vector{ custom } : bench::DefaultSuite();
+
+    int status = 0;
+    for (auto& corpus : corpora)
+    {
+        std::filesystem::path mainFile = bench::GenerateCorpus(corpus, directory / corpus.name);
+        if (generateOnly)
+        {
+            std::cout << mainFile.string() << "\n";
+            continue;
+        }
+
+        if (auto result = bench::RunCorpus(mainFile, iterations))
+        {
+            std::cout << bench::FormatResult(corpus.name, *result) << std::endl;
+        }
+        else
+        {
+            std::cerr << std::format("viper-bench: corpus {} failed to compile\n", corpus.name);
+            status = 1;
+        }
+    }
+
+    if (!keepDirectory)
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+    return status;
+}
@@ -0,0 +1,20 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_COMPILER_DRIVER_H
+#define VIPER_COMPILER_DRIVER_H 1
+
+#include "lexer/SourceManager.h"
+
+#include "symbol/ModuleCache.h"
+
+#include <string>
+#include <vector>
+
+namespace driver
+{
+    // Runs one compiler invocation, args excludes the program name. Relative paths are taken
+    // from the working directory. Returns the exit status
+    int Compile(const std::vector<std::string>& args, lexing::SourceManager& sourceManager, symbol::ModuleCache& moduleCache);
+}
+
+#endif // VIPER_COMPILER_DRIVER_H
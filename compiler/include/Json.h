@@ -0,0 +1,58 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_COMPILER_JSON_H
+#define VIPER_COMPILER_JSON_H 1
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json
+{
+    // A JSON document, as much of JSON as the language server protocol needs
+    class Value
+    {
+    public:
+        using Array = std::vector<Value>;
+        using Object = std::vector<std::pair<std::string, Value> >; // Members in the order they were added
+
+        Value() = default;
+        Value(std::nullptr_t);
+        Value(bool value);
+        Value(int value);
+        Value(double value);
+        Value(std::string value);
+        Value(const char* value);
+        Value(Array value);
+        Value(Object value);
+
+        bool isNull() const;
+        bool isNumber() const;
+        bool isString() const;
+        bool isArray() const;
+        bool isObject() const;
+
+        bool getBool() const;
+        double getNumber() const;
+        const std::string& getString() const;
+        const Array& getArray() const;
+
+        // The member called key, or null if there is none or this isn't an object
+        const Value& operator[](std::string_view key) const;
+
+        std::string dump() const;
+
+        static std::optional<Value> Parse(std::string_view text);
+
+    private:
+        std::variant<std::nullptr_t, bool, double, std::string, Array, Object> mValue;
+
+        void dump(std::string& out) const;
+    };
+}
+
+#endif // VIPER_COMPILER_JSON_H
@@ -0,0 +1,18 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_COMPILER_LANGUAGE_SERVER_H
+#define VIPER_COMPILER_LANGUAGE_SERVER_H 1
+
+#include <string>
+#include <vector>
+
+namespace lsp
+{
+    // Speaks the language server protocol on standard input and output until the client sends exit.
+    // Each open document keeps its tokens, AST and scopes, and an edit inside one function body only
+    // lexes, parses and type checks that body again. Of args, only -I search paths are used.
+    // Returns the exit status the protocol asks for
+    int Serve(const std::vector<std::string>& args);
+}
+
+#endif // VIPER_COMPILER_LANGUAGE_SERVER_H
@@ -0,0 +1,27 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_COMPILER_SERVER_H
+#define VIPER_COMPILER_SERVER_H 1
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace server
+{
+    // $VIPER_SERVER_SOCKET if it is set, otherwise a socket in the user's runtime directory
+    std::filesystem::path GetSocketPath();
+
+    // Accepts compile requests on socketPath until interrupted. Every request is compiled in a
+    // child process forked from the server, so it starts with all modules any earlier request
+    // parsed, and a fatal error only ends that child. Returns the exit status of the server
+    int Serve(const std::filesystem::path& socketPath);
+
+    // Compiles args on the server listening on socketPath, with this process's working directory,
+    // standard output and standard error. Returns nothing if no server could be reached, or if the
+    // one there isn't this user's or is a different build of the compiler
+    std::optional<int> CompileOnServer(const std::filesystem::path& socketPath, const std::vector<std::string>& args);
+}
+
+#endif // VIPER_COMPILER_SERVER_H
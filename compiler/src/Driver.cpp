@@ -0,0 +1,524 @@
+// Copyright 2024 solar-mist
+
+
+#include "Driver.h"
+
+#include "lexer/Lexer.h"
+#include "lexer/Token.h"
+#include "lexer/TokenStream.h"
+
+#include "parser/Parser.h"
+#include "parser/ConstantFolder.h"
+
+#include "type/Type.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include "symbol/Import.h"
+#include "symbol/CompilationContext.h"
+#include "symbol/IncrementalCache.h"
+#include "symbol/ObjectCache.h"
+
+#include "support/Arena.h"
+#include "support/Hash.h"
+#include "support/MemoryReport.h"
+#include "support/TimeReport.h"
+#include "support/Trace.h"
+
+#include <vipir/IR/IRBuilder.h>
+#include <vipir/Module.h>
+#include <vipir/ABI/SysV.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+namespace driver
+{
+    struct CompileOptions
+    {
+        std::vector<std::string> importSearchPaths;
+        bool outputIR = false;
+        bool optimize = false;
+        bool emitInterfaces = false;
+        bool incremental = false;
+        bool writeDependencies = false;
+        bool timeReport = false;
+        bool memoryReport = false;
+        std::optional<std::filesystem::path> objectCacheDirectory;
+    };
+
+    static std::string EscapeForMake(std::string_view path)
+    {
+        std::string escaped;
+        for (char c : path)
+        {
+            if (c == ' ' || c == '#') escaped += '\\';
+            if (c == '$') escaped += '$';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // A Makefile rule saying target depends on the input and everything it imports, which is also what Ninja reads as a depfile
+    static std::string MakeDependencyRule(std::string_view target, std::string_view inputFilePath, const std::vector<std::filesystem::path>& dependencies)
+    {
+        std::string rule = std::format("{}: {}", EscapeForMake(target), EscapeForMake(inputFilePath));
+        for (auto& dependency : dependencies)
+        {
+            rule += std::format(" \\\n  {}", EscapeForMake(dependency.string()));
+        }
+        return rule + "\n";
+    }
+
+    // Compiles one input in a context of its own. Only the source manager and the module cache
+    // are shared with the other inputs, and both can be used from several threads at once
+    static void CompileFile(const std::string& inputFilePath, const std::string& outputFilePath, const std::string& dependencyFilePath, const CompileOptions& options,
+        lexing::SourceManager& sourceManager, symbol::ModuleCache& moduleCache)
+    {
+        support::Trace::Span span("compile", {}, inputFilePath, -1, -1);
+
+        diagnostic::Diagnostics diag;
+        diag.setErrorSender("viper");
+        diag.setFileName(inputFilePath);
+        diag.setExitOnError(false); // Compile stops the other workers and fails once they have finished
+
+        CompilationContext context;
+        context.makeCurrent();
+
+        std::optional<support::TimeReport> timeReport;
+        if (options.timeReport)
+        {
+            timeReport.emplace();
+            timeReport->makeCurrent();
+        }
+        std::optional<support::MemoryReport> memoryReport;
+        if (options.memoryReport)
+        {
+            memoryReport.emplace();
+            memoryReport->makeCurrent();
+        }
+        auto printReports = [&]() {
+            if (timeReport)
+            {
+                timeReport->getCounters().identifiers = context.getIdentifiers().size();
+                timeReport->getCounters().types = context.getTypes().size();
+                timeReport->print(std::cerr, inputFilePath);
+            }
+            if (memoryReport)
+            {
+                memoryReport->print(std::cerr, inputFilePath);
+            }
+        };
+
+        support::Arena arena;
+        symbol::ImportManager importManager(sourceManager, arena);
+        for (auto& searchPath : options.importSearchPaths)
+        {
+            importManager.addSearchPath(searchPath);
+        }
+        importManager.setEmitInterfaces(options.emitInterfaces);
+        importManager.setModuleCache(&moduleCache);
+
+        lexing::SourceBuffer* source = sourceManager.open(inputFilePath);
+        if (!source)
+        {
+            diag.fatalError(std::format("{}: could not read file", inputFilePath));
+        }
+
+        diag.setText(source->getText());
+
+        // Only the import statements are read, so a cache hit costs a lex of each file instead of a compilation
+        std::vector<const lexing::SourceBuffer*> imports;
+        if (options.objectCacheDirectory || options.incremental)
+        {
+            support::TimeReport::Phase phase("scanning imports");
+            imports = importManager.ScanDependencies(*source, diag);
+        }
+        auto writeScannedDependencies = [&]() {
+            if (!dependencyFilePath.empty())
+            {
+                std::vector<std::filesystem::path> dependencies;
+                for (auto module : imports)
+                {
+                    dependencies.push_back(module->getPath());
+                }
+                std::ofstream dependencyFile(dependencyFilePath);
+                dependencyFile << MakeDependencyRule(outputFilePath, inputFilePath, dependencies);
+            }
+        };
+
+        std::optional<symbol::ObjectCache> objectCache;
+        std::string objectCacheKey;
+        if (options.objectCacheDirectory)
+        {
+            support::TimeReport::Phase phase("object cache lookup");
+
+            std::string optionsKey = std::format("{}{}", options.outputIR, options.optimize);
+            for (auto& searchPath : options.importSearchPaths)
+            {
+                optionsKey += '\0';
+                optionsKey += searchPath;
+            }
+
+            objectCache.emplace(*options.objectCacheDirectory);
+            objectCacheKey = objectCache->key(*source, imports, optionsKey);
+            if (objectCache->fetch(objectCacheKey, outputFilePath))
+            {
+                writeScannedDependencies();
+                printReports();
+                return;
+            }
+        }
+
+        lexing::Lexer lexer(*source, diag);
+
+        lexing::TokenStream tokens = lexer.lex();
+
+        std::string cachePath = outputFilePath + ".vpc";
+        std::optional<symbol::IncrementalCache> cache;
+        if (options.incremental)
+        {
+            std::vector<std::uint64_t> importHashes;
+            for (auto module : imports)
+            {
+                importHashes.push_back(support::Hash(module->getText()));
+            }
+
+            std::uint64_t optionsHash = support::Hash(std::format("{}{}", options.outputIR, options.optimize));
+            cache.emplace(tokens, std::move(importHashes), optionsHash);
+            if (cache->isUpToDate(cachePath, outputFilePath))
+            {
+                writeScannedDependencies();
+                printReports();
+                return;
+            }
+        }
+
+        parser::Parser parser(tokens, diag, importManager, arena);
+    
+        vipir::IRBuilder builder;
+        vipir::Module module(inputFilePath);
+        module.setABI<vipir::abi::SysV>();
+
+        auto ast = parser.parse();
+
+        if (!dependencyFilePath.empty())
+        {
+            std::ofstream dependencyFile(dependencyFilePath);
+            dependencyFile << MakeDependencyRule(outputFilePath, inputFilePath, importManager.getModulePaths());
+        }
+
+        {
+            support::TimeReport::Phase phase("type checking");
+            for (auto& node : ast)
+            {
+                node->typeCheck(nullptr, diag);
+            }
+        }
+
+        {
+            support::TimeReport::Phase phase("constant folding");
+            parser::ConstantFolder folder(arena, diag);
+            for (auto& node : ast)
+            {
+                folder.fold(node, nullptr);
+            }
+        }
+    
+        {
+            support::TimeReport::Phase phase("emitting IR");
+            support::MemoryReport::Owning owning(support::MemoryReport::Owner::Vipir);
+            for (auto& node : ast)
+            {
+                node->emit(builder, module, nullptr, diag);
+            }
+        }
+
+        if (options.optimize)
+        {
+            module.addPass(vipir::Pass::PeepholeOptimization);
+        }
+    
+        {
+            // vipir runs the passes added above while printing or emitting, so they are timed as part of this
+            support::TimeReport::Phase phase(options.outputIR ? "optimizing and printing IR" : "optimizing and writing object");
+            support::MemoryReport::Owning owning(support::MemoryReport::Owner::Vipir);
+            std::ofstream outputFile = std::ofstream(outputFilePath);
+            if (options.outputIR)
+            {
+                module.print(outputFile);
+            }
+            else
+            {
+                module.emit(outputFile, vipir::OutputFormat::ELF);
+            }
+        }
+
+        if (cache)
+        {
+            cache->writeFile(cachePath, outputFilePath); // Without a cache the file is just emitted again next time
+        }
+        if (objectCache)
+        {
+            objectCache->store(objectCacheKey, outputFilePath);
+        }
+
+        printReports();
+    }
+
+    int Compile(const std::vector<std::string>& args, lexing::SourceManager& sourceManager, symbol::ModuleCache& moduleCache)
+    {
+        diagnostic::Diagnostics diag;
+        diag.setErrorSender("viper");
+
+        std::vector<std::string> inputFilePaths;
+        std::string outputFilePath;
+        std::string dependencyFilePath;
+        std::string traceFilePath;
+        bool scanDependencies = false;
+        unsigned int jobs = std::max(std::thread::hardware_concurrency(), 1u);
+        CompileOptions options;
+
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            std::string arg = args[i];
+            if (arg.starts_with('-'))
+            {
+                switch(arg[1])
+                {
+                    case 'I':
+                        if (arg.length() == 2)
+                        {
+                            options.importSearchPaths.push_back(args.at(++i));
+                        }
+                        else
+                        {
+                            options.importSearchPaths.push_back(arg.substr(2));
+                        }
+                        break;
+
+                    case 'i':
+                        options.outputIR = true;
+                        break;
+
+                    case 'o':
+                        if (arg.length() == 2)
+                            outputFilePath = args.at(++i);
+                        else
+                            outputFilePath = arg.substr(2);
+                        break;
+
+                    case 'O':
+                        options.optimize = true;
+                        break;
+
+                    case 'j':
+                    {
+                        std::string count = arg.length() == 2 ? args.at(++i) : arg.substr(2);
+                        auto [end, ec] = std::from_chars(count.data(), count.data() + count.size(), jobs);
+                        if (ec != std::errc() || end != count.data() + count.size() || jobs == 0)
+                        {
+                            diag.fatalError(std::format("invalid job count: {}", count));
+                        }
+                        break;
+                    }
+
+                    case 'M':
+                        if (arg == "-MD")
+                        {
+                            options.writeDependencies = true;
+                            break;
+                        }
+                        if (arg.starts_with("-MF"))
+                        {
+                            if (arg.length() == 3)
+                                dependencyFilePath = args.at(++i);
+                            else
+                                dependencyFilePath = arg.substr(3);
+                            break;
+                        }
+                        diag.fatalError(std::format("Unrecognized command-line option: {}", arg));
+
+                    case '-':
+                        if (arg == "--scan-deps")
+                        {
+                            scanDependencies = true;
+                            break;
+                        }
+                        if (arg.starts_with("--trace="))
+                        {
+                            traceFilePath = arg.substr(8);
+                            break;
+                        }
+                        diag.fatalError(std::format("Unrecognized command-line option: {}", arg));
+
+                    case 'f':
+                        if (arg == "-fmodule-interfaces")
+                        {
+                            options.emitInterfaces = true;
+                            break;
+                        }
+                        if (arg == "-fincremental")
+                        {
+                            options.incremental = true;
+                            break;
+                        }
+                        if (arg == "-ftime-report")
+                        {
+                            options.timeReport = true;
+                            break;
+                        }
+                        if (arg == "-fmem-report")
+                        {
+                            options.memoryReport = true;
+                            break;
+                        }
+                        if (arg == "-fobject-cache")
+                        {
+                            options.objectCacheDirectory = symbol::ObjectCache::DefaultDirectory();
+                            break;
+                        }
+                        if (arg.starts_with("-fobject-cache="))
+                        {
+                            options.objectCacheDirectory = arg.substr(15);
+                            break;
+                        }
+                        diag.fatalError(std::format("Unrecognized command-line option: {}", arg));
+
+                    default:
+                        diag.fatalError(std::format("Unrecognized command-line option: {}", arg));
+                }
+            }
+            else
+            {
+                inputFilePaths.push_back(arg);
+            }
+        }
+
+        if (inputFilePaths.empty())
+        {
+            diag.fatalError("no input files");
+        }
+        if (!outputFilePath.empty() && inputFilePaths.size() > 1)
+        {
+            diag.fatalError("cannot specify -o with multiple input files");
+        }
+        if (!dependencyFilePath.empty() && inputFilePaths.size() > 1)
+        {
+            diag.fatalError("cannot specify -MF with multiple input files");
+        }
+        for (auto& inputFilePath : inputFilePaths)
+        {
+            if (!std::filesystem::exists(inputFilePath))
+            {
+                diag.fatalError(std::format("{}: no such file or directory", inputFilePath));
+            }
+        }
+
+        auto outputFor = [&](const std::string& inputFilePath) {
+            if (!outputFilePath.empty()) return outputFilePath;
+            return inputFilePath + (options.outputIR ? ".i" : ".o");
+        };
+
+        if (scanDependencies)
+        {
+            std::string rules;
+            for (auto& inputFilePath : inputFilePaths)
+            {
+                diag.setFileName(inputFilePath);
+
+                lexing::SourceBuffer* source = sourceManager.open(inputFilePath);
+                if (!source)
+                {
+                    diag.fatalError(std::format("{}: could not read file", inputFilePath));
+                }
+                diag.setText(source->getText());
+
+                support::Arena arena;
+                symbol::ImportManager importManager(sourceManager, arena);
+                for (auto& searchPath : options.importSearchPaths)
+                {
+                    importManager.addSearchPath(searchPath);
+                }
+
+                std::vector<std::filesystem::path> dependencies;
+                for (auto dependency : importManager.ScanDependencies(*source, diag))
+                {
+                    dependencies.push_back(dependency->getPath());
+                }
+                rules += MakeDependencyRule(outputFor(inputFilePath), inputFilePath, dependencies);
+            }
+
+            if (dependencyFilePath.empty())
+            {
+                std::cout << rules;
+            }
+            else
+            {
+                std::ofstream(dependencyFilePath) << rules;
+            }
+            return 0;
+        }
+
+        auto dependencyFileFor = [&](const std::string& inputFilePath) -> std::string {
+            if (!options.writeDependencies) return std::string();
+            if (!dependencyFilePath.empty()) return dependencyFilePath;
+            return std::filesystem::path(outputFor(inputFilePath)).replace_extension(".d").string();
+        };
+
+        std::optional<support::Trace> trace;
+        if (!traceFilePath.empty())
+        {
+            trace.emplace();
+        }
+
+        std::atomic<std::size_t> nextInput = 0;
+        std::atomic<bool> failed = false;
+        auto worker = [&]() {
+            if (trace)
+            {
+                trace->makeCurrent();
+            }
+            // After an error the files already being compiled are finished, but no more are started
+            for (std::size_t i = nextInput++; i < inputFilePaths.size() && !failed; i = nextInput++)
+            {
+                try
+                {
+                    CompileFile(inputFilePaths[i], outputFor(inputFilePaths[i]), dependencyFileFor(inputFilePaths[i]), options, sourceManager, moduleCache);
+                }
+                catch (const diagnostic::CompileError&)
+                {
+                    failed = true;
+                }
+            }
+        };
+
+        jobs = std::min<std::size_t>(jobs, inputFilePaths.size());
+        if (jobs == 1)
+        {
+            worker();
+        }
+        else
+        {
+            std::vector<std::jthread> workers;
+            for (unsigned int i = 0; i < jobs; ++i)
+            {
+                workers.emplace_back(worker);
+            }
+        }
+
+        if (trace && !trace->writeFile(traceFilePath))
+        {
+            diag.fatalError(std::format("{}: could not write trace", traceFilePath));
+        }
+
+        return failed ? EXIT_FAILURE : 0;
+    }
+}
@@ -0,0 +1,427 @@
+// Copyright 2024 solar-mist
+
+
+#include "Json.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <format>
+
+namespace json
+{
+    static const Value Null;
+
+    Value::Value(std::nullptr_t)
+    {
+    }
+
+    Value::Value(bool value)
+        : mValue(value)
+    {
+    }
+
+    Value::Value(int value)
+        : mValue(static_cast<double>(value))
+    {
+    }
+
+    Value::Value(double value)
+        : mValue(value)
+    {
+    }
+
+    Value::Value(std::string value)
+        : mValue(std::move(value))
+    {
+    }
+
+    Value::Value(const char* value)
+        : mValue(std::string(value))
+    {
+    }
+
+    Value::Value(Array value)
+        : mValue(std::move(value))
+    {
+    }
+
+    Value::Value(Object value)
+        : mValue(std::move(value))
+    {
+    }
+
+    bool Value::isNull() const
+    {
+        return std::holds_alternative<std::nullptr_t>(mValue);
+    }
+
+    bool Value::isNumber() const
+    {
+        return std::holds_alternative<double>(mValue);
+    }
+
+    bool Value::isString() const
+    {
+        return std::holds_alternative<std::string>(mValue);
+    }
+
+    bool Value::isArray() const
+    {
+        return std::holds_alternative<Array>(mValue);
+    }
+
+    bool Value::isObject() const
+    {
+        return std::holds_alternative<Object>(mValue);
+    }
+
+    bool Value::getBool() const
+    {
+        auto value = std::get_if<bool>(&mValue);
+        return value && *value;
+    }
+
+    double Value::getNumber() const
+    {
+        auto value = std::get_if<double>(&mValue);
+        return value ? *value : 0;
+    }
+
+    const std::string& Value::getString() const
+    {
+        static const std::string empty;
+        auto value = std::get_if<std::string>(&mValue);
+        return value ? *value : empty;
+    }
+
+    const Value::Array& Value::getArray() const
+    {
+        static const Array empty;
+        auto value = std::get_if<Array>(&mValue);
+        return value ? *value : empty;
+    }
+
+    const Value& Value::operator[](std::string_view key) const
+    {
+        if (auto object = std::get_if<Object>(&mValue))
+        {
+            for (auto& [name, value] : *object)
+            {
+                if (name == key) return value;
+            }
+        }
+        return Null;
+    }
+
+    std::string Value::dump() const
+    {
+        std::string out;
+        dump(out);
+        return out;
+    }
+
+    static void DumpString(std::string& out, std::string_view text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        out += std::format("\\u{:04x}", static_cast<int>(c));
+                    else
+                        out += c;
+                    break;
+            }
+        }
+        out += '"';
+    }
+
+    void Value::dump(std::string& out) const
+    {
+        if (isNull())
+        {
+            out += "null";
+        }
+        else if (auto value = std::get_if<bool>(&mValue))
+        {
+            out += *value ? "true" : "false";
+        }
+        else if (auto value = std::get_if<double>(&mValue))
+        {
+            if (std::trunc(*value) == *value && std::abs(*value) < 1e15)
+                out += std::format("{}", static_cast<long long>(*value));
+            else
+                out += std::format("{}", *value);
+        }
+        else if (auto value = std::get_if<std::string>(&mValue))
+        {
+            DumpString(out, *value);
+        }
+        else if (auto value = std::get_if<Array>(&mValue))
+        {
+            out += '[';
+            for (std::size_t i = 0; i < value->size(); ++i)
+            {
+                if (i != 0) out += ',';
+                (*value)[i].dump(out);
+            }
+            out += ']';
+        }
+        else if (auto value = std::get_if<Object>(&mValue))
+        {
+            out += '{';
+            for (std::size_t i = 0; i < value->size(); ++i)
+            {
+                if (i != 0) out += ',';
+                DumpString(out, (*value)[i].first);
+                out += ':';
+                (*value)[i].second.dump(out);
+            }
+            out += '}';
+        }
+    }
+
+
+    class JsonParser
+    {
+    public:
+        JsonParser(std::string_view text)
+            : mText(text)
+            , mPosition(0)
+        {
+        }
+
+        std::optional<Value> parseDocument()
+        {
+            std::optional<Value> value = parseValue();
+            skipWhitespace();
+            if (mPosition != mText.size()) return std::nullopt;
+            return value;
+        }
+
+    private:
+        std::string_view mText;
+        std::size_t mPosition;
+
+        void skipWhitespace()
+        {
+            while (mPosition < mText.size() && (mText[mPosition] == ' ' || mText[mPosition] == '\t' || mText[mPosition] == '\n' || mText[mPosition] == '\r'))
+            {
+                ++mPosition;
+            }
+        }
+
+        bool consume(std::string_view expected)
+        {
+            if (mText.substr(mPosition, expected.size()) != expected) return false;
+            mPosition += expected.size();
+            return true;
+        }
+
+        std::optional<Value> parseValue()
+        {
+            skipWhitespace();
+            if (mPosition == mText.size()) return std::nullopt;
+
+            switch (mText[mPosition])
+            {
+                case 'n':
+                    if (consume("null")) return Value(nullptr);
+                    return std::nullopt;
+                case 't':
+                    if (consume("true")) return Value(true);
+                    return std::nullopt;
+                case 'f':
+                    if (consume("false")) return Value(false);
+                    return std::nullopt;
+                case '"':
+                {
+                    auto string = parseString();
+                    if (!string) return std::nullopt;
+                    return Value(std::move(*string));
+                }
+                case '[':
+                    return parseArray();
+                case '{':
+                    return parseObject();
+                default:
+                    return parseNumber();
+            }
+        }
+
+        std::optional<Value> parseNumber()
+        {
+            std::size_t start = mPosition;
+            while (mPosition < mText.size() && std::string_view("+-0123456789.eE").find(mText[mPosition]) != std::string_view::npos)
+            {
+                ++mPosition;
+            }
+            if (start == mPosition) return std::nullopt;
+
+            std::string number(mText.substr(start, mPosition - start));
+            char* end;
+            double value = std::strtod(number.c_str(), &end);
+            if (end != number.c_str() + number.size()) return std::nullopt;
+            return Value(value);
+        }
+
+        static void AppendUtf8(std::string& out, std::uint32_t codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                out += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                out += static_cast<char>(0xc0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3f));
+            }
+            else if (codePoint < 0x10000)
+            {
+                out += static_cast<char>(0xe0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (codePoint & 0x3f));
+            }
+            else
+            {
+                out += static_cast<char>(0xf0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (codePoint & 0x3f));
+            }
+        }
+
+        std::optional<std::uint32_t> parseHex4()
+        {
+            if (mText.size() - mPosition < 4) return std::nullopt;
+
+            std::uint32_t value = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = mText[mPosition++];
+                value <<= 4;
+                if (c >= '0' && c <= '9') value |= c - '0';
+                else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+                else return std::nullopt;
+            }
+            return value;
+        }
+
+        std::optional<std::string> parseString()
+        {
+            ++mPosition; // "
+
+            std::string string;
+            while (mPosition < mText.size())
+            {
+                char c = mText[mPosition++];
+                if (c == '"') return string;
+                if (c != '\\')
+                {
+                    string += c;
+                    continue;
+                }
+
+                if (mPosition == mText.size()) return std::nullopt;
+                switch (mText[mPosition++])
+                {
+                    case '"': string += '"'; break;
+                    case '\\': string += '\\'; break;
+                    case '/': string += '/'; break;
+                    case 'b': string += '\b'; break;
+                    case 'f': string += '\f'; break;
+                    case 'n': string += '\n'; break;
+                    case 'r': string += '\r'; break;
+                    case 't': string += '\t'; break;
+                    case 'u':
+                    {
+                        auto codePoint = parseHex4();
+                        if (!codePoint) return std::nullopt;
+                        if (*codePoint >= 0xd800 && *codePoint < 0xdc00 && consume("\\u")) // Surrogate pair
+                        {
+                            auto low = parseHex4();
+                            if (!low || *low < 0xdc00 || *low >= 0xe000) return std::nullopt;
+                            *codePoint = 0x10000 + ((*codePoint - 0xd800) << 10) + (*low - 0xdc00);
+                        }
+                        AppendUtf8(string, *codePoint);
+                        break;
+                    }
+                    default:
+                        return std::nullopt;
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<Value> parseArray()
+        {
+            ++mPosition; // [
+
+            Value::Array array;
+            skipWhitespace();
+            if (consume("]")) return Value(std::move(array));
+
+            while (true)
+            {
+                auto element = parseValue();
+                if (!element) return std::nullopt;
+                array.push_back(std::move(*element));
+
+                skipWhitespace();
+                if (consume("]")) return Value(std::move(array));
+                if (!consume(",")) return std::nullopt;
+            }
+        }
+
+        std::optional<Value> parseObject()
+        {
+            ++mPosition; // {
+
+            Value::Object object;
+            skipWhitespace();
+            if (consume("}")) return Value(std::move(object));
+
+            while (true)
+            {
+                skipWhitespace();
+                if (mPosition == mText.size() || mText[mPosition] != '"') return std::nullopt;
+                auto name = parseString();
+                if (!name) return std::nullopt;
+
+                skipWhitespace();
+                if (!consume(":")) return std::nullopt;
+
+                auto value = parseValue();
+                if (!value) return std::nullopt;
+                object.emplace_back(std::move(*name), std::move(*value));
+
+                skipWhitespace();
+                if (consume("}")) return Value(std::move(object));
+                if (!consume(",")) return std::nullopt;
+            }
+        }
+    };
+
+    std::optional<Value> Value::Parse(std::string_view text)
+    {
+        return JsonParser(text).parseDocument();
+    }
+}
@@ -0,0 +1,701 @@
+// Copyright 2024 solar-mist
+
+
+#include "LanguageServer.h"
+#include "Json.h"
+
+#include "lexer/Lexer.h"
+#include "lexer/SourceManager.h"
+#include "lexer/TokenStream.h"
+
+#include "parser/Parser.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include "symbol/CompilationContext.h"
+#include "symbol/Identifier.h"
+#include "symbol/Import.h"
+
+#include "support/Arena.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace lsp
+{
+    // Replaced bodies and every version of the text stay in the arena and source manager
+    // until the document is analysed from scratch, which bounds how much they can grow
+    constexpr int MaxIncrementalEdits = 64;
+
+    // Where a name is declared. Locals are only visible between scopeStart and scopeEnd,
+    // the extent of their function, while the others have no scope
+    struct Declaration
+    {
+        const lexing::SourceBuffer* source;
+        int start;
+        int end;
+        int scopeStart{ -1 };
+        int scopeEnd{ -1 };
+    };
+    using Declarations = std::unordered_map<symbol::SymbolID, std::vector<Declaration> >;
+
+    // The characters of a function body from its '{' or '=', up to the character after it
+    struct Body
+    {
+        parser::Function* function;
+        int start;
+        int end;
+    };
+
+    // Everything one analysis of a document made. Members are destroyed in reverse order,
+    // so the AST goes before the tokens, arena and context it refers to
+    struct Analysis
+    {
+        CompilationContext context;
+        lexing::SourceManager sourceManager;
+        support::Arena arena;
+        symbol::ImportManager importManager{ sourceManager, arena };
+
+        diagnostic::Diagnostics diag;
+        std::vector<diagnostic::Diagnostic> diagnostics;
+
+        lexing::SourceBuffer* source{ nullptr }; // The latest text
+        std::optional<lexing::TokenStream> tokens;
+        std::unordered_map<parser::Function*, std::unique_ptr<lexing::TokenStream> > bodyTokens; // Of bodies parsed again on their own
+        std::optional<parser::Parser> parser;
+        std::vector<parser::ASTNodePtr> ast;
+        std::vector<Body> bodies;
+        int incrementalEdits{ 0 };
+
+        std::optional<Declarations> declarations; // Of the latest text, found when first asked for
+        Declarations importedDeclarations;
+    };
+
+    struct Document
+    {
+        std::string uri;
+        std::filesystem::path path;
+        json::Value version;
+        std::unique_ptr<Analysis> analysis;
+    };
+
+
+    static std::filesystem::path UriToPath(std::string_view uri)
+    {
+        if (uri.starts_with("file://")) uri.remove_prefix(7);
+
+        std::string path;
+        for (std::size_t i = 0; i < uri.size(); ++i)
+        {
+            // A '%' that doesn't start an escape is kept as it is
+            unsigned char c;
+            if (uri[i] == '%' && i + 3 <= uri.size()
+                && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, c, 16).ptr == uri.data() + i + 3)
+            {
+                path += static_cast<char>(c);
+                i += 2;
+            }
+            else
+            {
+                path += uri[i];
+            }
+        }
+        return path;
+    }
+
+    static std::string PathToUri(const std::filesystem::path& path)
+    {
+        std::string uri = "file://";
+        for (char c : std::filesystem::absolute(path).lexically_normal().string())
+        {
+            if (std::isalnum(static_cast<unsigned char>(c)) || std::string_view("/-._~").find(c) != std::string_view::npos)
+                uri += c;
+            else
+                uri += std::format("%{:02X}", static_cast<unsigned char>(c));
+        }
+        return uri;
+    }
+
+    // Positions in the protocol are a line and a count of UTF-16 code units into it
+    static json::Value ToPosition(std::string_view text, int offset)
+    {
+        std::size_t end = std::min<std::size_t>(std::max(offset, 0), text.size());
+
+        int line = 0;
+        std::size_t lineStart = 0;
+        for (std::size_t i = 0; i < end; ++i)
+        {
+            if (text[i] == '\n')
+            {
+                ++line;
+                lineStart = i + 1;
+            }
+        }
+
+        int character = 0;
+        for (std::size_t i = lineStart; i < end; ++i)
+        {
+            unsigned char c = text[i];
+            if ((c & 0xc0) != 0x80) character += c >= 0xf0 ? 2 : 1;
+        }
+        return json::Value::Object{{"line", line}, {"character", character}};
+    }
+
+    static int ToOffset(std::string_view text, const json::Value& position)
+    {
+        int line = position["line"].getNumber();
+        int character = position["character"].getNumber();
+
+        std::size_t i = 0;
+        for (; line > 0 && i < text.size(); ++i)
+        {
+            if (text[i] == '\n') --line;
+        }
+        while (character > 0 && i < text.size() && text[i] != '\n')
+        {
+            character -= static_cast<unsigned char>(text[i]) >= 0xf0 ? 2 : 1;
+            while (++i < text.size() && (text[i] & 0xc0) == 0x80);
+        }
+        return i;
+    }
+
+    static json::Value ToRange(std::string_view text, int start, int end)
+    {
+        return json::Value::Object{{"start", ToPosition(text, start)}, {"end", ToPosition(text, end)}};
+    }
+
+
+    static std::optional<json::Value> ReadMessage()
+    {
+        std::size_t length = 0;
+        std::string header;
+        while (std::getline(std::cin, header))
+        {
+            if (!header.empty() && header.back() == '\r') header.pop_back();
+            if (header.empty()) break;
+
+            // A length that doesn't parse is left at 0, so the message is read as empty and ignored
+            if (header.starts_with("Content-Length:"))
+            {
+                std::string_view value = std::string_view(header).substr(15);
+                while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+
+                if (std::from_chars(value.data(), value.data() + value.size(), length).ptr != value.data() + value.size())
+                {
+                    length = 0;
+                }
+            }
+        }
+        if (!std::cin) return std::nullopt;
+
+        std::string content(length, '\0');
+        if (!std::cin.read(content.data(), length)) return std::nullopt;
+
+        if (auto message = json::Value::Parse(content)) return message;
+        return json::Value(); // Not JSON, so there is no id to reply to
+    }
+
+    static void SendMessage(json::Value::Object message)
+    {
+        message.insert(message.begin(), {"jsonrpc", "2.0"});
+        std::string content = json::Value(std::move(message)).dump();
+        std::cout << std::format("Content-Length: {}\r\n\r\n{}", content.size(), content) << std::flush;
+    }
+
+
+    // Lexes text with errors collected, or returns nothing if it doesn't lex
+    static std::optional<lexing::TokenStream> LexCollected(lexing::SourceBuffer& source)
+    {
+        std::vector<diagnostic::Diagnostic> diagnostics;
+        diagnostic::Diagnostics diag;
+        diag.setFileName(source.getPath().string());
+        diag.setText(source.getText());
+        diag.setCollected(&diagnostics);
+
+        try
+        {
+            lexing::Lexer lexer(source, diag);
+            return lexer.lex();
+        }
+        catch (const diagnostic::CompileError&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    // Finds declarations from the tokens alone, so it works on text that no longer parses. A name
+    // followed by ':' declares a variable, argument or field, the other kinds follow their keyword.
+    // Names are interned in the current compilation's identifier table and looked up by their ID
+    static void ScanDeclarations(const lexing::TokenStream& tokens, Declarations& declarations)
+    {
+        using lexing::TokenType;
+
+        auto typeAt = [&tokens](std::size_t index) {
+            return index < tokens.size() ? tokens.getTokenType(index) : TokenType::Error;
+        };
+
+        std::vector<std::pair<symbol::SymbolID, Declaration> > found;
+        auto add = [&](std::size_t index, int scopeStart) {
+            found.push_back({symbol::Intern(tokens.getText(index)), {&tokens.getSource(), static_cast<int>(tokens.getStart(index).position),
+                static_cast<int>(tokens.getEnd(index).position + 1), scopeStart}});
+        };
+
+        // Functions don't nest, so only one is open at a time
+        int functionStart = -1;
+        int functionDepth = -1; // Brace depth outside the body, or -1 until its '{' is found
+        bool expressionBody = false;
+        std::size_t firstLocal = 0;
+        int braceDepth = 0;
+
+        auto closeFunction = [&](int end) {
+            for (std::size_t i = firstLocal; i < found.size(); ++i)
+            {
+                found[i].second.scopeEnd = end;
+            }
+            functionStart = -1;
+        };
+
+        for (std::size_t i = 0; i < tokens.size(); ++i)
+        {
+            switch (tokens.getTokenType(i))
+            {
+                case TokenType::FuncKeyword:
+                    functionStart = tokens.getStart(i).position;
+                    functionDepth = -1;
+                    expressionBody = false;
+                    firstLocal = found.size();
+                    for (std::size_t j = i + 1; j < tokens.size() && tokens.getTokenType(j) != TokenType::LeftParen; ++j)
+                    {
+                        if (tokens.getTokenType(j) == TokenType::Asperand && typeAt(j + 1) == TokenType::Identifier)
+                        {
+                            add(j + 1, -1);
+                            firstLocal = found.size();
+                            break;
+                        }
+                    }
+                    break;
+
+                case TokenType::LeftBracket:
+                    if (functionStart != -1 && functionDepth == -1 && !expressionBody) functionDepth = braceDepth;
+                    ++braceDepth;
+                    break;
+
+                case TokenType::RightBracket:
+                    --braceDepth;
+                    if (functionStart != -1 && braceDepth == functionDepth) closeFunction(tokens.getEnd(i).position + 1);
+                    break;
+
+                case TokenType::Equals:
+                    if (functionStart != -1 && functionDepth == -1) expressionBody = true;
+                    break;
+
+                case TokenType::Semicolon:
+                    if (functionStart != -1 && functionDepth == -1) closeFunction(tokens.getEnd(i).position + 1); // Expression body or extern declaration
+                    break;
+
+                case TokenType::StructKeyword:
+                case TokenType::EnumKeyword:
+                case TokenType::NamespaceKeyword:
+                    if (typeAt(i + 1) != TokenType::Identifier || typeAt(i + 2) != TokenType::LeftBracket) break; // A use of a struct type
+                    add(i + 1, -1);
+
+                    if (tokens.getTokenType(i) == TokenType::EnumKeyword) // The fields too, up to and including the '}'
+                    {
+                        for (i += 3; i < tokens.size() && tokens.getTokenType(i) != TokenType::RightBracket; ++i)
+                        {
+                            if (tokens.getTokenType(i) == TokenType::Identifier && (typeAt(i - 1) == TokenType::LeftBracket || typeAt(i - 1) == TokenType::Comma))
+                            {
+                                add(i, -1);
+                            }
+                        }
+                    }
+                    break;
+
+                case TokenType::UsingKeyword:
+                    if (typeAt(i + 1) == TokenType::Identifier && typeAt(i + 2) == TokenType::Equals)
+                    {
+                        add(i + 1, -1);
+                    }
+                    break;
+
+                case TokenType::Identifier:
+                    if (typeAt(i + 1) == TokenType::Colon && i != 0 && tokens.getTokenType(i - 1) != TokenType::CaseKeyword && tokens.getTokenType(i - 1) != TokenType::DoubleColon)
+                    {
+                        add(i, functionStart);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        if (functionStart != -1)
+        {
+            closeFunction(tokens.getSource().getText().size());
+        }
+
+        for (auto& [name, declaration] : found)
+        {
+            declarations[name].push_back(declaration);
+        }
+    }
+
+
+    // Analyses the document's text from scratch, in a compilation of its own
+    static void Analyse(Document& document, std::string text, const std::vector<std::string>& searchPaths)
+    {
+        document.analysis.reset(); // The old AST must go before a new context is made current
+        document.analysis = std::make_unique<Analysis>();
+        Analysis& analysis = *document.analysis;
+        analysis.context.makeCurrent();
+
+        analysis.importManager.addSearchPath(document.path.has_parent_path() ? document.path.parent_path().string() : ".");
+        for (auto& searchPath : searchPaths)
+        {
+            analysis.importManager.addSearchPath(searchPath);
+        }
+
+        analysis.source = analysis.sourceManager.addBuffer(document.path, std::move(text));
+        analysis.diag.setErrorSender("viper");
+        analysis.diag.setFileName(document.path.string());
+        analysis.diag.setText(analysis.source->getText());
+        analysis.diag.setCollected(&analysis.diagnostics);
+
+        try
+        {
+            lexing::Lexer lexer(*analysis.source, analysis.diag);
+            analysis.tokens.emplace(lexer.lex());
+
+            analysis.parser.emplace(*analysis.tokens, analysis.diag, analysis.importManager, analysis.arena);
+            analysis.ast = analysis.parser->parse();
+        }
+        catch (const diagnostic::CompileError&)
+        {
+            return;
+        }
+        catch (const std::out_of_range&) // The tokens ran out mid-declaration
+        {
+            int end = analysis.source->getText().size();
+            analysis.diagnostics.push_back({document.path.string(), end, end, "unexpected end of file", true});
+            return;
+        }
+
+        // Each declaration is checked on its own, so one error doesn't hide those in the rest of the file
+        for (auto& node : analysis.ast)
+        {
+            try
+            {
+                node->typeCheck(nullptr, analysis.diag);
+            }
+            catch (const diagnostic::CompileError&)
+            {
+            }
+        }
+
+        for (auto& body : analysis.parser->getFunctionBodies())
+        {
+            if (!body.function) continue;
+            analysis.bodies.push_back({body.function, static_cast<int>(analysis.tokens->getStart(body.start).position),
+                static_cast<int>(analysis.tokens->getEnd(body.end - 1).position + 1)});
+        }
+
+        for (auto& path : analysis.importManager.getModulePaths())
+        {
+            if (lexing::SourceBuffer* module = analysis.sourceManager.open(path))
+            {
+                if (auto tokens = LexCollected(*module))
+                {
+                    ScanDeclarations(*tokens, analysis.importedDeclarations);
+                }
+            }
+        }
+    }
+
+    // Lexes, parses and type checks just the function body an edit was made in. Returns false
+    // if the edit wasn't inside one body or the new body doesn't parse on its own, so the
+    // document has to be analysed from scratch
+    static bool ReanalyseBody(Document& document, std::string text)
+    {
+        Analysis& analysis = *document.analysis;
+        if (analysis.incrementalEdits == MaxIncrementalEdits) return false;
+        analysis.context.makeCurrent();
+
+        std::string_view oldText = analysis.source->getText();
+        std::size_t prefix = std::mismatch(oldText.begin(), oldText.end(), text.begin(), text.end()).first - oldText.begin();
+        std::size_t suffix = 0;
+        while (suffix < oldText.size() - prefix && suffix < text.size() - prefix && oldText[oldText.size() - suffix - 1] == text[text.size() - suffix - 1])
+        {
+            ++suffix;
+        }
+        if (prefix == oldText.size() && prefix == text.size()) return true;
+
+        int editStart = prefix;
+        int editEnd = oldText.size() - suffix;
+        int delta = static_cast<int>(text.size()) - static_cast<int>(oldText.size());
+
+        // The '{' or '=' and the last character of the body must be untouched
+        auto body = std::find_if(analysis.bodies.begin(), analysis.bodies.end(), [editStart, editEnd](const Body& body) {
+            return body.start < editStart && editEnd < body.end;
+        });
+        if (body == analysis.bodies.end()) return false;
+
+        lexing::SourceBuffer* source = analysis.sourceManager.addBuffer(document.path, std::move(text));
+        std::vector<diagnostic::Diagnostic> diagnostics;
+        analysis.diag.setText(source->getText());
+        analysis.diag.setCollected(&diagnostics);
+
+        try
+        {
+            lexing::Lexer lexer(*source, analysis.diag, body->start, body->end + delta);
+            auto tokens = std::make_unique<lexing::TokenStream>(lexer.lex());
+            if (!analysis.parser->reparseFunctionBody(*tokens, *body->function)) return false;
+            analysis.bodyTokens[body->function] = std::move(tokens);
+        }
+        catch (const diagnostic::CompileError&)
+        {
+            return false;
+        }
+        catch (const std::out_of_range&)
+        {
+            return false;
+        }
+
+        try
+        {
+            body->function->typeCheck(nullptr, analysis.diag);
+        }
+        catch (const diagnostic::CompileError&)
+        {
+        }
+        analysis.diag.setCollected(&analysis.diagnostics);
+
+        // The old body's diagnostics are replaced, and those after it move with the text
+        std::string fileName = document.path.string();
+        std::erase_if(analysis.diagnostics, [&](const diagnostic::Diagnostic& diagnostic) {
+            return diagnostic.fileName == fileName && diagnostic.start >= body->start && diagnostic.start < body->end;
+        });
+        for (auto& diagnostic : analysis.diagnostics)
+        {
+            if (diagnostic.fileName == fileName && diagnostic.start >= body->end)
+            {
+                diagnostic.start += delta;
+                diagnostic.end += delta;
+            }
+        }
+        std::move(diagnostics.begin(), diagnostics.end(), std::back_inserter(analysis.diagnostics));
+
+        body->end += delta;
+        for (auto next = body + 1; next != analysis.bodies.end(); ++next)
+        {
+            next->start += delta;
+            next->end += delta;
+        }
+
+        analysis.source = source;
+        analysis.declarations.reset();
+        ++analysis.incrementalEdits;
+        return true;
+    }
+
+    static void PublishDiagnostics(const Document& document)
+    {
+        std::string_view text = document.analysis->source->getText();
+        std::string fileName = document.path.string();
+
+        json::Value::Array diagnostics;
+        for (auto& diagnostic : document.analysis->diagnostics)
+        {
+            // Errors in imported files are shown at the top of the file importing them
+            bool here = diagnostic.fileName == fileName;
+            diagnostics.push_back(json::Value::Object{
+                {"range", here ? ToRange(text, diagnostic.start, diagnostic.end) : ToRange(text, 0, 0)},
+                {"severity", diagnostic.error ? 1 : 2},
+                {"source", "viper"},
+                {"message", here ? diagnostic.message : std::format("{}: {}", diagnostic.fileName, diagnostic.message)}
+            });
+        }
+
+        SendMessage({
+            {"method", "textDocument/publishDiagnostics"},
+            {"params", json::Value::Object{{"uri", document.uri}, {"version", document.version}, {"diagnostics", std::move(diagnostics)}}}
+        });
+    }
+
+    static json::Value FindDefinition(Document& document, int offset)
+    {
+        Analysis& analysis = *document.analysis;
+        analysis.context.makeCurrent();
+
+        std::optional<lexing::TokenStream> tokens = LexCollected(*analysis.source);
+        if (!tokens) return nullptr;
+
+        if (!analysis.declarations)
+        {
+            analysis.declarations.emplace();
+            ScanDeclarations(*tokens, *analysis.declarations);
+        }
+
+        // The cursor may also be just after the name
+        std::optional<std::size_t> index;
+        for (std::size_t i = 0; i < tokens->size(); ++i)
+        {
+            if (static_cast<int>(tokens->getStart(i).position) > offset) break;
+            if (tokens->getTokenType(i) == lexing::TokenType::Identifier && offset <= static_cast<int>(tokens->getEnd(i).position + 1))
+            {
+                index = i;
+            }
+        }
+        if (!index) return nullptr;
+
+        symbol::SymbolID name = symbol::Find(tokens->getText(*index));
+        if (name == symbol::InvalidSymbol) return nullptr; // Never declared, or it would have been interned
+
+        // The nearest local declared before the cursor in the same function, then
+        // a declaration at the top level of the document, then one in an import
+        const Declaration* found = nullptr;
+        if (auto it = analysis.declarations->find(name); it != analysis.declarations->end())
+        {
+            for (auto& declaration : it->second)
+            {
+                if (declaration.scopeStart != -1 && declaration.scopeStart <= offset && offset < declaration.scopeEnd && declaration.start <= offset)
+                {
+                    found = &declaration;
+                }
+            }
+            if (!found)
+            {
+                auto global = std::find_if(it->second.begin(), it->second.end(), [](const Declaration& declaration) {
+                    return declaration.scopeStart == -1;
+                });
+                if (global != it->second.end()) found = &*global;
+            }
+        }
+        if (!found)
+        {
+            auto it = analysis.importedDeclarations.find(name);
+            if (it == analysis.importedDeclarations.end()) return nullptr;
+
+            auto global = std::find_if(it->second.begin(), it->second.end(), [](const Declaration& declaration) {
+                return declaration.scopeStart == -1;
+            });
+            if (global == it->second.end()) return nullptr;
+            found = &*global;
+        }
+
+        std::string uri = found->source == analysis.source ? document.uri : PathToUri(found->source->getPath());
+        return json::Value::Object{{"uri", std::move(uri)}, {"range", ToRange(found->source->getText(), found->start, found->end)}};
+    }
+
+
+    int Serve(const std::vector<std::string>& args)
+    {
+        std::vector<std::string> searchPaths;
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            if (args[i] == "-I" && i + 1 < args.size())
+                searchPaths.push_back(args[++i]);
+            else if (args[i].starts_with("-I"))
+                searchPaths.push_back(args[i].substr(2));
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<Document> > documents;
+        bool shutdown = false;
+
+        while (std::optional<json::Value> message = ReadMessage())
+        {
+            const json::Value& id = (*message)["id"];
+            const std::string& method = (*message)["method"].getString();
+            const json::Value& params = (*message)["params"];
+
+            auto respond = [&id](json::Value result) {
+                SendMessage({{"id", id}, {"result", std::move(result)}});
+            };
+
+            if (method == "initialize")
+            {
+                respond(json::Value::Object{
+                    {"capabilities", json::Value::Object{
+                        {"textDocumentSync", 1}, // The whole text is sent on every change
+                        {"definitionProvider", true}
+                    }},
+                    {"serverInfo", json::Value::Object{{"name", "viper"}}}
+                });
+            }
+            else if (method == "shutdown")
+            {
+                shutdown = true;
+                respond(nullptr);
+            }
+            else if (method == "exit")
+            {
+                return shutdown ? 0 : 1;
+            }
+            else if (method == "textDocument/didOpen")
+            {
+                const json::Value& textDocument = params["textDocument"];
+                auto document = std::make_unique<Document>();
+                document->uri = textDocument["uri"].getString();
+                document->path = UriToPath(document->uri);
+                document->version = textDocument["version"];
+
+                Analyse(*document, textDocument["text"].getString(), searchPaths);
+                PublishDiagnostics(*document);
+                documents[document->uri] = std::move(document);
+            }
+            else if (method == "textDocument/didChange")
+            {
+                auto it = documents.find(params["textDocument"]["uri"].getString());
+                const json::Value::Array& changes = params["contentChanges"].getArray();
+                if (it == documents.end() || changes.empty()) continue;
+
+                Document& document = *it->second;
+                document.version = params["textDocument"]["version"];
+
+                std::string text = changes.back()["text"].getString();
+                if (!ReanalyseBody(document, text))
+                {
+                    Analyse(document, std::move(text), searchPaths);
+                }
+                PublishDiagnostics(document);
+            }
+            else if (method == "textDocument/didClose")
+            {
+                std::string uri = params["textDocument"]["uri"].getString();
+                documents.erase(uri);
+                SendMessage({
+                    {"method", "textDocument/publishDiagnostics"},
+                    {"params", json::Value::Object{{"uri", std::move(uri)}, {"diagnostics", json::Value::Array()}}}
+                });
+            }
+            else if (method == "textDocument/definition")
+            {
+                auto it = documents.find(params["textDocument"]["uri"].getString());
+                if (it == documents.end())
+                {
+                    respond(nullptr);
+                    continue;
+                }
+
+                Document& document = *it->second;
+                respond(FindDefinition(document, ToOffset(document.analysis->source->getText(), params["position"])));
+            }
+            else if (!id.isNull() || method.empty())
+            {
+                SendMessage({{"id", id}, {"error", json::Value::Object{
+                    {"code", method.empty() ? -32600 : -32601},
+                    {"message", method.empty() ? "invalid request" : std::format("unknown method '{}'", method)}
+                }}});
+            }
+        }
+
+        return 1; // The client went away without asking to exit
+    }
+}
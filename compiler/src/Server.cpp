@@ -0,0 +1,664 @@
+// Copyright 2024 solar-mist
+
+
+#include "Server.h"
+#include "Driver.h"
+
+#include "lexer/SourceManager.h"
+
+#include "symbol/ModuleCache.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include "support/BuildId.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace server
+{
+    // On accepting a connection the server sends a u32 length and its support::BuildId, and the
+    // client only makes a request if that is its own. A request is a u32 payload size followed by
+    // the payload: a u32 string count, then the working directory and each argument as a u32 length
+    // and its bytes. The client's standard output and standard error are passed along with the
+    // first bytes. The reply is the i32 exit status of the compilation.
+    //
+    // A child reports the modules it parsed to the server over a pipe, as a u64 source hash,
+    // u32 size and the interface for each module.
+
+    static volatile std::sig_atomic_t stopRequested = 0;
+
+    static bool WriteAll(int fd, const void* data, std::size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while (size != 0)
+        {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            bytes += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    static bool ReadAll(int fd, void* data, std::size_t size)
+    {
+        char* bytes = static_cast<char*>(data);
+        while (size != 0)
+        {
+            ssize_t count = read(fd, bytes, size);
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) return false;
+            bytes += count;
+            size -= count;
+        }
+        return true;
+    }
+
+    static void AppendU32(std::string& buffer, std::uint32_t value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static std::uint32_t ReadU32(std::string_view data, std::size_t& position)
+    {
+        std::uint32_t value = 0;
+        if (data.size() - position >= sizeof(value))
+        {
+            std::memcpy(&value, data.data() + position, sizeof(value));
+        }
+        position += sizeof(value);
+        return value;
+    }
+
+    static bool MakeAddress(const std::filesystem::path& socketPath, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+
+        std::string path = socketPath.string();
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    // Anyone who can reach a socket could otherwise be sent a client's output, or report its build as successful
+    static bool PeerIsThisUser(int fd)
+    {
+        ucred credentials;
+        socklen_t size = sizeof(credentials);
+        return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0 && credentials.uid == getuid();
+    }
+
+    // A server this user started made the socket with no access for anyone else. Another user
+    // can create one at a predictable path first, but can't make it this user's
+    static bool IsPrivateSocket(const std::filesystem::path& socketPath)
+    {
+        struct stat status;
+        return lstat(socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode) && status.st_uid == getuid() && (status.st_mode & 0777) == 0700;
+    }
+
+    static int Connect(const std::filesystem::path& socketPath)
+    {
+        sockaddr_un address;
+        if (!MakeAddress(socketPath, address))
+        {
+            return -1;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    std::filesystem::path GetSocketPath()
+    {
+        if (const char* path = std::getenv("VIPER_SERVER_SOCKET"))
+        {
+            return path;
+        }
+        if (const char* runtimeDirectory = std::getenv("XDG_RUNTIME_DIR"))
+        {
+            return std::filesystem::path(runtimeDirectory) / "viper.sock";
+        }
+        return std::format("/tmp/viper-{}.sock", getuid());
+    }
+
+
+    std::optional<int> CompileOnServer(const std::filesystem::path& socketPath, const std::vector<std::string>& args)
+    {
+        if (!IsPrivateSocket(socketPath))
+        {
+            return std::nullopt;
+        }
+
+        int fd = Connect(socketPath);
+        if (fd < 0)
+        {
+            return std::nullopt;
+        }
+        if (!PeerIsThisUser(fd))
+        {
+            close(fd);
+            return std::nullopt;
+        }
+
+        // A server started before the compiler was rebuilt would compile with the old build
+        const std::string& buildId = support::BuildId();
+        std::uint32_t serverBuildIdLength;
+        std::string serverBuildId(buildId.size(), '\0');
+        if (!ReadAll(fd, &serverBuildIdLength, sizeof(serverBuildIdLength)) || serverBuildIdLength != buildId.size()
+            || !ReadAll(fd, serverBuildId.data(), serverBuildId.size()) || serverBuildId != buildId)
+        {
+            close(fd);
+            return std::nullopt;
+        }
+
+        std::error_code ec;
+        std::string workingDirectory = std::filesystem::current_path(ec).string();
+        if (ec)
+        {
+            close(fd);
+            return std::nullopt;
+        }
+
+        std::string payload;
+        AppendU32(payload, args.size() + 1);
+        AppendU32(payload, workingDirectory.size());
+        payload += workingDirectory;
+        for (auto& arg : args)
+        {
+            AppendU32(payload, arg.size());
+            payload += arg;
+        }
+
+        std::string message;
+        AppendU32(message, payload.size());
+        message += payload;
+
+        int fds[2] = { STDOUT_FILENO, STDERR_FILENO };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+
+        iovec iov{ message.data(), message.size() };
+        msghdr header{};
+        header.msg_iov = &iov;
+        header.msg_iovlen = 1;
+        header.msg_control = control;
+        header.msg_controllen = sizeof(control);
+
+        cmsghdr* fdMessage = CMSG_FIRSTHDR(&header);
+        fdMessage->cmsg_level = SOL_SOCKET;
+        fdMessage->cmsg_type = SCM_RIGHTS;
+        fdMessage->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(fdMessage), fds, sizeof(fds));
+
+        ssize_t sent = sendmsg(fd, &header, MSG_NOSIGNAL);
+        if (sent <= 0 || !WriteAll(fd, message.data() + sent, message.size() - sent))
+        {
+            close(fd);
+            return std::nullopt;
+        }
+
+        std::int32_t status;
+        bool replied = ReadAll(fd, &status, sizeof(status));
+        close(fd);
+
+        if (!replied)
+        {
+            diagnostic::Diagnostics diag;
+            diag.setErrorSender("viper");
+            diag.fatalError("lost connection to the compile server");
+        }
+        return status;
+    }
+
+
+    namespace
+    {
+        struct Request
+        {
+            std::string workingDirectory;
+            std::vector<std::string> args;
+            int stdoutFd;
+            int stderrFd;
+        };
+
+        struct Child
+        {
+            int clientFd;
+            int interfaceFd;
+            std::string interfaces;
+        };
+
+        // A connection whose request hasn't all arrived yet. Its socket never blocks, so a client
+        // that stalls or sends too little only loses its own request
+        struct Connection
+        {
+            std::string data;
+            int stdoutFd;
+            int stderrFd;
+            std::chrono::steady_clock::time_point deadline;
+        };
+
+        constexpr std::chrono::seconds RequestTimeout{ 10 };
+        constexpr std::uint32_t MaxRequestSize = 16 * 1024 * 1024;
+
+        void CloseConnection(int fd, Connection& connection)
+        {
+            if (connection.stdoutFd >= 0) close(connection.stdoutFd);
+            if (connection.stderrFd >= 0) close(connection.stderrFd);
+            close(fd);
+        }
+
+        enum class ReadStatus
+        {
+            Incomplete,
+            Complete,
+            Failed,
+        };
+
+        // Reads what has arrived on fd without waiting for the rest
+        ReadStatus ReadRequest(int fd, Connection& connection)
+        {
+            while (true)
+            {
+                char buffer[4096];
+                alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)] = {};
+
+                iovec iov{ buffer, sizeof(buffer) };
+                msghdr header{};
+                header.msg_iov = &iov;
+                header.msg_iovlen = 1;
+                header.msg_control = control;
+                header.msg_controllen = sizeof(control);
+
+                ssize_t received = recvmsg(fd, &header, MSG_CMSG_CLOEXEC);
+                if (received < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return errno == EAGAIN || errno == EWOULDBLOCK ? ReadStatus::Incomplete : ReadStatus::Failed;
+                }
+
+                for (cmsghdr* fdMessage = CMSG_FIRSTHDR(&header); fdMessage; fdMessage = CMSG_NXTHDR(&header, fdMessage))
+                {
+                    if (fdMessage->cmsg_level != SOL_SOCKET || fdMessage->cmsg_type != SCM_RIGHTS) continue;
+
+                    std::vector<int> fds((fdMessage->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+                    std::memcpy(fds.data(), CMSG_DATA(fdMessage), fds.size() * sizeof(int));
+                    if (fds.size() == 2 && connection.stdoutFd < 0)
+                    {
+                        connection.stdoutFd = fds[0];
+                        connection.stderrFd = fds[1];
+                        continue;
+                    }
+                    for (int unexpected : fds)
+                    {
+                        close(unexpected);
+                    }
+                }
+
+                // The output descriptors come with the first bytes, and the client waits for the reply once it has sent the rest
+                if (received == 0 || (header.msg_flags & MSG_CTRUNC) || connection.stdoutFd < 0)
+                {
+                    return ReadStatus::Failed;
+                }
+                connection.data.append(buffer, received);
+
+                std::size_t position = 0;
+                std::uint32_t size = ReadU32(connection.data, position);
+                if (connection.data.size() < sizeof(size)) continue;
+                if (size > MaxRequestSize || connection.data.size() > sizeof(size) + size) return ReadStatus::Failed;
+                if (connection.data.size() == sizeof(size) + size) return ReadStatus::Complete;
+            }
+        }
+
+        // Takes the output descriptors from connection, which must have its whole request
+        std::optional<Request> ParseRequest(Connection& connection)
+        {
+            Request request{ {}, {}, connection.stdoutFd, connection.stderrFd };
+            connection.stdoutFd = -1;
+            connection.stderrFd = -1;
+
+            auto fail = [&request]() -> std::optional<Request> {
+                close(request.stdoutFd);
+                close(request.stderrFd);
+                return std::nullopt;
+            };
+
+            std::string_view payload = std::string_view(connection.data).substr(sizeof(std::uint32_t));
+            std::size_t position = 0;
+            std::uint32_t count = ReadU32(payload, position);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                std::uint32_t length = ReadU32(payload, position);
+                if (position > payload.size() || payload.size() - position < length)
+                {
+                    return fail();
+                }
+
+                std::string value(payload.substr(position, length));
+                position += length;
+
+                if (i == 0) request.workingDirectory = std::move(value);
+                else request.args.push_back(std::move(value));
+            }
+            if (count == 0)
+            {
+                return fail();
+            }
+
+            return request;
+        }
+
+        // Runs in the child process, so a fatal error in the compilation only ends the child
+        [[noreturn]] void RunRequest(const Request& request, int interfaceFd, lexing::SourceManager& sourceManager, symbol::ModuleCache& moduleCache)
+        {
+            dup2(request.stdoutFd, STDOUT_FILENO);
+            dup2(request.stderrFd, STDERR_FILENO);
+            close(request.stdoutFd);
+            close(request.stderrFd);
+
+            diagnostic::Diagnostics diag;
+            diag.setErrorSender("viper");
+
+            std::error_code ec;
+            std::filesystem::current_path(request.workingDirectory, ec);
+            if (ec)
+            {
+                diag.fatalError(std::format("{}: {}", request.workingDirectory, ec.message()));
+            }
+
+            std::size_t knownInterfaces = moduleCache.size();
+            int status = driver::Compile(request.args, sourceManager, moduleCache);
+
+            std::string interfaces;
+            for (auto& [sourceHash, interface] : moduleCache.getInterfacesSince(knownInterfaces))
+            {
+                interfaces.append(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+                AppendU32(interfaces, interface->size());
+                interfaces += *interface;
+            }
+            WriteAll(interfaceFd, interfaces.data(), interfaces.size());
+
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(status);
+        }
+
+        void AddInterfaces(std::string_view data, symbol::ModuleCache& moduleCache)
+        {
+            std::size_t position = 0;
+            while (data.size() - position >= sizeof(std::uint64_t) + sizeof(std::uint32_t))
+            {
+                std::uint64_t sourceHash;
+                std::memcpy(&sourceHash, data.data() + position, sizeof(sourceHash));
+                position += sizeof(sourceHash);
+
+                std::uint32_t size = ReadU32(data, position);
+                if (data.size() - position < size)
+                {
+                    return;
+                }
+
+                moduleCache.insert(sourceHash, std::string(data.substr(position, size)));
+                position += size;
+            }
+        }
+    }
+
+    int Serve(const std::filesystem::path& socketPath)
+    {
+        diagnostic::Diagnostics diag;
+        diag.setErrorSender("viper");
+
+        sockaddr_un address;
+        if (!MakeAddress(socketPath, address))
+        {
+            diag.fatalError(std::format("{}: socket path is too long", socketPath.string()));
+        }
+
+        if (int existing = Connect(socketPath); existing >= 0)
+        {
+            close(existing);
+            diag.fatalError(std::format("a compile server is already listening on {}", socketPath.string()));
+        }
+        unlink(socketPath.c_str()); // Left behind by a server that didn't shut down cleanly
+
+        int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listener < 0)
+        {
+            diag.fatalError(std::format("could not create socket: {}", std::strerror(errno)));
+        }
+
+        mode_t oldMask = umask(0077); // Only this user may submit compilations
+        int bound = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        umask(oldMask);
+        if (bound < 0 || listen(listener, SOMAXCONN) < 0)
+        {
+            diag.fatalError(std::format("{}: {}", socketPath.string(), std::strerror(errno)));
+        }
+
+        struct sigaction action{};
+        action.sa_handler = [](int) { stopRequested = 1; };
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        // The server never compiles anything itself and stays single-threaded, so forking it is safe
+        lexing::SourceManager sourceManager;
+        symbol::ModuleCache moduleCache;
+        std::unordered_map<pid_t, Child> children;
+        std::unordered_map<int, Connection> connections;
+
+        // Compiles request in a child, which the server replies to clientFd for once it exits
+        auto startRequest = [&](int clientFd, Request& request) {
+            int interfacePipe[2];
+            if (pipe2(interfacePipe, O_CLOEXEC) < 0)
+            {
+                close(request.stdoutFd);
+                close(request.stderrFd);
+                close(clientFd);
+                return;
+            }
+
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                close(listener);
+                close(clientFd);
+                close(interfacePipe[0]);
+                for (auto& [otherPid, child] : children)
+                {
+                    close(child.clientFd);
+                    close(child.interfaceFd);
+                }
+                for (auto& [fd, connection] : connections)
+                {
+                    CloseConnection(fd, connection);
+                }
+                RunRequest(request, interfacePipe[1], sourceManager, moduleCache);
+            }
+
+            close(request.stdoutFd);
+            close(request.stderrFd);
+            close(interfacePipe[1]);
+
+            if (pid < 0)
+            {
+                std::int32_t exitStatus = EXIT_FAILURE;
+                WriteAll(clientFd, &exitStatus, sizeof(exitStatus));
+                close(clientFd);
+                close(interfacePipe[0]);
+                return;
+            }
+
+            children[pid] = Child{ clientFd, interfacePipe[0], {} };
+        };
+
+        while (!stopRequested)
+        {
+            std::vector<pollfd> pollFds{ { listener, POLLIN, 0 } };
+            std::vector<pid_t> pollChildren;
+            for (auto& [pid, child] : children)
+            {
+                pollFds.push_back({ child.interfaceFd, POLLIN, 0 });
+                pollChildren.push_back(pid);
+            }
+
+            // Wakes up in time to drop the first connection that runs out of time
+            std::size_t firstConnection = pollFds.size();
+            int timeout = -1;
+            auto now = std::chrono::steady_clock::now();
+            for (auto& [fd, connection] : connections)
+            {
+                pollFds.push_back({ fd, POLLIN, 0 });
+
+                auto remaining = std::chrono::ceil<std::chrono::milliseconds>(connection.deadline - now).count();
+                int wait = static_cast<int>(std::max<decltype(remaining)>(remaining, 0));
+                if (timeout < 0 || wait < timeout) timeout = wait;
+            }
+
+            if (poll(pollFds.data(), pollFds.size(), timeout) < 0)
+            {
+                if (errno == EINTR) continue;
+                diag.fatalError(std::format("poll failed: {}", std::strerror(errno)));
+            }
+
+            for (std::size_t i = 1; i < firstConnection; ++i)
+            {
+                if (!pollFds[i].revents) continue;
+
+                pid_t pid = pollChildren[i - 1];
+                Child& child = children[pid];
+
+                char buffer[65536];
+                ssize_t count = read(child.interfaceFd, buffer, sizeof(buffer));
+                if (count < 0 && errno == EINTR) continue;
+                if (count > 0)
+                {
+                    child.interfaces.append(buffer, count);
+                    continue;
+                }
+
+                // The child closes its end of the pipe by exiting
+                int status;
+                while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+                std::int32_t exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+
+                AddInterfaces(child.interfaces, moduleCache);
+                WriteAll(child.clientFd, &exitStatus, sizeof(exitStatus));
+
+                close(child.clientFd);
+                close(child.interfaceFd);
+                children.erase(pid);
+            }
+
+            now = std::chrono::steady_clock::now();
+            for (std::size_t i = firstConnection; i < pollFds.size(); ++i)
+            {
+                int fd = pollFds[i].fd;
+                Connection& connection = connections.at(fd);
+
+                ReadStatus status = pollFds[i].revents ? ReadRequest(fd, connection) : ReadStatus::Incomplete;
+                if (status == ReadStatus::Incomplete && now < connection.deadline)
+                {
+                    continue;
+                }
+
+                std::optional<Request> request;
+                if (status == ReadStatus::Complete)
+                {
+                    request = ParseRequest(connection);
+                }
+
+                if (request)
+                {
+                    startRequest(fd, *request);
+                }
+                else
+                {
+                    CloseConnection(fd, connection);
+                }
+                connections.erase(fd);
+            }
+
+            if (!(pollFds[0].revents & POLLIN))
+            {
+                continue;
+            }
+
+            int clientFd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (clientFd < 0)
+            {
+                continue;
+            }
+
+            std::string greeting;
+            AppendU32(greeting, support::BuildId().size());
+            greeting += support::BuildId();
+            if (!PeerIsThisUser(clientFd) || !WriteAll(clientFd, greeting.data(), greeting.size()))
+            {
+                close(clientFd);
+                continue;
+            }
+
+            connections[clientFd] = Connection{ {}, -1, -1, std::chrono::steady_clock::now() + RequestTimeout };
+        }
+
+        close(listener);
+        unlink(socketPath.c_str());
+
+        for (auto& [fd, connection] : connections)
+        {
+            CloseConnection(fd, connection);
+        }
+
+        // Compilations still running are finished, but what they parse is no longer needed
+        for (auto& [pid, child] : children)
+        {
+            close(child.interfaceFd);
+
+            int status;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+            std::int32_t exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+
+            WriteAll(child.clientFd, &exitStatus, sizeof(exitStatus));
+            close(child.clientFd);
+        }
+
+        return EXIT_SUCCESS;
+    }
+}
@@ -1,140 +1,41 @@
 // Copyright 2024 solar-mist
 
 
-#include "lexer/Lexer.h"
-#include "lexer/Token.h"
+#include "Driver.h"
+#include "LanguageServer.h"
+#include "Server.h"
 
-#include "parser/Parser.h"
+#include "lexer/SourceManager.h"
 
-#include "type/Type.h"
+#include "symbol/ModuleCache.h"
 
-#include "diagnostic/Diagnostic.h"
-
-#include "symbol/Import.h"
-
-#include <vipir/IR/IRBuilder.h>
-#include <vipir/Module.h>
-#include <vipir/ABI/SysV.h>
-
-#include <filesystem>
-#include <fstream>
-#include <iostream>
-#include <sstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
 
 int main(int argc, char** argv)
 {
-    diagnostic::Diagnostics diag;
-    diag.setErrorSender("viper");
-
-    std::string inputFilePath;
-    std::string outputFilePath;
-    bool outputIR = false;
-    bool optimize = false;
-
-    symbol::ImportManager importManager;
-
-    for (int i = 1; i < argc; ++i)
-    {
-        std::string arg = argv[i];
-        if (arg.starts_with('-'))
-        {
-            switch(arg[1])
-            {
-                case 'I':
-                    if (arg.length() == 2)
-                    {
-                        importManager.addSearchPath(argv[++i]);
-                    }
-                    else
-                    {
-                        importManager.addSearchPath(arg.substr(2));
-                    }
-                    break;
-
-                case 'i':
-                    outputIR = true;
-                    break;
-
-                case 'o':
-                    if (arg.length() == 2)
-                        outputFilePath = argv[++i];
-                    else
-                        outputFilePath = arg.substr(2);
-                    break;
-
-                case 'O':
-                    optimize = true;
-                    break;
-
-                default:
-                    diag.fatalError(std::format("Unrecognized command-line option: {}", arg));
-            }
-        }
-        else
-        {
-            inputFilePath = arg;
-        }
-    }
-
-    if (inputFilePath.empty())
-    {
-        diag.fatalError("no input files");
-    }
-    if (!std::filesystem::exists(inputFilePath))
-    {
-        diag.fatalError(std::format("{}: no such file or directory", inputFilePath));
-    }
-    diag.setFileName(inputFilePath);
+    std::vector<std::string> args(argv + 1, argv + argc);
 
-    if (outputFilePath.empty())
+    if (!args.empty() && args[0] == "--lsp")
     {
-        outputFilePath = inputFilePath + (outputIR ? ".i" : ".o");
+        return lsp::Serve(std::vector<std::string>(args.begin() + 1, args.end()));
     }
 
-    std::ifstream file = std::ifstream(inputFilePath);
-
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-
-    Type::Init();
-
-    diag.setText(buffer.str());
-    lexing::Lexer lexer(buffer.str(), diag);
-
-    std::vector<lexing::Token> tokens = lexer.lex();
-
-    parser::Parser parser(tokens, diag, importManager);
-    
-    vipir::IRBuilder builder;
-    vipir::Module module(inputFilePath);
-    module.setABI<vipir::abi::SysV>();
-
-    auto ast = parser.parse();
-
-    for (auto& node : ast)
-    {
-        node->typeCheck(nullptr, diag);
-    }
-    
-    for (auto& node : ast)
+    if (args.size() == 1 && args[0] == "--server")
     {
-        node->emit(builder, module, nullptr, diag);
+        return server::Serve(server::GetSocketPath());
     }
 
-    if (optimize)
-    {
-        module.addPass(vipir::Pass::PeepholeOptimization);
-    }
-    
-    std::ofstream outputFile = std::ofstream(outputFilePath);
-    if (outputIR)
+    if (!std::getenv("VIPER_NO_SERVER"))
     {
-        module.print(outputFile);
-    }
-    else
-    {
-        module.emit(outputFile, vipir::OutputFormat::ELF);
+        if (auto status = server::CompileOnServer(server::GetSocketPath(), args))
+        {
+            return *status;
+        }
     }
 
-    return 0;
-}
\ No newline at end of file
+    lexing::SourceManager sourceManager;
+    symbol::ModuleCache moduleCache;
+    return driver::Compile(args, sourceManager, moduleCache);
+}
@@ -3,7 +3,10 @@
 #ifndef VIPER_FRAMEWORK_DIAGNOSTIC_DIAGNOSTIC_H
 #define VIPER_FRAMEWORK_DIAGNOSTIC_DIAGNOSTIC_H 1
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace lexing
 {
@@ -20,13 +23,39 @@ namespace fmt
 
 namespace diagnostic
 {
+    // An error or warning kept for a client such as an editor instead of being printed, without the terminal formatting
+    struct Diagnostic
+    {
+        std::string fileName;
+        int start; // Positions in the file's text, end is one past the last character
+        int end;
+        std::string message;
+        bool error;
+    };
+
+    // Thrown by errors while diagnostics are being collected, so the caller can carry on with the rest of its work
+    class CompileError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
     class Diagnostics
     {
     public:
         void setImported(bool imported);
         void setFileName(std::string fileName);
         void setErrorSender(std::string sender);
-        void setText(std::string text);
+        void setText(std::string_view text);
+
+        // Appends errors and warnings to collected instead of printing them. Errors then throw CompileError instead of exiting
+        void setCollected(std::vector<Diagnostic>* collected);
+        std::vector<Diagnostic>* getCollected() const;
+
+        // Errors are still printed, but throw CompileError instead of exiting, so a compilation running
+        // alongside others can stop without taking the process down from its thread
+        void setExitOnError(bool exitOnError);
+        bool getExitOnError() const;
 
         [[noreturn]] void fatalError(std::string_view message);
 
@@ -36,10 +65,13 @@ namespace diagnostic
     private:
         std::string mFileName;
         std::string mSender;
-        std::string mText;
+        std::string_view mText;
         bool mImported{ false };
+        std::vector<Diagnostic>* mCollected{ nullptr };
+        bool mExitOnError{ true };
 
         int getLinePosition(int lineNumber);
+        [[noreturn]] void exitOrThrow(std::string_view message);
     };
 }
 
@@ -3,37 +3,36 @@
 #ifndef VIPER_FRAMEWORK_LEXER_LEXER_H
 #define VIPER_FRAMEWORK_LEXER_LEXER_H
 
+#include "lexer/SourceManager.h"
+#include "lexer/TokenStream.h"
+
 #include "diagnostic/Diagnostic.h"
 
-#include <optional>
-#include <string>
-#include <vector>
+#include <string_view>
 
 namespace lexing
 {
-    class Token;
-    class SourceLocation;
-
     class Lexer
     {
     public:
-        Lexer(const std::string& text, diagnostic::Diagnostics& diag);
+        Lexer(SourceBuffer& source, diagnostic::Diagnostics& diag);
+        Lexer(SourceBuffer& source, diagnostic::Diagnostics& diag, int start, int end); // Only the text in [start, end)
 
-        std::vector<Token> lex();
+        TokenStream lex();
     private:
-        std::string mText;
+        SourceBuffer& mSource;
+        std::string_view mText;
         diagnostic::Diagnostics& mDiag;
         int mPosition{ 0 };
-        int mColumn{ 1 };
-        int mLine{ 1 };
 
         char current();
         char consume();
         char peek(int offset);
 
-        SourceLocation location();
+        SourceLocation location(int position);
+        std::string_view textFrom(int start);
 
-        std::optional<Token> nextToken();
+        void nextToken(TokenStream& tokens);
 
         static inline bool isDigitSep(const char c) { return c == '_'; }
     };
@@ -0,0 +1,79 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_LEXER_SOURCE_MANAGER_H
+#define VIPER_FRAMEWORK_LEXER_SOURCE_MANAGER_H 1
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lexing
+{
+    struct SourceLocation
+    {
+        int column;
+        int line;
+
+        int position; // actual position into the text
+    };
+
+    // Owns the text of one source file. Files are memory-mapped read-only, and tokens
+    // refer to slices of the mapping instead of owning their text
+    class SourceBuffer
+    {
+    public:
+        SourceBuffer(std::filesystem::path path, std::string text);
+        SourceBuffer(std::filesystem::path path, const char* data, std::size_t size);
+        ~SourceBuffer();
+
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+        const std::filesystem::path& getPath() const;
+        std::string_view getText() const;
+
+        // Stores text that doesn't appear verbatim in the source, e.g. string literals with escape sequences.
+        // Safe to call from several threads lexing the same file
+        std::string_view addText(std::string text);
+
+        // Line and column are only needed for diagnostics, so the line table is built on first use
+        SourceLocation getLocation(std::uint32_t position) const;
+
+    private:
+        std::filesystem::path mPath;
+
+        const char* mData;
+        std::size_t mSize;
+        bool mMapped;
+
+        std::string mOwnedText;
+        std::mutex mAddedTextMutex;
+        std::deque<std::string> mAddedText;
+
+        mutable std::once_flag mLineTableBuilt;
+        mutable std::vector<std::uint32_t> mNewlines;
+    };
+
+    // Can be shared by compilations running on several threads, each file is then mapped once
+    class SourceManager
+    {
+    public:
+        // Maps a file the first time it is requested. Returns nullptr if it cannot be opened
+        SourceBuffer* open(const std::filesystem::path& path);
+
+        SourceBuffer* addBuffer(std::filesystem::path path, std::string text);
+
+    private:
+        std::mutex mMutex;
+        std::unordered_map<std::string, std::unique_ptr<SourceBuffer> > mFiles;
+        std::deque<std::unique_ptr<SourceBuffer> > mBuffers;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_LEXER_SOURCE_MANAGER_H
\ No newline at end of file
@@ -3,11 +3,15 @@
 #ifndef VIPER_FRAMEWORK_LEXER_TOKEN_H
 #define VIPER_FRAMEWORK_LEXER_TOKEN_H
 
+#include "lexer/SourceManager.h"
+
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace lexing
 {
-    enum class TokenType : int
+    enum class TokenType : std::uint8_t
     {
         Error,
 
@@ -57,27 +61,23 @@ namespace lexing
         EnumKeyword,
     };
 
-    struct SourceLocation
-    {
-        int column;
-        int line;
-
-        int position; // actual position into the text
-    };
+    class TokenStream;
 
+    // Lightweight handle to a token in a TokenStream. The text and location are
+    // looked up in the stream on demand, so tokens are cheap to copy
     class Token
     {
     public:
         Token() = default;
-        Token(const TokenType tokenType, std::string text, SourceLocation start, SourceLocation end);
-        Token(const TokenType tokenType, SourceLocation start, SourceLocation end);
+        Token(const TokenStream* stream, std::uint32_t index);
+        Token(const TokenType tokenType); // A token that doesn't appear in the source
 
         TokenType getTokenType() const;
         std::string getId() const;
-        const std::string& getText() const;
+        std::string_view getText() const;
 
-        SourceLocation getStart();
-        SourceLocation getEnd();
+        SourceLocation getStart() const;
+        SourceLocation getEnd() const;
 
         std::string toString() const;
 
@@ -86,10 +86,8 @@ namespace lexing
     private:
         TokenType mTokenType{ TokenType::Error };
 
-        std::string mText;
-
-        SourceLocation mStart;
-        SourceLocation mEnd;
+        const TokenStream* mStream{ nullptr };
+        std::uint32_t mIndex{ 0 };
     };
 }
 
@@ -0,0 +1,49 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_LEXER_TOKEN_STREAM_H
+#define VIPER_FRAMEWORK_LEXER_TOKEN_STREAM_H 1
+
+#include "lexer/Token.h"
+#include "lexer/SourceManager.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lexing
+{
+    // Packed storage for the tokens of one source buffer. Each token is a kind and
+    // the offsets of its first and last character. The text is sliced from the
+    // buffer and line/column information is only computed when asked for
+    class TokenStream
+    {
+    public:
+        TokenStream(const SourceBuffer& source);
+
+        void add(TokenType tokenType, std::uint32_t start, std::uint32_t end);
+        void add(TokenType tokenType, std::uint32_t start, std::uint32_t end, std::string_view text);
+
+        std::size_t size() const;
+        Token at(std::size_t index) const;
+
+        TokenType getTokenType(std::size_t index) const;
+        std::string_view getText(std::size_t index) const;
+        SourceLocation getStart(std::size_t index) const;
+        SourceLocation getEnd(std::size_t index) const;
+
+        const SourceBuffer& getSource() const;
+
+    private:
+        const SourceBuffer& mSource;
+
+        std::vector<TokenType> mTokenTypes;
+        std::vector<std::uint32_t> mStarts;
+        std::vector<std::uint32_t> mEnds;
+
+        // Text for the few tokens whose value isn't their slice of the source
+        std::unordered_map<std::uint32_t, std::string_view> mText;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_LEXER_TOKEN_STREAM_H
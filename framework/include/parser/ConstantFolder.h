@@ -0,0 +1,55 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_PARSER_CONSTANT_FOLDER_H
+#define VIPER_FRAMEWORK_PARSER_CONSTANT_FOLDER_H 1
+
+#include "parser/ast/Node.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include "support/Arena.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace parser
+{
+    struct ConstexprValue;
+
+    // Replaces constant subtrees of a type checked AST with literals before it is emitted
+    class ConstantFolder
+    {
+    public:
+        ConstantFolder(support::Arena& arena, diagnostic::Diagnostics& diag);
+
+        diagnostic::Diagnostics& getDiagnostics();
+
+        // Folds node's children, then replaces node itself if it turned out constant
+        void fold(ASTNodePtr& node, Scope* scope);
+
+        ASTNodePtr makeInteger(intmax_t value, Type* type, lexing::Token token);
+        ASTNodePtr makeBoolean(bool value, lexing::Token token);
+
+        // Builds the literal or initializer a value computed by the interpreter would have been written as, or nullptr if there isn't one
+        ASTNodePtr materialize(const ConstexprValue& value, lexing::Token token);
+
+        // Values of constexpr locals, which are only folded once their declaration is
+        void addLocal(Scope* scope, const std::string& name, intmax_t value);
+        std::optional<intmax_t> findLocal(Scope* scope, const std::string& name);
+
+        // Truncates value to the width of an integer type, then sign or zero extends it back
+        static intmax_t Wrap(intmax_t value, Type* type);
+        static intmax_t MinValue(Type* type); // Of a signed type, as Wrap would extend it
+        static bool IsSigned(Type* type);
+
+    private:
+        support::Arena& mArena;
+        diagnostic::Diagnostics& mDiag;
+
+        std::unordered_map<Scope*, std::unordered_map<std::string, intmax_t> > mLocals;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_PARSER_CONSTANT_FOLDER_H
@@ -0,0 +1,71 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_PARSER_DECLARATION_INDEX_H
+#define VIPER_FRAMEWORK_PARSER_DECLARATION_INDEX_H 1
+
+#include "parser/ast/global/Function.h"
+#include "parser/ast/global/StructDeclaration.h"
+
+#include "type/StructType.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parser
+{
+    struct FunctionSignature
+    {
+        bool priv;
+        std::string name;
+        Type* type;
+        std::vector<FunctionArgument> arguments;
+        int bodyPosition; // The '{', '=' or ';' following the signature
+        std::vector<GlobalAttribute> attributes{}; // Only kept for methods, functions are given theirs when parsed
+    };
+
+    struct StructSignature
+    {
+        StructType* type;
+        std::vector<StructField> fields;
+        std::vector<FunctionSignature> methods;
+        int endPosition;
+    };
+
+    // Global variables and global constexprs
+    struct GlobalSignature
+    {
+        std::vector<std::string> names;
+        Type* type;
+        int valuePosition;
+    };
+
+    // Built by the hoisting pass, which parses every global signature exactly once.
+    // Declarations are keyed by the position of their keyword token so that the main
+    // parse can look up the signature and jump straight to the body
+    class DeclarationIndex
+    {
+    public:
+        void addFunction(int position, FunctionSignature signature);
+        void addStruct(int position, StructSignature signature);
+        void addGlobal(int position, GlobalSignature signature);
+
+        // Declarations with no body to parse, such as imports and enums
+        void addComplete(int position, int endPosition);
+
+        const FunctionSignature& getFunction(int position) const;
+        const StructSignature& getStruct(int position) const;
+        const GlobalSignature& getGlobal(int position) const;
+
+        // Returns the position after the declaration, or -1 if it still needs parsing
+        int getCompleteEnd(int position) const;
+
+    private:
+        std::unordered_map<int, FunctionSignature> mFunctions;
+        std::unordered_map<int, StructSignature> mStructs;
+        std::unordered_map<int, GlobalSignature> mGlobals;
+        std::unordered_map<int, int> mComplete;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_PARSER_DECLARATION_INDEX_H
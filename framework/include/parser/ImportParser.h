@@ -3,6 +3,8 @@
 #ifndef VIPER_FRAMEWORK_PARSER_IMPORT_PARSER_H
 #define VIPER_FRAMEWORK_PARSER_IMPORT_PARSER_H 1
 
+#include "parser/DeclarationIndex.h"
+
 #include "parser/ast/Node.h"
 #include "parser/ast/global/Function.h"
 #include "parser/ast/global/StructDeclaration.h"
@@ -13,8 +15,10 @@
 #include "parser/ast/statement/ConstexprStatement.h"
 
 #include "lexer/Token.h"
+#include "lexer/TokenStream.h"
 
 #include "symbol/Import.h"
+#include "symbol/ModuleInterface.h"
 
 #include "diagnostic/Diagnostic.h"
 
@@ -27,17 +31,20 @@ namespace parser
     class ImportParser
     {
     public:
-        ImportParser(std::vector<lexing::Token>& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, bool hoistingParser = false);
+        ImportParser(const lexing::TokenStream& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, support::Arena& arena, bool hoistingParser = false);
 
         std::vector<ASTNodePtr> parse();
 
         std::vector<GlobalSymbol> getSymbols();
+        DeclarationIndex& getDeclarations();
+        const symbol::InterfaceWriter& getInterface() const;
 
     private:
-        std::vector<lexing::Token>& mTokens;
+        const lexing::TokenStream& mTokens;
         int mPosition;
 
         symbol::ImportManager& mImportManager;
+        support::Arena& mArena;
 
         Scope* mScope;
         std::vector<GlobalSymbol> mSymbols;
@@ -48,6 +55,8 @@ namespace parser
         std::vector<std::string> mNamespaces;
 
         bool mHoistingParser;
+        DeclarationIndex mDeclarations;
+        symbol::InterfaceWriter mInterface; // Records what importing this module produces, unless hoisting
 
         lexing::Token current() const;
         lexing::Token consume();
@@ -0,0 +1,56 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_PARSER_INLINER_H
+#define VIPER_FRAMEWORK_PARSER_INLINER_H 1
+
+#include "parser/ast/Node.h"
+
+#include "parser/ast/global/GlobalAttribute.h"
+
+#include <string>
+#include <vector>
+
+namespace parser
+{
+    enum class InlinePolicy
+    {
+        Default, // Inlined if the body is small enough
+        Always,
+        Never,
+    };
+
+    // A function or method body that calls can be emitted into in place of calling it
+    struct InlineFunction
+    {
+        std::vector<std::string> parameters; // The locals of scope that a call's arguments are bound to, in order
+        Type* returnType{ nullptr };
+        std::vector<ASTNodePtr>* body{ nullptr };
+        Scope* scope{ nullptr };
+        int size{ 0 }; // Tokens in the body, as a measure of the code inlining it duplicates
+        InlinePolicy policy{ InlinePolicy::Default };
+        bool emitting{ false }; // The body is being emitted, so calls within it can't be emitted into it again
+    };
+
+    // Emits the AST of small or [[Inline]] functions at their call sites, binding the callee's
+    // scope to the call's arguments while its body is emitted there
+    class Inliner
+    {
+    public:
+        static constexpr int MaxInlineSize = 32; // Tokens
+
+        static InlinePolicy GetPolicy(const std::vector<GlobalAttribute>& attributes);
+
+        // The inlinable function a call to names would reach from namespaces, if it is one
+        static InlineFunction* FindFunction(const std::vector<std::string>& names, const std::vector<std::string>& namespaces);
+
+        static bool ShouldInline(const InlineFunction& function);
+
+        // Emits function's body with its parameters bound to arguments, returns the value it returns
+        static vipir::Value* Emit(InlineFunction& function, vipir::IRBuilder& builder, vipir::Module& module, std::vector<vipir::Value*> arguments, diagnostic::Diagnostics& diag);
+
+    private:
+        static vipir::Value* joinReturns(vipir::IRBuilder& builder, Type* type, const InlineReturn& inlineReturn);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_PARSER_INLINER_H
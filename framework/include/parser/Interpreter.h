@@ -0,0 +1,122 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_PARSER_INTERPRETER_H
+#define VIPER_FRAMEWORK_PARSER_INTERPRETER_H 1
+
+#include "parser/ast/Node.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parser
+{
+    class Function;
+
+    // A value computed at compile time. Integers, booleans and enum values are held in integer,
+    // sign or zero extended from their type. Arrays hold their elements and structs their fields in order
+    struct ConstexprValue
+    {
+        Type* type{ nullptr };
+        intmax_t integer{ 0 };
+        std::vector<ConstexprValue> elements;
+    };
+
+    // Runs constexpr functions over their AST at compile time
+    class Interpreter
+    {
+    public:
+        enum class Flow
+        {
+            Normal,
+            Break,
+            Continue,
+            Return,
+        };
+
+        enum class Limit
+        {
+            None,
+            Steps,
+            Memory,
+            CallDepth,
+        };
+
+        static constexpr std::uint64_t MaxSteps = 10'000'000;
+        static constexpr std::size_t MaxMemory = 1024 * 1024; // Bytes of locals live at once, measured as their type's size
+        static constexpr int MaxCallDepth = 256;
+
+        Interpreter();
+
+        // Returns the result of calling function, or nothing if it couldn't be evaluated at compile time
+        std::optional<ConstexprValue> call(Function& function, std::vector<ConstexprValue> arguments);
+
+        // The limit an evaluation that failed ran into, if any
+        Limit getLimitExceeded() const;
+
+        // Runs the statements of a body in order until one of them changes the flow. Counts a step for each
+        bool run(std::vector<ASTNodePtr>& body, Scope* scope);
+
+        // Counts a step of evaluation, false once the step limit is exceeded
+        bool step();
+
+        Flow getFlow() const;
+        void setFlow(Flow flow);
+
+        // Ends an iteration of a loop body, returns false if the flow leaves the loop
+        bool continueLoop();
+        ConstexprValue& getReturnValue();
+
+        // Locals are held per scope of the running call, like the allocas they replace
+        bool declareLocal(Scope* scope, const std::string& name, ConstexprValue value);
+        ConstexprValue* findLocal(Scope* scope, const std::string& name);
+
+        // Holds a value that isn't stored in a local, so it can be indexed or accessed like one
+        ConstexprValue* makeTemporary(ConstexprValue value);
+
+        // Releases the temporaries made while it is alive, and the memory they are counted against. Held by
+        // an expression that copies its value out of an lvalue, which is the last use of any temporary in it
+        class TemporaryScope
+        {
+        public:
+            TemporaryScope(Interpreter& interpreter);
+            ~TemporaryScope();
+
+            TemporaryScope(const TemporaryScope&) = delete;
+            TemporaryScope& operator=(const TemporaryScope&) = delete;
+
+        private:
+            Interpreter& mInterpreter;
+            std::size_t mCount;
+        };
+
+        // The value an uninitialized local of type starts with. Fails for types with no compile time value
+        bool makeZero(Type* type, ConstexprValue& value);
+
+        // The constexpr function a call to names would reach from namespaces, if there is one
+        static Function* FindFunction(const std::vector<std::string>& names, const std::vector<std::string>& namespaces);
+
+    private:
+        struct Frame
+        {
+            std::unordered_map<Scope*, std::unordered_map<std::string, ConstexprValue> > locals;
+            std::deque<ConstexprValue> temporaries;
+            ConstexprValue returnValue;
+            std::size_t memory{ 0 };
+        };
+
+        std::deque<Frame> mFrames; // Locals are pointed to while calls push frames, so frames must not move
+        Flow mFlow;
+        std::uint64_t mSteps;
+        std::size_t mMemory;
+        Limit mLimitExceeded;
+
+        bool allocate(std::size_t bytes);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_PARSER_INTERPRETER_H
@@ -3,6 +3,8 @@
 #ifndef VIPER_FRAMEWORK_PARSER_PARSER_H
 #define VIPER_FRAMEWORK_PARSER_PARSER_H 1
 
+#include "parser/DeclarationIndex.h"
+
 #include "parser/ast/Node.h"
 #include "parser/ast/global/Function.h"
 #include "parser/ast/global/StructDeclaration.h"
@@ -30,6 +32,7 @@
 #include "parser/ast/expression/SizeofExpression.h"
 
 #include "lexer/Token.h"
+#include "lexer/TokenStream.h"
 
 #include "symbol/Import.h"
 
@@ -45,26 +48,49 @@ namespace parser
         Type* type;
     };
 
+    // The tokens of a function body, from its '{' or '=' up to the token after it. Methods are
+    // left out, they can only be parsed with their struct
+    struct FunctionBody
+    {
+        int start;
+        int end;
+        Function* function;
+    };
+
     class Parser
     {
     public:
-        Parser(std::vector<lexing::Token>& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager);
+        Parser(const lexing::TokenStream& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, support::Arena& arena);
 
         std::vector<ASTNodePtr> parse();
 
+        // Bodies of the functions defined in this file, in source order
+        const std::vector<FunctionBody>& getFunctionBodies() const;
+
+        // Parses tokens, which hold just a function body from its '{' or '=', as the new body of function.
+        // Names are resolved as they were when this parser parsed the file. Returns false if tokens hold more than the body
+        bool reparseFunctionBody(const lexing::TokenStream& tokens, Function& function);
+
     private:
-        std::vector<lexing::Token>& mTokens;
+        const lexing::TokenStream& mTokens;
         int mPosition;
+        bool mPendingSemicolon; // Compound statements and switches are followed by an implicit semicolon
 
         symbol::ImportManager& mImportManager;
+        support::Arena& mArena;
 
         Scope* mScope;
         std::vector<GlobalSymbol> mSymbols;
+        DeclarationIndex mDeclarations;
+        std::vector<FunctionBody> mFunctionBodies;
 
         diagnostic::Diagnostics& mDiag;
 
         std::vector<std::string> mNamespaces;
 
+        std::vector<Scope*> mLoopScopes; // Loops being parsed, innermost last
+        int mSwitchDepth;
+
         lexing::Token current() const;
         lexing::Token consume();
         lexing::Token peek(int offset) const;
@@ -78,18 +104,16 @@ namespace parser
 
         Type* parseType(bool failable = false);
 
-        ASTNodePtr parseGlobal(std::vector<ASTNodePtr>& nodes);
+        ASTNodePtr parseGlobal();
         ASTNodePtr parseExpression(Type* preferredType = nullptr, int precedence = 1);
         ASTNodePtr parsePrimary(Type* preferredType = nullptr);
         ASTNodePtr parseParenthesizedExpression(Type* preferredType = nullptr);
 
-        FunctionPtr parseFunction(std::vector<GlobalAttribute> attributes);
+        FunctionPtr parseFunction(std::vector<GlobalAttribute> attributes, bool isConstexpr = false);
+        std::vector<ASTNodePtr> parseFunctionBody(Type* type);
         NamespacePtr parseNamespace();
         StructDeclarationPtr parseStructDeclaration();
         GlobalDeclarationPtr parseGlobalDeclaration();
-        std::pair<std::vector<ASTNodePtr>, std::vector<GlobalSymbol>> parseImportStatement();
-        UsingDeclarationPtr parseUsingDeclaration();
-        EnumDeclarationPtr parseEnumDeclaration();
 
         CompoundStatementPtr parseCompoundStatement();
         ReturnStatementPtr parseReturnStatement();
@@ -110,6 +134,9 @@ namespace parser
         ArrayInitializerPtr parseArrayInitializer(Type* preferredType = nullptr);
 
         void parseAttributes(std::vector<GlobalAttribute>& attributes);
+
+        // Records what SSA construction needs to know about a local that is written or has its address taken
+        void markLocal(ASTNode* node, bool addressTaken);
     };
 }
 
@@ -11,12 +11,16 @@
 
 #include "lexer/Token.h"
 
-#include <vipir/IR/IRBuilder.h>
+#include "support/Arena.h"
 
-#include <memory>
+#include <vipir/IR/IRBuilder.h>
 
 namespace parser
 {
+    class ConstantFolder;
+    class Interpreter;
+    struct ConstexprValue;
+
     class ASTNode
     {
     public:
@@ -27,14 +31,20 @@ namespace parser
         lexing::Token& getDebugToken() { return mPreferredDebugToken; }
 
         virtual void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) = 0;
+        // Folds constant children into literals. Returns a literal to replace this node with, or nullptr to keep it
+        virtual support::ArenaPtr<ASTNode> fold(ConstantFolder& folder, Scope* scope) = 0;
+        // Evaluates this node while running a constexpr function. Returns false if it can't be evaluated at compile time
+        virtual bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) = 0;
+        // The storage this node names while running a constexpr function, or nullptr if it doesn't name any
+        virtual ConstexprValue* evaluateLvalue(Interpreter& interpreter, Scope* scope) { return nullptr; }
         virtual vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) = 0;
     
     protected:
-        Type* mType;
+        Type* mType{ nullptr };
 
         lexing::Token mPreferredDebugToken;
     };
-    using ASTNodePtr = std::unique_ptr<ASTNode>;
+    using ASTNodePtr = support::ArenaPtr<ASTNode>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_AST_NODE_H
\ No newline at end of file
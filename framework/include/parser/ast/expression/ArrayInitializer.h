@@ -15,12 +15,14 @@ namespace parser
         ArrayInitializer(std::vector<ASTNodePtr>&& body, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::vector<ASTNodePtr> mBody;
     };
-    using ArrayInitializerPtr = std::unique_ptr<ArrayInitializer>;
+    using ArrayInitializerPtr = support::ArenaPtr<ArrayInitializer>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_ARRAY_INITIALIZER_H
\ No newline at end of file
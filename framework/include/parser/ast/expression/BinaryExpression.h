@@ -8,6 +8,9 @@
 
 #include "lexer/Token.h"
 
+#include <cstdint>
+#include <optional>
+
 namespace parser
 {
     class BinaryExpression : public ASTNode
@@ -33,6 +36,9 @@ namespace parser
         BinaryExpression(ASTNodePtr left, lexing::Token operatorToken, ASTNodePtr right);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
+        ConstexprValue* evaluateLvalue(Interpreter& interpreter, Scope* scope) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -42,9 +48,12 @@ namespace parser
         ASTNodePtr mRight;
 
         void checkAssignmentLvalue(vipir::Value* pointer, diagnostic::Diagnostics& diag);
+
+        // The result of applying op to two integer values of type, or nothing if it has none at compile time
+        static std::optional<intmax_t> Compute(Operator op, intmax_t left, intmax_t right, Type* type);
     };
 
-    using BinaryExpressionPtr = std::unique_ptr<BinaryExpression>;
+    using BinaryExpressionPtr = support::ArenaPtr<BinaryExpression>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_BINARY_EXPRESSION_H
\ No newline at end of file
@@ -15,12 +15,14 @@ namespace parser
         bool getValue() const;
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         bool mValue;
     };
-    using BooleanLiteralPtr = std::unique_ptr<BooleanLiteral>;
+    using BooleanLiteralPtr = support::ArenaPtr<BooleanLiteral>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_BOOLEAN_LITERAL_H
\ No newline at end of file
@@ -8,12 +8,16 @@
 
 namespace parser
 {
+    class Function;
+
     class CallExpression : public ASTNode
     {
     public:
         CallExpression(ASTNodePtr function, std::vector<ASTNodePtr> parameters, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -21,9 +25,14 @@ namespace parser
         std::vector<ASTNodePtr> mParameters;
 
         FunctionType* mFunctionType;
+
+        Function* findConstexprFunction(Scope* scope);
+
+        // Emits the callee's body in place of the call if it should be inlined, or a call to function if not
+        vipir::Value* emitCall(vipir::IRBuilder& builder, vipir::Module& module, diagnostic::Diagnostics& diag, const std::vector<std::string>& names, const std::vector<std::string>& namespaces, vipir::Function* function, std::vector<vipir::Value*> parameters);
     };
 
-    using CallExpressionPtr = std::unique_ptr<CallExpression>;
+    using CallExpressionPtr = support::ArenaPtr<CallExpression>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_CALL_EXPRESSION_H
\ No newline at end of file
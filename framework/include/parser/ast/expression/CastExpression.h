@@ -16,6 +16,8 @@ namespace parser
         CastExpression(ASTNodePtr operand, Type* destType, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -23,7 +25,7 @@ namespace parser
         lexing::Token mToken;
     };
 
-    using CastExpressionPtr = std::unique_ptr<CastExpression>;
+    using CastExpressionPtr = support::ArenaPtr<CastExpression>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_CAST_EXPRESSION_H
\ No newline at end of file
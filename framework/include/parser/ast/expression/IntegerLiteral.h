@@ -15,12 +15,14 @@ namespace parser
         intmax_t getValue() const;
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         intmax_t mValue;
     };
-    using IntegerLiteralPtr = std::unique_ptr<IntegerLiteral>;
+    using IntegerLiteralPtr = support::ArenaPtr<IntegerLiteral>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_INTEGER_LITERAL_H
\ No newline at end of file
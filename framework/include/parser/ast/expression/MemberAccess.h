@@ -17,6 +17,9 @@ namespace parser
         MemberAccess(ASTNodePtr struc, std::string field, bool pointer, lexing::Token fieldToken);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
+        ConstexprValue* evaluateLvalue(Interpreter& interpreter, Scope* scope) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -26,7 +29,7 @@ namespace parser
         lexing::Token mFieldToken;
     };
 
-    using MemberAccessPtr = std::unique_ptr<MemberAccess>;
+    using MemberAccessPtr = support::ArenaPtr<MemberAccess>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_MEMBER_ACCESS_H
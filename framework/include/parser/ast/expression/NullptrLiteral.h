@@ -13,9 +13,11 @@ namespace parser
         NullptrLiteral(Type* type, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
     };
-    using NullptrLiteralPtr = std::unique_ptr<NullptrLiteral>;
+    using NullptrLiteralPtr = support::ArenaPtr<NullptrLiteral>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_NULLPTR_LITERAL_H
\ No newline at end of file
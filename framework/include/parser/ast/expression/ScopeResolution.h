@@ -18,6 +18,8 @@ namespace parser
         std::vector<std::string> getNames();
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -26,7 +28,7 @@ namespace parser
         ASTNodePtr mRight;
     };
 
-    using ScopeResolutionPtr = std::unique_ptr<ScopeResolution>;
+    using ScopeResolutionPtr = support::ArenaPtr<ScopeResolution>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_SCOPE_RESOLUTION_H
\ No newline at end of file
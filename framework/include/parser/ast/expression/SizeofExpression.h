@@ -11,13 +11,15 @@ namespace parser
         SizeofExpression(Type* expressionType, Type* type, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         Type* mTypeToSize;
     };
 
-    using SizeofExpressionPtr = std::unique_ptr<SizeofExpression>;
+    using SizeofExpressionPtr = support::ArenaPtr<SizeofExpression>;
 }
 
 #endif //VIPER_SIZEOFEXPRESSION_H
@@ -13,12 +13,14 @@ namespace parser
         StringLiteral(std::string value, lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::string mValue;
     };
-    using StringLiteralPtr = std::unique_ptr<StringLiteral>;
+    using StringLiteralPtr = support::ArenaPtr<StringLiteral>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_STRING_LITERAL_H
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace parser
         StructInitializer(Type* type, std::vector<ASTNodePtr>&& body, lexing::Token typeToken);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -20,7 +22,7 @@ namespace parser
         
         lexing::Token mTypeToken;
     };
-    using StructInitializerPtr = std::unique_ptr<StructInitializer>;
+    using StructInitializerPtr = support::ArenaPtr<StructInitializer>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_STRUCT_INITIALIZER_H
\ No newline at end of file
@@ -28,6 +28,8 @@ namespace parser
         UnaryExpression(ASTNodePtr operand, lexing::Token operatorToken, bool postfix = false);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -38,7 +40,7 @@ namespace parser
         void checkAssignmentLvalue(vipir::Value* pointer, diagnostic::Diagnostics& diag);
     };
 
-    using UnaryExpressionPtr = std::unique_ptr<UnaryExpression>;
+    using UnaryExpressionPtr = support::ArenaPtr<UnaryExpression>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_UNARY_EXPRESSION_H
\ No newline at end of file
@@ -17,14 +17,20 @@ namespace parser
         
         std::string getName();
 
+        // The local node names if it is kept in SSA values, which is written by replacing its value rather than with a store
+        static LocalSymbol* FindPromotedLocal(ASTNode* node, Scope* scope);
+
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
+        ConstexprValue* evaluateLvalue(Interpreter& interpreter, Scope* scope) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::string mName;
         lexing::Token mToken;
     };
-    using VariableExpressionPtr = std::unique_ptr<VariableExpression>;
+    using VariableExpressionPtr = support::ArenaPtr<VariableExpression>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_EXPRESSION_VARIABLE_EXPRESSION_H
\ No newline at end of file
@@ -19,13 +19,15 @@ namespace parser
         EnumDeclaration(std::vector<std::string> names, std::vector<EnumField> fields);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::vector<std::string> mNames;
         std::vector<EnumField> mFields;
     };
-    using EnumDeclarationPtr = std::unique_ptr<EnumDeclaration>;
+    using EnumDeclarationPtr = support::ArenaPtr<EnumDeclaration>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_GLOBAL_ENUM_DECLARATION_H
\ No newline at end of file
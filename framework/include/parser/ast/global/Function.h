@@ -7,6 +7,8 @@
 
 #include "parser/ast/global/GlobalAttribute.h"
 
+#include "parser/Inliner.h"
+
 namespace parser
 {
     struct FunctionArgument
@@ -15,14 +17,34 @@ namespace parser
         Type* type;
     };
 
+    // Where a function body was parsed from, for annotating traces
+    struct SourceRange
+    {
+        std::string_view fileName;
+        int tokenStart{ -1 };
+        int tokenEnd{ -1 };
+    };
+
     class Function : public ASTNode
     {
     public:
         Function(std::vector<GlobalAttribute> attributes, Type* type, std::vector<FunctionArgument> arguments, std::string_view name, std::vector<ASTNodePtr>&& body, Scope* scope);
 
         Type* getReturnType() const;
+        Type* getFunctionType() const;
+        const std::vector<FunctionArgument>& getArguments() const;
+        Scope* getScope() const;
+        std::vector<ASTNodePtr>& getBody();
+        InlineFunction& getInlineFunction();
+
+        // Replaces the body after it was parsed again on its own
+        void setBody(std::vector<ASTNodePtr> body, Scope* scope);
+
+        void setSourceRange(SourceRange sourceRange);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -33,8 +55,10 @@ namespace parser
         std::string mName;
         std::vector<ASTNodePtr> mBody;
         ScopePtr mScope;
+        SourceRange mSourceRange;
+        InlineFunction mInlineFunction;
     };
-    using FunctionPtr = std::unique_ptr<Function>;
+    using FunctionPtr = support::ArenaPtr<Function>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_GLOBAL_FUNCTION_H
@@ -7,7 +7,9 @@ namespace parser
 {
     enum class GlobalAttributeType
     {
-        NoMangle
+        NoMangle,
+        Inline,
+        NoInline,
     };
 
     class GlobalAttribute
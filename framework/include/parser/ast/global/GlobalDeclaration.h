@@ -13,13 +13,15 @@ namespace parser
         GlobalDeclaration(std::vector<std::string> names, Type* type, ASTNodePtr initVal);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::vector<std::string> mNames;
         ASTNodePtr mInitVal;
     };
-    using GlobalDeclarationPtr = std::unique_ptr<GlobalDeclaration>;
+    using GlobalDeclarationPtr = support::ArenaPtr<GlobalDeclaration>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_GLOBAL_STRUCT_DECLARATION_H
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace parser
         Namespace(std::string_view name, std::vector<ASTNodePtr>&& body, Scope* scope);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -20,7 +22,7 @@ namespace parser
         std::vector<ASTNodePtr> mBody;
         ScopePtr mScope;
     };
-    using NamespacePtr = std::unique_ptr<Namespace>;
+    using NamespacePtr = support::ArenaPtr<Namespace>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_GLOBAL_NAMESPACE_H
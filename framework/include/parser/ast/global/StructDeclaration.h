@@ -23,6 +23,9 @@ namespace parser
         std::vector<FunctionArgument> arguments;
         std::vector<ASTNodePtr> body;
         ScopePtr scope;
+        SourceRange sourceRange{};
+        std::vector<GlobalAttribute> attributes{};
+        InlineFunction inlineFunction{};
     };
 
     class StructDeclaration : public ASTNode
@@ -31,6 +34,8 @@ namespace parser
         StructDeclaration(std::vector<std::string> names, std::vector<StructField> fields, std::vector<StructMethod> methods, Type* type);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
         std::vector<std::string>& getNames();
@@ -42,7 +47,7 @@ namespace parser
         std::vector<StructField> mFields;
         std::vector<StructMethod> mMethods;
     };
-    using StructDeclarationPtr = std::unique_ptr<StructDeclaration>;
+    using StructDeclarationPtr = support::ArenaPtr<StructDeclaration>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_GLOBAL_STRUCT_DECLARATION_H
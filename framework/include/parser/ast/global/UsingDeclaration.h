@@ -13,13 +13,15 @@ namespace parser
         UsingDeclaration(std::vector<std::string> names, Type* type);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::vector<std::string> mNames;
         Type* mType;
     };
-    using UsingDeclarationPtr = std::unique_ptr<UsingDeclaration>;
+    using UsingDeclarationPtr = support::ArenaPtr<UsingDeclaration>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_USING_DECLARATION_H
\ No newline at end of file
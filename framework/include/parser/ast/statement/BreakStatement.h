@@ -15,12 +15,14 @@ namespace parser
         BreakStatement(lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         lexing::Token mToken;
     };
-    using BreakStatementPtr = std::unique_ptr<BreakStatement>;
+    using BreakStatementPtr = support::ArenaPtr<BreakStatement>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_BREAK_STATEMENT_H
\ No newline at end of file
@@ -13,13 +13,15 @@ namespace parser
         CompoundStatement(std::vector<ASTNodePtr>&& body, Scope* scope);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::vector<ASTNodePtr> mBody;
         ScopePtr mScope;
     };
-    using CompoundStatementPtr = std::unique_ptr<CompoundStatement>;
+    using CompoundStatementPtr = support::ArenaPtr<CompoundStatement>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_COMPOUND_STATEMENT_H
\ No newline at end of file
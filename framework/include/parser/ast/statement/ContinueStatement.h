@@ -13,12 +13,14 @@ namespace parser
         ContinueStatement(lexing::Token token);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         lexing::Token mToken;
     };
-    using ContinueStatementPtr = std::unique_ptr<ContinueStatement>;
+    using ContinueStatementPtr = support::ArenaPtr<ContinueStatement>;
 }
 
 #endif //VIPER_CONTINUESTATEMENT_H
@@ -11,6 +11,8 @@ namespace parser
         ForStatement(ASTNodePtr&& init, ASTNodePtr&& condition, std::vector<ASTNodePtr>&& loopExpr, ASTNodePtr&& body, Scope* scope);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -19,9 +21,12 @@ namespace parser
         std::vector<ASTNodePtr> mLoopExpr;
         ASTNodePtr mBody;
         ScopePtr mScope;
+
+        // A loop with no condition to test, which only leaves through a break or return
+        void emitEndlessLoop(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::BasicBlock* bodyBasicBlock, vipir::BasicBlock* doneBasicBlock);
     };
 
-    using ForStatementPtr = std::unique_ptr<ForStatement>;
+    using ForStatementPtr = support::ArenaPtr<ForStatement>;
 }
 
 #endif //VIPER_FORSTATEMENT_H
@@ -13,6 +13,8 @@ namespace parser
         IfStatement(ASTNodePtr&& condition, ASTNodePtr&& body, ASTNodePtr&& elseBody);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -20,7 +22,7 @@ namespace parser
         ASTNodePtr mBody;
         ASTNodePtr mElseBody;
     };
-    using IfStatementPtr = std::unique_ptr<IfStatement>;
+    using IfStatementPtr = support::ArenaPtr<IfStatement>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_IF_STATEMENT_H
\ No newline at end of file
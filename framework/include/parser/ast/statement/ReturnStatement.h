@@ -12,13 +12,17 @@ namespace parser
     public:
         ReturnStatement(ASTNodePtr&& returnValue);
 
+        ASTNode* getReturnValue() const;
+
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         ASTNodePtr mReturnValue;
     };
-    using ReturnStatementPtr = std::unique_ptr<ReturnStatement>;
+    using ReturnStatementPtr = support::ArenaPtr<ReturnStatement>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_RETURN_STATEMENT_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "parser/ast/Node.h"
 
+#include <optional>
+
 namespace parser
 {
     struct SwitchSection
@@ -17,14 +19,32 @@ namespace parser
         SwitchStatement(ASTNodePtr&& value, std::vector<SwitchSection>&& cases);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         ASTNodePtr mValue;
         std::vector<SwitchSection> mSections;
+
+        // A case value and the section it labels
+        struct Case
+        {
+            intmax_t value;
+            int section;
+        };
+
+        std::optional<intmax_t> getLabelValue(ASTNode* label, Scope* scope);
+        int getBodyFor(int section);
+        void endSwitch(vipir::IRBuilder& builder, Scope* scope, vipir::BasicBlock* endBlock, vipir::BasicBlock* breakTo);
+        std::optional<intmax_t> getReturnedConstant(int section);
+
+        void emitCompareChain(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::Value* value);
+        void emitDecisionTree(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::Value* value, const std::vector<Case>& cases, int defaultSection);
+        bool emitLookupTable(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, vipir::Value* value, const std::vector<Case>& cases, int defaultSection);
     };
 
-    using SwitchStatementPtr = std::unique_ptr<SwitchStatement>;
+    using SwitchStatementPtr = support::ArenaPtr<SwitchStatement>;
 }
 
 #endif //VIPER_SWITCHSTATEMENT_H
@@ -13,13 +13,15 @@ namespace parser
         VariableDeclaration(Type* type, std::string&& name, ASTNodePtr&& initialValue);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
         std::string mName;
         ASTNodePtr mInitialValue;
     };
-    using VariableDeclarationPtr = std::unique_ptr<VariableDeclaration>;
+    using VariableDeclarationPtr = support::ArenaPtr<VariableDeclaration>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_VARIABLE_DECLARATION_H
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace parser
         WhileStatement(ASTNodePtr&& condition, ASTNodePtr&& body, Scope* scope);
 
         void typeCheck(Scope* scope, diagnostic::Diagnostics& diag) override;
+        ASTNodePtr fold(ConstantFolder& folder, Scope* scope) override;
+        bool evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result) override;
         vipir::Value* emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag) override;
 
     private:
@@ -20,7 +22,7 @@ namespace parser
         ASTNodePtr mBody;
         ScopePtr mScope;
     };
-    using WhileStatementPtr = std::unique_ptr<WhileStatement>;
+    using WhileStatementPtr = support::ArenaPtr<WhileStatement>;
 }
 
 #endif // VIPER_FRAMEWORK_PARSER_AST_STATEMENT_WHILE_STATEMENT_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_ARENA_H
+#define VIPER_FRAMEWORK_SUPPORT_ARENA_H 1
+
+#include "support/MemoryReport.h"
+#include "support/TimeReport.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace support
+{
+    // Runs an object's destructor without freeing its memory, which is
+    // released all at once when the owning arena is destroyed
+    struct ArenaDeleter
+    {
+        template <class T>
+        void operator()(T* object) const
+        {
+            std::destroy_at(object);
+        }
+    };
+
+    template <class T>
+    using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+    // Bump-pointer allocator. Objects allocated in the arena must not outlive it
+    class Arena
+    {
+    public:
+        Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(std::size_t size, std::size_t alignment);
+
+        template <class T, class... Args>
+        T* create(Args&&... args)
+        {
+            if (TimeReport* report = TimeReport::Current())
+            {
+                report->countAllocation<T>();
+            }
+            if (MemoryReport* report = MemoryReport::Current())
+            {
+                report->countArenaObject(ArenaOwner<T>, sizeof(T));
+            }
+            MemoryReport::Owning owning(ArenaOwner<T>); // Heap allocations made by the constructor
+            return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        template <class T, class... Args>
+        ArenaPtr<T> make(Args&&... args)
+        {
+            return ArenaPtr<T>(create<T>(std::forward<Args>(args)...));
+        }
+
+        std::size_t getBytesAllocated() const;
+
+    private:
+        static constexpr std::size_t BlockSize = 64 * 1024;
+
+        std::vector<std::unique_ptr<std::byte[]> > mBlocks;
+        std::byte* mCurrent;
+        std::byte* mEnd;
+        std::size_t mBytesAllocated;
+
+        void newBlock(std::size_t minSize);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_ARENA_H
@@ -0,0 +1,16 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_BUILD_ID_H
+#define VIPER_FRAMEWORK_SUPPORT_BUILD_ID_H 1
+
+#include <string>
+
+namespace support
+{
+    // Identifies the build of the compiler that is running: the version, then the build id the linker
+    // gave the executable and vipir. Anything a compiler writes for a later one to reuse is keyed on it,
+    // since any change to the code changes it while the version stays the same
+    const std::string& BuildId();
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_BUILD_ID_H
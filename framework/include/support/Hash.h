@@ -0,0 +1,17 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_HASH_H
+#define VIPER_FRAMEWORK_SUPPORT_HASH_H 1
+
+#include <cstdint>
+#include <string_view>
+
+namespace support
+{
+    constexpr std::uint64_t HashSeed = 0xcbf29ce484222325;
+
+    // 64-bit FNV-1a. Pass the result of a previous call as the seed to hash several pieces of data as one
+    std::uint64_t Hash(std::string_view data, std::uint64_t seed = HashSeed);
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_HASH_H
@@ -0,0 +1,115 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_MEMORY_REPORT_H
+#define VIPER_FRAMEWORK_SUPPORT_MEMORY_REPORT_H 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace support
+{
+    // Heap allocations made by one compilation, by phase and by what they were made for.
+    // Only allocations on the compiling thread are seen, which are all of them since compilations
+    // don't share threads. Phases nest, so the allocations of a phase include the phases inside it
+    class MemoryReport
+    {
+    public:
+        enum class Owner
+        {
+            Other,
+            Tokens,
+            ASTNodes,
+            Scopes,
+            Types,
+            Identifiers,
+            Vipir,
+            ArenaBlocks,
+
+            Count
+        };
+
+        // Attributes the allocations made in the enclosing block to owner
+        class Owning
+        {
+        public:
+            Owning(Owner owner);
+            ~Owning();
+
+            Owning(const Owning&) = delete;
+            Owning& operator=(const Owning&) = delete;
+
+        private:
+            Owner mPrevious;
+        };
+
+        // Attributes the allocations made in the enclosing block to a phase if there is a current report
+        class Phase
+        {
+        public:
+            Phase(std::string_view name);
+            ~Phase();
+
+            Phase(const Phase&) = delete;
+            Phase& operator=(const Phase&) = delete;
+
+        private:
+            MemoryReport* mReport;
+        };
+
+        MemoryReport();
+        ~MemoryReport();
+
+        // The report of the calling thread's compilation, or nullptr if it isn't being tracked
+        static MemoryReport* Current();
+
+        // Makes this the report of the calling thread until another one is made current or this one is destroyed
+        void makeCurrent();
+
+        // Called by the global allocation functions with the usable size of each block
+        static void RecordAllocation(std::size_t bytes);
+        static void RecordDeallocation(std::size_t bytes);
+
+        // Objects in an arena don't get heap allocations of their own, so the arena counts them here
+        void countArenaObject(Owner owner, std::size_t bytes);
+
+        void print(std::ostream& stream, std::string_view fileName) const;
+
+    private:
+        struct Usage
+        {
+            std::uint64_t allocations{ 0 };
+            std::uint64_t bytes{ 0 };
+        };
+
+        struct PhaseMemory
+        {
+            std::string name;
+            Usage usage;
+            std::int64_t highWaterMark; // Of live bytes while the phase was running
+            int count;
+        };
+
+        std::vector<PhaseMemory> mPhases; // In the order each phase was first entered
+        std::vector<std::size_t> mActivePhases; // Indices into mPhases, a phase entered again while running is only counted once
+        std::array<Usage, static_cast<std::size_t>(Owner::Count)> mOwners;
+        Usage mTotal;
+        std::int64_t mLiveBytes;
+        std::int64_t mHighWaterMark;
+
+        void enterPhase(std::string_view name);
+        void exitPhase();
+        void allocate(std::size_t bytes);
+    };
+
+    // The owner that objects of type T count towards when created in an arena.
+    // Specialized for the few types in an arena that aren't AST nodes
+    template <class T>
+    inline constexpr MemoryReport::Owner ArenaOwner = MemoryReport::Owner::ASTNodes;
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_MEMORY_REPORT_H
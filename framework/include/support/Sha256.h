@@ -0,0 +1,34 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_SHA256_H
+#define VIPER_FRAMEWORK_SUPPORT_SHA256_H 1
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace support
+{
+    // SHA-256, for keys that name stored data and so must not collide. Hash is enough for hash tables
+    class Sha256
+    {
+    public:
+        Sha256();
+
+        void update(std::string_view data);
+
+        // Finishes the hash, so nothing can be added after
+        std::string hexDigest();
+
+    private:
+        std::array<std::uint32_t, 8> mState;
+        std::array<unsigned char, 64> mBlock;
+        std::size_t mBlockSize;
+        std::uint64_t mLength; // In bytes
+
+        void compress(const unsigned char* block);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_SHA256_H
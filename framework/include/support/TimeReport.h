@@ -0,0 +1,94 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_TIME_REPORT_H
+#define VIPER_FRAMEWORK_SUPPORT_TIME_REPORT_H 1
+
+#include "support/MemoryReport.h"
+#include "support/Trace.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace support
+{
+    // Wall and CPU time spent in each phase of one compilation, and counts of what it created.
+    // CPU time is that of the compiling thread, since compilations run on several threads at once.
+    // Phases nest, so the time of a phase includes the phases inside it
+    class TimeReport
+    {
+    public:
+        struct Counters
+        {
+            std::uint64_t tokens{ 0 };
+            std::uint64_t identifiers{ 0 };
+            std::uint64_t types{ 0 };
+            std::uint64_t variableLookups{ 0 };
+            std::uint64_t variableLookupScopes{ 0 }; // Scopes searched by all variable lookups
+            std::uint64_t functionLookups{ 0 };
+            std::uint64_t functionLookupCandidates{ 0 }; // Mangled names tried by all function lookups
+        };
+
+        // Times the enclosing block if there is a current report. The block is also a span of the current trace
+        // and a phase of the current memory report, if there are ones
+        class Phase
+        {
+        public:
+            Phase(std::string_view name);
+            ~Phase();
+
+            Phase(const Phase&) = delete;
+            Phase& operator=(const Phase&) = delete;
+
+        private:
+            Trace::Span mSpan;
+            MemoryReport::Phase mMemoryPhase;
+            TimeReport* mReport;
+            std::string mName;
+            double mWallStart;
+            double mCpuStart;
+        };
+
+        ~TimeReport();
+
+        // The report of the calling thread's compilation, or nullptr if it isn't being timed
+        static TimeReport* Current();
+
+        // Makes this the report of the calling thread until another one is made current or this one is destroyed
+        void makeCurrent();
+
+        Counters& getCounters();
+
+        template <class T>
+        void countAllocation()
+        {
+            ++mAllocations[std::type_index(typeid(T))];
+        }
+
+        // Nodes and scopes of every kind
+        std::uint64_t getAllocationCount() const;
+
+        void print(std::ostream& stream, std::string_view fileName) const;
+
+    private:
+        struct PhaseTime
+        {
+            std::string name;
+            double wallSeconds;
+            double cpuSeconds;
+            int count;
+        };
+
+        std::vector<PhaseTime> mPhases; // In the order each phase was first entered
+        Counters mCounters;
+        std::unordered_map<std::type_index, std::uint64_t> mAllocations;
+
+        void addTime(std::string_view name, double wallSeconds, double cpuSeconds);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_TIME_REPORT_H
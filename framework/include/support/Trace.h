@@ -0,0 +1,73 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SUPPORT_TRACE_H
+#define VIPER_FRAMEWORK_SUPPORT_TRACE_H 1
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace support
+{
+    // A timeline of everything the compiler did, written in the trace-event format that Perfetto and chrome://tracing display.
+    // One trace is shared by all the compiling threads, and each thread gets its own track
+    class Trace
+    {
+    public:
+        // Records the enclosing block as a span if there is a current trace.
+        // Spans nest by time, so a span started inside another is shown below it
+        class Span
+        {
+        public:
+            Span(std::string_view name);
+            Span(std::string_view name, std::string_view detail, std::string_view fileName, int tokenStart, int tokenEnd); // Named "name detail"
+            ~Span();
+
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+        private:
+            Trace* mTrace;
+            std::string mName;
+            std::string mFileName;
+            int mTokenStart;
+            int mTokenEnd;
+            double mStart;
+        };
+
+        Trace();
+        ~Trace();
+
+        // The trace the calling thread records into, or nullptr if it isn't being traced
+        static Trace* Current();
+
+        // Makes the calling thread record into this trace until another one is made current or this one is destroyed
+        void makeCurrent();
+
+        bool writeFile(const std::filesystem::path& path) const;
+
+    private:
+        struct Event
+        {
+            std::string name;
+            std::string fileName;
+            int tokenStart;
+            int tokenEnd;
+            double start; // Microseconds since the trace was created
+            double duration;
+            std::uint32_t thread;
+        };
+
+        double mStart;
+        mutable std::mutex mMutex;
+        std::vector<Event> mEvents;
+
+        double now() const;
+        void addEvent(Event event);
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SUPPORT_TRACE_H
@@ -0,0 +1,63 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SYMBOL_COMPILATION_CONTEXT_H
+#define VIPER_FRAMEWORK_SYMBOL_COMPILATION_CONTEXT_H 1
+
+#include "symbol/Identifier.h"
+#include "symbol/Scope.h"
+
+#include "type/TypeContext.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace parser
+{
+    class Function;
+    struct InlineFunction;
+}
+
+// Owns all state of one compilation: identifiers, types, and the global functions and
+// variables of the module being emitted. Each thread compiles in its current context,
+// so separate compilations can run one after another or side by side in one process
+class CompilationContext
+{
+public:
+    CompilationContext();
+    ~CompilationContext();
+
+    CompilationContext(const CompilationContext&) = delete;
+    CompilationContext& operator=(const CompilationContext&) = delete;
+
+    static CompilationContext& Current();
+
+    // Makes this the context of the calling thread until another one is made current or this one is destroyed
+    void makeCurrent();
+
+    symbol::IdentifierTable& getIdentifiers();
+    TypeContext& getTypes();
+
+    std::unordered_map<symbol::SymbolID, FunctionSymbol>& getGlobalFunctions();
+    std::unordered_map<symbol::SymbolID, GlobalSymbol>& getGlobalVariables();
+
+    // Values of enum fields and integer constexpr globals by mangled name, known before they are emitted
+    std::unordered_map<symbol::SymbolID, intmax_t>& getConstants();
+
+    // Functions declared constexpr by mangled name, which calls with constant arguments are evaluated at compile time
+    std::unordered_map<symbol::SymbolID, parser::Function*>& getConstexprFunctions();
+
+    // Function and method bodies defined in this module by mangled name, which calls can be emitted into
+    std::unordered_map<symbol::SymbolID, parser::InlineFunction*>& getInlineFunctions();
+
+private:
+    symbol::IdentifierTable mIdentifiers;
+    TypeContext mTypes;
+
+    std::unordered_map<symbol::SymbolID, FunctionSymbol> mGlobalFunctions;
+    std::unordered_map<symbol::SymbolID, GlobalSymbol> mGlobalVariables;
+    std::unordered_map<symbol::SymbolID, intmax_t> mConstants;
+    std::unordered_map<symbol::SymbolID, parser::Function*> mConstexprFunctions;
+    std::unordered_map<symbol::SymbolID, parser::InlineFunction*> mInlineFunctions;
+};
+
+#endif // VIPER_FRAMEWORK_SYMBOL_COMPILATION_CONTEXT_H
@@ -3,15 +3,62 @@
 #ifndef VIPER_FRAMEWORK_SYMBOL_IDENTIFIER_H
 #define VIPER_FRAMEWORK_SYMBOL_IDENTIFIER_H
 
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include "type/Type.h"
 
 namespace symbol
 {
-    void AddIdentifier(std::string mangledName, std::vector<std::string> names);
+    // Handle to an interned string. Used for single name segments as well as mangled names
+    using SymbolID = std::uint32_t;
 
-    std::vector<std::string> GetSymbol(std::vector<std::string> givenNames, std::vector<std::string> activeNames);
+    // Handle to an interned qualified path, e.g. std::io::print
+    using PathID = std::uint32_t;
+
+    constexpr SymbolID InvalidSymbol = UINT32_MAX;
+
+    class IdentifierTable
+    {
+    public:
+        SymbolID intern(std::string_view name);
+        SymbolID find(std::string_view name) const; // Returns InvalidSymbol if the name has never been interned
+        std::string_view getString(SymbolID id) const;
+        std::size_t size() const;
+
+        PathID internPath(const std::vector<std::string>& names);
+
+        void addIdentifier(std::string_view mangledName, const std::vector<std::string>& names);
+
+        std::vector<SymbolID> getSymbol(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames) const;
+
+    private:
+        struct PathHash
+        {
+            std::size_t operator()(const std::vector<SymbolID>& path) const;
+        };
+
+        std::deque<std::string> mStrings;
+        std::unordered_map<std::string_view, SymbolID> mStringIDs;
+
+        std::unordered_map<std::vector<SymbolID>, PathID, PathHash> mPaths;
+        std::vector<std::vector<SymbolID> > mIdentifiers; // Mangled names declared at each path
+        std::unordered_set<SymbolID> mDeclared;
+    };
+
+    // Shorthands for the identifier table of the current compilation
+    SymbolID Intern(std::string_view name);
+    SymbolID Find(std::string_view name);
+    std::string_view GetString(SymbolID id);
+
+    PathID InternPath(const std::vector<std::string>& names);
+
+    void AddIdentifier(std::string_view mangledName, const std::vector<std::string>& names);
+
+    std::vector<SymbolID> GetSymbol(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames);
 }
 
-#endif //VIPER_FRAMEWORK_SYMBOL_IDENTIFIER_H
\ No newline at end of file
+#endif //VIPER_FRAMEWORK_SYMBOL_IDENTIFIER_H
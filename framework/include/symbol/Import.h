@@ -1,13 +1,19 @@
 // Copyright 2024 solar-mist
 
-#ifndef VIPER_FRAMEWORK_SYMBOL_NAME_MANGLING_H
-#define VIPER_FRAMEWORK_SYMBOL_NAME_MANGLING_H
+#ifndef VIPER_FRAMEWORK_SYMBOL_IMPORT_H
+#define VIPER_FRAMEWORK_SYMBOL_IMPORT_H
 
 #include "parser/ast/Node.h"
 
+#include "lexer/SourceManager.h"
+
+#include "support/Arena.h"
+
 #include "diagnostic/Diagnostic.h"
 
 #include <filesystem>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace parser
@@ -17,18 +23,52 @@ namespace parser
 
 namespace symbol
 {
+    class ModuleCache;
+
     class ImportManager
     {
     public:
-        ImportManager();
+        ImportManager(lexing::SourceManager& sourceManager, support::Arena& arena);
+        ~ImportManager();
 
         void addSearchPath(std::string path);
+
+        // Write a .vpi interface next to each module that had to be parsed from source
+        void setEmitInterfaces(bool emitInterfaces);
+
+        // Share parsed modules with other compilations through moduleCache
+        void setModuleCache(ModuleCache* moduleCache);
+
+        // Each module is loaded once per compilation, from the module cache or its .vpi interface
+        // if there is an up-to-date one. Its declarations are returned to the first importer only, later
+        // imports of the same module just receive its symbols
         std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>> ImportSymbols(std::filesystem::path path, diagnostic::Diagnostics& diag);
 
+        // Returns the file an import of path refers to, or nullptr if there is none in the search paths
+        lexing::SourceBuffer* findModule(std::filesystem::path path);
+
+        // The files compiling source would import, found by lexing them without parsing anything.
+        // Like a compilation, only the imports an imported module exports are followed
+        std::vector<const lexing::SourceBuffer*> ScanDependencies(lexing::SourceBuffer& source, diagnostic::Diagnostics& diag);
+
+        // The files of every module loaded so far, in the order they were loaded
+        std::vector<std::filesystem::path> getModulePaths() const;
+
     private:
+        struct Module;
+
+        lexing::SourceManager& mSourceManager;
+        support::Arena& mArena;
         std::vector<std::string> mSearchPaths;
+        bool mEmitInterfaces;
+        ModuleCache* mModuleCache;
+
+        // Source buffers are unique per canonical path, so they identify a module
+        std::unordered_map<const lexing::SourceBuffer*, std::unique_ptr<Module> > mModules;
+        std::vector<const lexing::SourceBuffer*> mLoadOrder;
+        std::vector<const lexing::SourceBuffer*> mImportStack;
     };
 
 }
 
-#endif //VIPER_FRAMEWORK_SYMBOL_NAME_MANGLING_H
\ No newline at end of file
+#endif //VIPER_FRAMEWORK_SYMBOL_IMPORT_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SYMBOL_INCREMENTAL_CACHE_H
+#define VIPER_FRAMEWORK_SYMBOL_INCREMENTAL_CACHE_H 1
+
+#include "lexer/TokenStream.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace symbol
+{
+    // A hash of one compiled file's tokens and the text of every module it imports, stored next to
+    // its output as a .vpc file. When it hasn't changed since the output was written, the output is
+    // still valid and the file needn't be parsed or emitted again. Only the tokens are hashed, so
+    // edits to comments and whitespace don't count as changes
+    class IncrementalCache
+    {
+    public:
+        // importHashes are support::Hash of each imported module's text
+        IncrementalCache(const lexing::TokenStream& tokens, std::vector<std::uint64_t> importHashes, std::uint64_t optionsHash);
+
+        // True if the cache at cachePath was written for the same tokens and outputPath hasn't changed since
+        bool isUpToDate(const std::filesystem::path& cachePath, const std::filesystem::path& outputPath) const;
+
+        // Records the hashes for the output that was just written to outputPath
+        bool writeFile(const std::filesystem::path& cachePath, const std::filesystem::path& outputPath) const;
+
+    private:
+        std::uint64_t mOptionsHash;
+        std::uint64_t mSourceHash;
+
+        std::string serialize(std::uint64_t outputHash) const;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SYMBOL_INCREMENTAL_CACHE_H
@@ -0,0 +1,40 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SYMBOL_MODULE_CACHE_H
+#define VIPER_FRAMEWORK_SYMBOL_MODULE_CACHE_H 1
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace symbol
+{
+    // Interfaces of the modules parsed so far, shared by every compilation in the process.
+    // An interface doesn't refer to any compilation context, so a compilation that imports a
+    // module another one already parsed rebuilds the declarations in its own context from here.
+    // An interface only depends on the text of its module, so it is found by the hash of that text
+    class ModuleCache
+    {
+    public:
+        // Returns nullptr if no module with this text has been parsed yet
+        std::shared_ptr<const std::string> find(std::uint64_t sourceHash);
+
+        void insert(std::uint64_t sourceHash, std::string interface);
+
+        std::size_t size();
+
+        // The interfaces inserted after the first index ones, in the order they were inserted
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<const std::string>>> getInterfacesSince(std::size_t index);
+
+    private:
+        std::mutex mMutex;
+        std::unordered_map<std::uint64_t, std::shared_ptr<const std::string> > mInterfaces;
+        std::vector<std::uint64_t> mInsertionOrder;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SYMBOL_MODULE_CACHE_H
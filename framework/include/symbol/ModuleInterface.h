@@ -0,0 +1,73 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SYMBOL_MODULE_INTERFACE_H
+#define VIPER_FRAMEWORK_SYMBOL_MODULE_INTERFACE_H 1
+
+#include "parser/ast/Node.h"
+#include "parser/ast/global/Function.h"
+#include "parser/ast/global/StructDeclaration.h"
+#include "parser/ast/global/EnumDeclaration.h"
+
+#include "support/Arena.h"
+
+#include "diagnostic/Diagnostic.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace parser
+{
+    class GlobalSymbol;
+}
+
+namespace symbol
+{
+    class ImportManager;
+
+    // A precompiled module interface (.vpi) holds the declarations that importing a module
+    // produces, in the order the import parser produces them. It is only valid for the
+    // source text and compiler build it was written for
+    class InterfaceWriter
+    {
+    public:
+        void addFunction(const std::vector<parser::GlobalAttribute>& attributes, std::string_view name, Type* type, const std::vector<parser::FunctionArgument>& arguments, bool hasSymbol);
+        void beginNamespace(std::string_view name);
+        void endNamespace();
+        void addStruct(const std::vector<std::string>& names, const std::vector<parser::StructField>& fields, const std::vector<parser::StructMethod>& methods, bool exported);
+        void addGlobal(const std::vector<std::string>& names, Type* type);
+        void addConstexpr(const std::vector<std::string>& names, Type* type);
+        void addImport(const std::filesystem::path& path);
+        void addUsing(const std::vector<std::string>& names, Type* type);
+        void addAlias(const std::vector<std::string>& names, Type* type);
+        void addEnum(const std::vector<std::string>& names, const std::vector<parser::EnumField>& fields);
+
+        // The complete interface as it is stored in a .vpi file
+        std::string serialize(std::uint64_t sourceHash) const;
+
+        // Writes to a temporary file first so readers never see a partial interface
+        bool writeFile(const std::filesystem::path& path, std::uint64_t sourceHash) const;
+
+    private:
+        std::string mBuffer;
+
+        void writeU8(std::uint8_t value);
+        void writeU32(std::uint32_t value);
+        void writeString(std::string_view value);
+        void writeNames(const std::vector<std::string>& names);
+        void writeType(Type* type);
+        void writeArguments(const std::vector<parser::FunctionArgument>& arguments);
+    };
+
+    // Returns nothing if there is no interface at path or it is out of date
+    std::optional<std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>>> ReadModuleInterface(const std::filesystem::path& path, std::uint64_t sourceHash,
+        support::Arena& arena, ImportManager& importManager, diagnostic::Diagnostics& diag);
+
+    // Reads an interface that is already in memory, path is only used for diagnostics
+    std::optional<std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>>> ReadModuleInterface(std::string_view data, const std::filesystem::path& path,
+        std::uint64_t sourceHash, support::Arena& arena, ImportManager& importManager, diagnostic::Diagnostics& diag);
+}
+
+#endif // VIPER_FRAMEWORK_SYMBOL_MODULE_INTERFACE_H
@@ -0,0 +1,42 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_SYMBOL_OBJECT_CACHE_H
+#define VIPER_FRAMEWORK_SYMBOL_OBJECT_CACHE_H 1
+
+#include "lexer/SourceManager.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace symbol
+{
+    // Compiled outputs stored in a directory under a hash of everything that determines them: the
+    // compiler build, the options, and the text of the source and of every module it imports.
+    // Several compilers can share a directory, since entries are only ever added whole
+    class ObjectCache
+    {
+    public:
+        ObjectCache(std::filesystem::path directory);
+
+        // $XDG_CACHE_HOME/viper, or ~/.cache/viper without it
+        static std::filesystem::path DefaultDirectory();
+
+        // options must contain every option that changes the output, in the order it was given
+        std::string key(const lexing::SourceBuffer& source, const std::vector<const lexing::SourceBuffer*>& imports, std::string_view options) const;
+
+        // Copies the cached output for key to outputPath. Returns false on a miss
+        bool fetch(const std::string& key, const std::filesystem::path& outputPath) const;
+
+        // Adds the output that was just written to outputPath. Failing to is harmless, the file is just compiled again next time
+        bool store(const std::string& key, const std::filesystem::path& outputPath) const;
+
+    private:
+        std::filesystem::path mDirectory;
+
+        std::filesystem::path entryPath(const std::string& key) const;
+    };
+}
+
+#endif // VIPER_FRAMEWORK_SYMBOL_OBJECT_CACHE_H
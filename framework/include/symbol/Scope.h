@@ -7,20 +7,48 @@
 #include "type/StructType.h"
 #include "type/FunctionType.h"
 
+#include "symbol/Identifier.h"
+
+#include "support/Arena.h"
+
 #include <vipir/IR/Instruction/AllocaInst.h>
+#include <vipir/IR/Instruction/PhiInst.h>
+#include <vipir/IR/IRBuilder.h>
 #include <vipir/IR/Function.h>
 #include <vipir/IR/GlobalVar.h>
 
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 struct LocalSymbol
 {
     LocalSymbol() = default;
     LocalSymbol(vipir::AllocaInst* alloca, Type* type);
 
+    // Scalars are kept in SSA values instead of an alloca unless the parser saw something that needs their memory
+    bool canPromote() const;
+
     vipir::Value* alloca;
     Type* type;
+    bool needsAlloca{ false }; // Its address is taken, or it is declared or written inside a switch
+    vipir::Value* value{ nullptr }; // The current value of a promoted local where code is being emitted
+};
+
+// Control flowing from a block into a join, with the values the promoted locals had when it left
+struct SSAEdge
+{
+    vipir::BasicBlock* from;
+    std::vector<std::pair<LocalSymbol*, vipir::Value*> > values; // Innermost scope first, so phis come out in the same order every time
+};
+
+// Where the returns of a function body emitted in place of a call go
+struct InlineReturn
+{
+    vipir::BasicBlock* block{ nullptr }; // Made by the first return, the code after the call is emitted into it
+    std::vector<std::pair<vipir::Value*, vipir::BasicBlock*> > values;
 };
 
 struct FunctionSymbol
@@ -44,9 +72,7 @@ struct GlobalSymbol
     vipir::Value* global;
     Type* type;
 };
-extern std::unordered_map<std::string, FunctionSymbol> GlobalFunctions;
-extern std::unordered_map<std::string, GlobalSymbol> GlobalVariables;
-FunctionSymbol* FindFunction(std::vector<std::string> givenNames, std::vector<std::string> activeNames, std::vector<Type*> arguments);
+FunctionSymbol* FindFunction(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames, std::vector<Type*> arguments);
 
 struct Scope
 {
@@ -58,15 +84,48 @@ struct Scope
     vipir::BasicBlock* findBreakBB();
     vipir::BasicBlock* findContinueBB();
     StructType* findOwner();
+    InlineReturn* findInlineReturn();
     std::vector<std::string> getNamespaces();
 
+    // SSA construction for promoted locals. Joins are only ever reached from the structured statements around them,
+    // so each one collects the edges into it and gets a phi for every local that comes in with different values
+    SSAEdge getSSAEdge(vipir::IRBuilder& builder);
+    void restoreSSAEdge(const SSAEdge& edge);
+    void addSSAEdge(vipir::IRBuilder& builder, vipir::BasicBlock* to); // For breaks and continues, kept by the scope they leave to
+    std::vector<SSAEdge> takeSSAEdges(vipir::BasicBlock* to);
+    void branchWithSSAEdge(vipir::IRBuilder& builder, vipir::BasicBlock* to, std::vector<SSAEdge>& edges); // Only from a reachable block
+    void joinSSAEdges(vipir::IRBuilder& builder, const std::vector<SSAEdge>& edges);
+
+    // Loop headers are emitted before their back edges, so locals assigned in the loop get a phi up front that is completed after the body
+    std::vector<std::pair<LocalSymbol*, vipir::PhiInst*> > createLoopPhis(vipir::IRBuilder& builder, const SSAEdge& entry);
+    static void CompleteLoopPhis(const std::vector<std::pair<LocalSymbol*, vipir::PhiInst*> >& phis, const std::vector<SSAEdge>& backEdges);
+
+    // False once a return, break or continue has ended the insert point's block, or if nothing branches to it,
+    // like the join of an if whose branches all return. Statements there are still emitted but take no edges
+    bool isReachable(vipir::IRBuilder& builder);
+    void endUnreachable(vipir::IRBuilder& builder); // Terminates the block without making it a predecessor of anything
+
+    // Forgets the values the locals had where the scope was last emitted, since an inlined body is emitted again at each call
+    void clearSSAValues();
+
     Scope* parent;
     StructType* owner;
     Type* currentReturnType;
     vipir::BasicBlock* breakTo;
     vipir::BasicBlock* continueTo;
     std::string namespaceName;
+    InlineReturn* inlineReturn;
+
+    std::vector<LocalSymbol*> assignedLocals; // Locals written in the loop this scope belongs to
+    std::unordered_map<vipir::BasicBlock*, std::vector<SSAEdge> > ssaEdges;
+    std::unordered_set<vipir::BasicBlock*> unreachableBlocks; // Kept by the outermost scope, for every function in it
 };
-using ScopePtr = std::unique_ptr<Scope>;
+using ScopePtr = support::ArenaPtr<Scope>;
+
+namespace support
+{
+    template <>
+    inline constexpr MemoryReport::Owner ArenaOwner<::Scope> = MemoryReport::Owner::Scopes;
+}
 
 #endif // VIPER_FRAMEWORK_SYMBOL_SCOPE_H
\ No newline at end of file
@@ -11,6 +11,7 @@ public:
     ArrayType(Type* base, int count);
 
     Type* getBaseType() const;
+    int getCount() const;
 
     int getSize() const override;
     vipir::Type* getVipirType() const override;
@@ -23,6 +24,7 @@ public:
 private:
     Type* mBase;
     int mCount;
+    std::string mMangleID;
 };
 
 #endif // VIPER_FRAMEWORK_TYPE_ARRAY_TYPE_H
\ No newline at end of file
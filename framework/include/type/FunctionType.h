@@ -24,6 +24,7 @@ public:
 private:
     Type* mReturnType;
     std::vector<Type*> mArguments;
+    std::string mMangleID;
 };
 
 #endif // VIPER_FRAMEWORK_TYPE_FUNCTION_TYPE_H
\ No newline at end of file
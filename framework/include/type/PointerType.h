@@ -22,6 +22,7 @@ public:
 
 private:
     Type* mBase;
+    std::string mMangleID;
 };
 
 #endif // VIPER_FRAMEWORK_TYPE_POINTER_TYPE_H
\ No newline at end of file
@@ -33,13 +33,14 @@ public:
 
     bool isStructType() const override;
 
-    static StructType* Get(std::string names);
+    static StructType* Get(symbol::SymbolID mangledName);
     static StructType* Create(std::vector<std::string> names, std::vector<Field> fields);
     static void Erase(Type* type);
 
 private:
     std::vector<std::string> mNames;
     std::vector<Field> mFields;
+    std::string mMangleID;
 };
 
 #endif // VIPER_FRAMEWORK_TYPE_STRUCT_TYPE_H
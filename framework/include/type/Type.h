@@ -3,6 +3,8 @@
 #ifndef VIPER_FRAMEWORK_TYPE_TYPE_H
 #define VIPER_FRAMEWORK_TYPE_TYPE_H 1
 
+#include "symbol/Identifier.h"
+
 #include <vipir/Type/Type.h>
 
 #include <memory>
@@ -26,10 +28,10 @@ public:
     virtual bool isEnumType()     const { return false; }
     virtual bool isFunctionType() const { return false; }
 
-    static void Init();
-    static bool Exists(const std::string& name);
+    static bool Exists(std::string_view name);
     static void AddAlias(std::vector<std::string> names, Type* type);
-    static Type* Get(const std::string& name);
+    static Type* Get(std::string_view name);
+    static Type* Get(symbol::SymbolID mangledName);
 
     std::string_view getName() { return mName; }
 
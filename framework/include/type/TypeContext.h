@@ -0,0 +1,79 @@
+// Copyright 2024 solar-mist
+
+#ifndef VIPER_FRAMEWORK_TYPE_TYPE_CONTEXT_H
+#define VIPER_FRAMEWORK_TYPE_TYPE_CONTEXT_H 1
+
+#include "type/Type.h"
+#include "type/PointerType.h"
+#include "type/ArrayType.h"
+#include "type/FunctionType.h"
+#include "type/StructType.h"
+
+#include "symbol/Identifier.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Owns every type in a compilation. Structural types are hash-consed, so two
+// types are the same type if and only if they are the same pointer
+class TypeContext
+{
+public:
+    TypeContext(symbol::IdentifierTable& identifiers);
+
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+
+    // The types of the current compilation
+    static TypeContext& Current();
+
+    PointerType* getPointerType(Type* base);
+    ArrayType* getArrayType(Type* base, int count);
+    FunctionType* getFunctionType(Type* returnType, std::vector<Type*> arguments);
+
+    StructType* getStructType(std::vector<std::string> names, std::vector<StructType::Field> fields);
+    StructType* findStructType(symbol::SymbolID mangledName);
+    void eraseStructType(StructType* type);
+
+    // Builtin and enum types, looked up by name or mangled name
+    Type* addNamedType(symbol::SymbolID name, std::unique_ptr<Type> type);
+    void addAlias(symbol::SymbolID mangledName, Type* type);
+    Type* findNamedType(symbol::SymbolID name);
+
+    // The number of distinct types, not counting aliases
+    std::size_t size() const;
+
+private:
+    struct ArrayKey
+    {
+        Type* base;
+        int count;
+
+        bool operator==(const ArrayKey&) const = default;
+    };
+    struct ArrayKeyHash
+    {
+        std::size_t operator()(const ArrayKey& key) const;
+    };
+
+    // Return type followed by the argument types
+    struct FunctionKeyHash
+    {
+        std::size_t operator()(const std::vector<Type*>& key) const;
+    };
+
+    symbol::IdentifierTable& mIdentifiers;
+
+    std::unordered_map<Type*, std::unique_ptr<PointerType> > mPointerTypes;
+    std::unordered_map<ArrayKey, std::unique_ptr<ArrayType>, ArrayKeyHash> mArrayTypes;
+    std::unordered_map<std::vector<Type*>, std::unique_ptr<FunctionType>, FunctionKeyHash> mFunctionTypes;
+
+    std::unordered_map<symbol::PathID, std::unique_ptr<StructType> > mStructTypes;
+    std::unordered_map<symbol::SymbolID, StructType*> mStructTypesByMangleID;
+
+    std::unordered_map<symbol::SymbolID, std::unique_ptr<Type> > mNamedTypes;
+    std::unordered_map<symbol::SymbolID, Type*> mAliases;
+};
+
+#endif // VIPER_FRAMEWORK_TYPE_TYPE_CONTEXT_H
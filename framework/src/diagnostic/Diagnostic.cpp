@@ -7,10 +7,30 @@
 
 #include <format>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 namespace diagnostic
 {
+    // Compilations on different threads report through different Diagnostics, but must not interleave their output
+    static std::mutex outputMutex;
+
+    static std::string StripFormatting(std::string_view message)
+    {
+        std::string stripped;
+        for (std::size_t i = 0; i < message.size(); ++i)
+        {
+            if (message[i] == '\x1b')
+            {
+                i = message.find('m', i);
+                if (i == std::string_view::npos) break;
+                continue;
+            }
+            stripped += message[i];
+        }
+        return stripped;
+    }
+
     void Diagnostics::setImported(bool imported)
     {
         mImported = imported;
@@ -24,57 +44,104 @@ namespace diagnostic
     {
         mSender = sender;
     }
-    void Diagnostics::setText(std::string text)
+    void Diagnostics::setText(std::string_view text)
     {
         mText = text;
     }
 
+    void Diagnostics::setCollected(std::vector<Diagnostic>* collected)
+    {
+        mCollected = collected;
+    }
+
+    std::vector<Diagnostic>* Diagnostics::getCollected() const
+    {
+        return mCollected;
+    }
+
+    void Diagnostics::setExitOnError(bool exitOnError)
+    {
+        mExitOnError = exitOnError;
+    }
+
+    bool Diagnostics::getExitOnError() const
+    {
+        return mExitOnError;
+    }
+
 
     void Diagnostics::fatalError(std::string_view message)
     {
-        std::cerr << std::format("{}{}: {}fatal error: {}{}\n", fmt::bold, mSender, fmt::red, fmt::defaults, message);
+        if (mCollected)
+        {
+            mCollected->push_back({mFileName, 0, 0, StripFormatting(message), true});
+            throw CompileError(mCollected->back().message);
+        }
 
-        std::exit(EXIT_FAILURE);
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << std::format("{}{}: {}fatal error: {}{}\n", fmt::bold, mSender, fmt::red, fmt::defaults, message);
+        }
+
+        exitOrThrow(message);
     }
 
     void Diagnostics::compilerError(lexing::SourceLocation start, lexing::SourceLocation end, std::string_view message)
     {
+        if (mCollected)
+        {
+            mCollected->push_back({mFileName, start.position, end.position + 1, StripFormatting(message), true});
+            throw CompileError(mCollected->back().message);
+        }
+
         int lineStart = getLinePosition(start.line-1);
         int lineEnd = getLinePosition(end.line)-1;
 
         end.position += 1;
-        std::string before = mText.substr(lineStart, start.position - lineStart);
-        std::string error = mText.substr(start.position, end.position - start.position);
-        std::string after = mText.substr(end.position, lineEnd - end.position);
+        std::string before = std::string(mText.substr(lineStart, start.position - lineStart));
+        std::string error = std::string(mText.substr(start.position, end.position - start.position));
+        std::string after = std::string(mText.substr(end.position, lineEnd - end.position));
         std::string spacesBefore = std::string(std::to_string(start.line).length(), ' ');
         std::string spacesAfter = std::string(before.length(), ' ');
 
         std::string imported = mImported ? " in imported file" : "";
 
-        std::cerr << std::format("{}{}:{}:{} {}error{}: {}{}\n", fmt::bold, mFileName, start.line, start.column, fmt::red, imported, fmt::defaults, message);
-        std::cerr << std::format("    {} | {}{}{}{}{}{}\n", start.line, before, fmt::bold, fmt::red, error, fmt::defaults, after);
-        std::cerr << std::format("    {} | {}{}{}^{}{}\n", spacesBefore, spacesAfter, fmt::bold, fmt::red, std::string(error.length()-1, '~'), fmt::defaults);
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << std::format("{}{}:{}:{} {}error{}: {}{}\n", fmt::bold, mFileName, start.line, start.column, fmt::red, imported, fmt::defaults, message);
+            std::cerr << std::format("    {} | {}{}{}{}{}{}\n", start.line, before, fmt::bold, fmt::red, error, fmt::defaults, after);
+            std::cerr << std::format("    {} | {}{}{}^{}{}\n", spacesBefore, spacesAfter, fmt::bold, fmt::red, std::string(error.length()-1, '~'), fmt::defaults);
+        }
 
-        std::exit(EXIT_FAILURE);
+        exitOrThrow(message);
     }
 
     void Diagnostics::compilerWarning(lexing::SourceLocation start, lexing::SourceLocation end, std::string_view message)
     {
+        if (mCollected)
+        {
+            mCollected->push_back({mFileName, start.position, end.position + 1, StripFormatting(message), false});
+            return;
+        }
+
         int lineStart = getLinePosition(start.line-1);
         int lineEnd = getLinePosition(end.line)-1;
 
         end.position += 1;
-        std::string before = mText.substr(lineStart, start.position - lineStart);
-        std::string error = mText.substr(start.position, end.position - start.position);
-        std::string after = mText.substr(end.position, lineEnd - end.position);
+        std::string before = std::string(mText.substr(lineStart, start.position - lineStart));
+        std::string error = std::string(mText.substr(start.position, end.position - start.position));
+        std::string after = std::string(mText.substr(end.position, lineEnd - end.position));
         std::string spacesBefore = std::string(std::to_string(start.line).length(), ' ');
         std::string spacesAfter = std::string(before.length(), ' ');
 
         std::string imported = mImported ? " in imported file" : "";
 
-        std::cerr << std::format("{}{}:{}:{} {}warning{}: {}{}\n", fmt::bold, mFileName, start.line, start.column, fmt::yellow, imported, fmt::defaults, message);
-        std::cerr << std::format("    {} | {}{}{}{}{}{}\n", start.line, before, fmt::bold, fmt::yellow, error, fmt::defaults, after);
-        std::cerr << std::format("    {} | {}{}{}^{}{}\n", spacesBefore, spacesAfter, fmt::bold, fmt::yellow, std::string(error.length()-1, '~'), fmt::defaults);
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << std::format("{}{}:{}:{} {}warning{}: {}{}\n", fmt::bold, mFileName, start.line, start.column, fmt::yellow, imported, fmt::defaults, message);
+            std::cerr << std::format("    {} | {}{}{}{}{}{}\n", start.line, before, fmt::bold, fmt::yellow, error, fmt::defaults, after);
+            std::cerr << std::format("    {} | {}{}{}^{}{}\n", spacesBefore, spacesAfter, fmt::bold, fmt::yellow, std::string(error.length()-1, '~'), fmt::defaults);
+        }
     }
 
 
@@ -83,7 +150,7 @@ namespace diagnostic
         int line = 0;
         for (int i = 0; i < lineNumber; ++i)
         {
-            while(mText[line] != '\n')
+            while(line < mText.size() && mText[line] != '\n')
             {
                 ++line;
             }
@@ -91,4 +158,14 @@ namespace diagnostic
         }
         return line;
     }
+
+    void Diagnostics::exitOrThrow(std::string_view message)
+    {
+        if (!mExitOnError)
+        {
+            throw CompileError(StripFormatting(message));
+        }
+
+        std::exit(EXIT_FAILURE);
+    }
 }
\ No newline at end of file
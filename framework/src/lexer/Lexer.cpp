@@ -5,17 +5,27 @@
 
 #include "type/Type.h"
 
+#include "support/TimeReport.h"
+
 #include <format>
 #include <unordered_map>
 
 namespace lexing
 {
-    Lexer::Lexer(const std::string& text, diagnostic::Diagnostics& diag)
-        : mText(text)
+    Lexer::Lexer(SourceBuffer& source, diagnostic::Diagnostics& diag)
+        : mSource(source)
+        , mText(source.getText())
         , mDiag(diag)
         , mPosition(0)
     {
-        mText += '\n'; // Fixes peeking crash at EOF
+    }
+
+    Lexer::Lexer(SourceBuffer& source, diagnostic::Diagnostics& diag, int start, int end)
+        : mSource(source)
+        , mText(source.getText().substr(0, end))
+        , mDiag(diag)
+        , mPosition(start)
+    {
     }
 
     const std::unordered_map<std::string_view, TokenType> keywords = {
@@ -46,109 +56,122 @@ namespace lexing
         { "enum",       TokenType::EnumKeyword },
     };
 
-    std::vector<Token> Lexer::lex()
+    TokenStream Lexer::lex()
     {
-        std::vector<Token> tokens;
+        support::TimeReport::Phase phase("lexing");
+        support::MemoryReport::Owning owning(support::MemoryReport::Owner::Tokens);
+        TokenStream tokens(mSource);
 
-        while (mPosition < mText.length())
+        while (mPosition < static_cast<int>(mText.length()))
         {
-            std::optional<Token> token = nextToken();
-            if(token.has_value())
-                tokens.push_back(*token);
+            nextToken(tokens);
             consume();
         }
 
+        if (support::TimeReport* report = support::TimeReport::Current())
+        {
+            report->getCounters().tokens += tokens.size();
+        }
+
         return tokens;
     }
 
+    // The source is mapped directly, so reads past the end behave as if the text
+    // had a trailing newline instead of running off the buffer
+    static inline char CharAt(std::string_view text, int position)
+    {
+        if (position < static_cast<int>(text.size())) return text[position];
+        return position == static_cast<int>(text.size()) ? '\n' : '\0';
+    }
+
     char Lexer::current()
     {
-        return mText[mPosition];
+        return CharAt(mText, mPosition);
     }
 
     char Lexer::consume()
     {
-        mColumn++;
-        if (mText[mPosition + 1] == '\n')
-        {
-            mColumn = 0;
-            mLine++;
-        }
-        return mText[mPosition++];
+        return CharAt(mText, mPosition++);
     }
 
     char Lexer::peek(int offset)
     {
-        return mText[mPosition + offset];
+        return CharAt(mText, mPosition + offset);
+    }
+
+    SourceLocation Lexer::location(int position)
+    {
+        return mSource.getLocation(position);
     }
 
-    SourceLocation Lexer::location()
+    std::string_view Lexer::textFrom(int start)
     {
-        return {mColumn, mLine, mPosition};
+        return mText.substr(start, mPosition - start + 1);
     }
 
-    std::optional<Token> Lexer::nextToken()
+    void Lexer::nextToken(TokenStream& tokens)
     {
-        SourceLocation start = location();
+        int start = mPosition;
 
         if (std::isalpha(current()) || current() == '_') // Identifier
         {
-            std::string text = std::string(1, current());
-
             while (std::isalnum(peek(1)) || peek(1) == '_')
             {
                 consume();
-                text += current();
             }
+            std::string_view text = textFrom(start);
 
-            if (keywords.find(text) != keywords.end())
+            auto keyword = keywords.find(text);
+            if (keyword != keywords.end())
             {
-                return Token(keywords.at(text), start, location());
+                return tokens.add(keyword->second, start, mPosition);
             }
 
             if (Type::Exists(text))
             {
-                return Token(TokenType::Type, std::move(text), start, location());
+                return tokens.add(TokenType::Type, start, mPosition);
             }
 
             if (text.length() >= 2 && text[0] == '_' && std::isupper(text[1]))
             {
-                mDiag.compilerError(start, location(), std::format("Identifier '{}{}{}' contains a reserved sequence '{}{}{}'",
+                mDiag.compilerError(location(start), location(mPosition), std::format("Identifier '{}{}{}' contains a reserved sequence '{}{}{}'",
                     fmt::bold, text, fmt::defaults, fmt::bold, text.substr(0,2), fmt::defaults));
             }
 
-            return Token(TokenType::Identifier, std::move(text), start, location());
+            return tokens.add(TokenType::Identifier, start, mPosition);
         }
 
         if (std::isdigit(current()))
         {
-            std::string text = std::string(1, current());
+            bool hasDigitSep = false;
+            auto skipDigitSep = [this, &hasDigitSep]() {
+                if (isDigitSep(peek(1)))
+                {
+                    consume();
+                    hasDigitSep = true;
+                }
+            };
+
             if (current() == '0')
             {
                 if (peek(1) == 'x') // hex
                 {
                     consume();
-                    text += current();
 
                     while (std::isxdigit(peek(1)))
                     {
                         consume();
-                        text += current();
-                        if (isDigitSep(peek(1)))
-                            consume();
+                        skipDigitSep();
                     }
                 }
                 else if (peek(1) == 'b') // binary
                 {
                     consume();
-                    text += current();
 
                     while (peek(1) == '0' || peek(1) == '1')
                     {
                         consume();
-                        text += current();
-                        if (isDigitSep(peek(1)))
-                            consume();
+                        skipDigitSep();
                     }
                 }
                 else // octal
@@ -156,119 +179,124 @@ namespace lexing
                     while (peek(1) >= '0' && peek(1) <= '7')
                     {
                         consume();
-                        text += current();
-                        if (isDigitSep(peek(1)))
-                            consume();
+                        skipDigitSep();
                     }
                 }
             }
             else // decimal
             {
-                if (isDigitSep(peek(1)))
-                    consume();
+                skipDigitSep();
                 while (std::isdigit(peek(1)))
                 {
                     consume();
-                    text += current();
-                    if (isDigitSep(peek(1)))
-                        consume();
+                    skipDigitSep();
+                }
+            }
+
+            if (hasDigitSep) // Separators aren't part of the value, so the digits can't be sliced from the source
+            {
+                std::string digits;
+                for (char c : textFrom(start))
+                {
+                    if (!isDigitSep(c)) digits += c;
                 }
+                return tokens.add(TokenType::IntegerLiteral, start, mPosition, mSource.addText(std::move(digits)));
             }
-            return Token(TokenType::IntegerLiteral, std::move(text), start, location());
+            return tokens.add(TokenType::IntegerLiteral, start, mPosition);
         }
         
         if (std::isspace(current())) // Newline, tab, space etc
         {
-            return std::nullopt;
+            return;
         }
 
         switch(current())
         {
             case '(':
-                return Token(TokenType::LeftParen, start, location());
+                return tokens.add(TokenType::LeftParen, start, mPosition);
             case ')':
-                return Token(TokenType::RightParen, start, location());
+                return tokens.add(TokenType::RightParen, start, mPosition);
 
             case '{':
-                return Token(TokenType::LeftBracket, start, location());
+                return tokens.add(TokenType::LeftBracket, start, mPosition);
             case '}':
-                return Token(TokenType::RightBracket, start, location());
+                return tokens.add(TokenType::RightBracket, start, mPosition);
 
             case '[':
                 if (peek(1) == '[')
                 {
                     consume();
-                    return Token(TokenType::DoubleLeftSquareBracket, start, location());
+                    return tokens.add(TokenType::DoubleLeftSquareBracket, start, mPosition);
                 }
-                return Token(TokenType::LeftSquareBracket, start, location());
+                return tokens.add(TokenType::LeftSquareBracket, start, mPosition);
             case ']':
                 if (peek(1) == ']')
                 {
                     consume();
-                    return Token(TokenType::DoubleRightSquareBracket, start, location());
+                    return tokens.add(TokenType::DoubleRightSquareBracket, start, mPosition);
                 }
-                return Token(TokenType::RightSquareBracket, start, location());
+                return tokens.add(TokenType::RightSquareBracket, start, mPosition);
 
             case ';':
-                return Token(TokenType::Semicolon, start, location());
+                return tokens.add(TokenType::Semicolon, start, mPosition);
             case ':':
                 if (peek(1) == ':')
                 {
                     consume();
-                    return Token(TokenType::DoubleColon, start, location());
+                    return tokens.add(TokenType::DoubleColon, start, mPosition);
                 }
-                return Token(TokenType::Colon, start, location());
+                return tokens.add(TokenType::Colon, start, mPosition);
             case ',':
-                return Token(TokenType::Comma, start, location());
+                return tokens.add(TokenType::Comma, start, mPosition);
             case '.':
-                return Token(TokenType::Dot, start, location());
+                return tokens.add(TokenType::Dot, start, mPosition);
 
             case '@':
-                return Token(TokenType::Asperand, start, location());
+                return tokens.add(TokenType::Asperand, start, mPosition);
 
             case '=':
                 if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::DoubleEquals, start, location());
+                    return tokens.add(TokenType::DoubleEquals, start, mPosition);
                 }
-                return Token(TokenType::Equals, start, location());
+                return tokens.add(TokenType::Equals, start, mPosition);
             
             case '+':
                 if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::PlusEquals, start, location());
+                    return tokens.add(TokenType::PlusEquals, start, mPosition);
                 }
                 else if (peek(1) == '+')
                 {
                     consume();
-                    return Token(TokenType::DoublePlus, start, location());
+                    return tokens.add(TokenType::DoublePlus, start, mPosition);
                 }
-                return Token(TokenType::Plus, start, location());
+                return tokens.add(TokenType::Plus, start, mPosition);
             case '-':
                 if (peek(1) == '>')
                 {
                     consume();
-                    return Token(TokenType::RightArrow, start, location());
+                    return tokens.add(TokenType::RightArrow, start, mPosition);
                 }
                 else if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::MinusEquals, start, location());
+                    return tokens.add(TokenType::MinusEquals, start, mPosition);
                 }
                 else if (peek(1) == '-')
                 {
                     consume();
-                    return Token(TokenType::DoubleMinus, start, location());
+                    return tokens.add(TokenType::DoubleMinus, start, mPosition);
                 }
-                return Token(TokenType::Minus, start, location());
+                return tokens.add(TokenType::Minus, start, mPosition);
 
             case '!':
                 if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::BangEquals, start, location());
+                    return tokens.add(TokenType::BangEquals, start, mPosition);
                 }
                 break;
 
@@ -276,56 +304,76 @@ namespace lexing
                 if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::LessEqual, start, location());
+                    return tokens.add(TokenType::LessEqual, start, mPosition);
                 }
-                return Token(TokenType::LessThan, start, location());
+                return tokens.add(TokenType::LessThan, start, mPosition);
             case '>':
                 if (peek(1) == '=')
                 {
                     consume();
-                    return Token(TokenType::GreaterEqual, start, location());
+                    return tokens.add(TokenType::GreaterEqual, start, mPosition);
                 }
-                return Token(TokenType::GreaterThan, start, location());
+                return tokens.add(TokenType::GreaterThan, start, mPosition);
 
             case '|':
-                return Token(TokenType::Pipe, start, location());
+                return tokens.add(TokenType::Pipe, start, mPosition);
             case '&':
-                return Token(TokenType::Ampersand, start, location());
+                return tokens.add(TokenType::Ampersand, start, mPosition);
             case '^':
-                return Token(TokenType::Caret, start, location());
+                return tokens.add(TokenType::Caret, start, mPosition);
             case '~':
-                return Token(TokenType::Tilde, start, location());
+                return tokens.add(TokenType::Tilde, start, mPosition);
             case '*':
-                return Token(TokenType::Star, start, location());
+                return tokens.add(TokenType::Star, start, mPosition);
             case '/':
                 if (peek(1) == '/')
                 {
                     while (current() != '\n')
                         consume();
-                    return std::nullopt;
+                    return;
                 }
                 else if (peek(1) == '*')
                 {
                     consume();
                     consume();
-                    while (current() != '*' && peek(1) != '/')
+                    while (!(current() == '*' && peek(1) == '/'))
+                    {
+                        if (mPosition >= static_cast<int>(mText.size()))
+                        {
+                            mDiag.compilerError(location(start), location(start + 1), "unterminated comment");
+                        }
                         consume();
+                    }
                     consume();
-                    return std::nullopt;
+                    return;
                 }
 
-                return Token(lexing::TokenType::Slash, start, location());
+                return tokens.add(TokenType::Slash, start, mPosition);
 
             case '"':
             {
                 consume();
+                int valueStart = mPosition;
+
+                // Only strings containing escape sequences need their own copy of the text
+                bool escaped = false;
                 std::string value;
                 while(current() != '"')
                 {
+                    if (mPosition >= static_cast<int>(mText.size()))
+                    {
+                        mDiag.compilerError(location(start), location(start), "unterminated string literal");
+                    }
+
                     switch(current())
                     {
                         case '\\':
                         {
+                            if (!escaped)
+                            {
+                                value = mText.substr(valueStart, mPosition - valueStart);
+                                escaped = true;
+                            }
                             consume();
                             switch(current())
                             {
@@ -346,21 +394,27 @@ namespace lexing
                                     break;
                                 default:
                                 {
-                                    mDiag.compilerError(start, location(), std::format("Unknown escape sequence '{}\\{}{}' in string",
+                                    mDiag.compilerError(location(start), location(mPosition), std::format("Unknown escape sequence '{}\\{}{}' in string",
                                         fmt::bold, current(), fmt::defaults));
                                 }
                             }
                             break;
                         }
                         default:
-                            value += current();
+                            if (escaped)
+                                value += current();
                     }
                     consume();
                 }
-                return Token(TokenType::StringLiteral, value, start, location());
+
+                if (escaped)
+                {
+                    return tokens.add(TokenType::StringLiteral, start, mPosition, mSource.addText(std::move(value)));
+                }
+                return tokens.add(TokenType::StringLiteral, start, mPosition);
             }
         }
 
-        return Token(TokenType::Error, std::string(1, current()), start, location()); // Unknown character
+        return tokens.add(TokenType::Error, start, mPosition); // Unknown character
     }
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+// Copyright 2024 solar-mist
+
+
+#include "lexer/SourceManager.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lexing
+{
+    SourceBuffer::SourceBuffer(std::filesystem::path path, std::string text)
+        : mPath(std::move(path))
+        , mMapped(false)
+        , mOwnedText(std::move(text))
+    {
+        mData = mOwnedText.data();
+        mSize = mOwnedText.size();
+    }
+
+    SourceBuffer::SourceBuffer(std::filesystem::path path, const char* data, std::size_t size)
+        : mPath(std::move(path))
+        , mData(data)
+        , mSize(size)
+        , mMapped(true)
+    {
+    }
+
+    SourceBuffer::~SourceBuffer()
+    {
+        if (mMapped && mSize != 0)
+        {
+            munmap(const_cast<char*>(mData), mSize);
+        }
+    }
+
+    const std::filesystem::path& SourceBuffer::getPath() const
+    {
+        return mPath;
+    }
+
+    std::string_view SourceBuffer::getText() const
+    {
+        return std::string_view(mData, mSize);
+    }
+
+    std::string_view SourceBuffer::addText(std::string text)
+    {
+        std::lock_guard<std::mutex> lock(mAddedTextMutex);
+        return mAddedText.emplace_back(std::move(text));
+    }
+
+    SourceLocation SourceBuffer::getLocation(std::uint32_t position) const
+    {
+        std::call_once(mLineTableBuilt, [this]() {
+            // A newline at the very start of the file has never counted towards the line number
+            for (std::uint32_t i = 1; i < mSize; ++i)
+            {
+                if (mData[i] == '\n') mNewlines.push_back(i);
+            }
+            mNewlines.push_back(mSize); // Reads past the end see a trailing newline
+        });
+
+        auto it = std::upper_bound(mNewlines.begin(), mNewlines.end(), position);
+        int line = (it - mNewlines.begin()) + 1;
+        int lastNewline = it == mNewlines.begin() ? -1 : *(it - 1);
+
+        return {static_cast<int>(position) - lastNewline, line, static_cast<int>(position)};
+    }
+
+
+    SourceBuffer* SourceManager::open(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::canonical(path, ec);
+        if (ec)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mFiles.find(canonical.string());
+        if (it != mFiles.end())
+        {
+            return it->second.get();
+        }
+
+        int fd = ::open(canonical.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        std::size_t size = st.st_size;
+        const char* data = nullptr;
+        if (size != 0) // mmap rejects empty mappings
+        {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                close(fd);
+                return nullptr;
+            }
+            data = static_cast<const char*>(mapping);
+        }
+        close(fd);
+
+        auto buffer = std::make_unique<SourceBuffer>(path, data, size);
+        SourceBuffer* ret = buffer.get();
+        mFiles[canonical.string()] = std::move(buffer);
+
+        return ret;
+    }
+
+    SourceBuffer* SourceManager::addBuffer(std::filesystem::path path, std::string text)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mBuffers.emplace_back(std::make_unique<SourceBuffer>(std::move(path), std::move(text))).get();
+    }
+}
\ No newline at end of file
@@ -1,25 +1,22 @@
 // Copyright 2024 solar-mist
 
 #include "lexer/Token.h"
+#include "lexer/TokenStream.h"
 
 #include <sstream>
 #include <format>
 
 namespace lexing
 {
-    Token::Token(const TokenType tokenType, std::string text, SourceLocation start, SourceLocation end)
-        : mTokenType(tokenType)
-        , mText(std::move(text))
-        , mStart(start)
-        , mEnd(end)
+    Token::Token(const TokenStream* stream, std::uint32_t index)
+        : mTokenType(stream->getTokenType(index))
+        , mStream(stream)
+        , mIndex(index)
     {
     }
 
-    Token::Token(const TokenType tokenType, SourceLocation start, SourceLocation end)
+    Token::Token(const TokenType tokenType)
         : mTokenType(tokenType)
-        , mText("")
-        , mStart(start)
-        , mEnd(end)
     {
     }
 
@@ -159,22 +156,25 @@ namespace lexing
             case TokenType::EnumKeyword:
                 return "enum";
             case TokenType::Error:
-                return mText;
+                return std::string(getText());
         }
     }
 
-    const std::string& Token::getText() const
+    std::string_view Token::getText() const
     {
-        return mText;
+        if (!mStream) return {};
+        return mStream->getText(mIndex);
     }
 
-    SourceLocation Token::getStart()
+    SourceLocation Token::getStart() const
     {
-        return mStart;
+        if (!mStream) return {0, 0, 0};
+        return mStream->getStart(mIndex);
     }
-    SourceLocation Token::getEnd()
+    SourceLocation Token::getEnd() const
     {
-        return mEnd;
+        if (!mStream) return {0, 0, 0};
+        return mStream->getEnd(mIndex);
     }
 
     static inline const char* TypeToString(TokenType tokenType)
@@ -256,11 +256,11 @@ namespace lexing
 
     std::string Token::toString() const
     {
-        return std::format("{}({})", TypeToString(mTokenType), mText);
+        return std::format("{}({})", TypeToString(mTokenType), getText());
     }
 
     bool Token::operator==(Token other)
     {
-        return ((mText == other.mText) && (mTokenType == other.mTokenType));
+        return ((getText() == other.getText()) && (mTokenType == other.mTokenType));
     }
 }
\ No newline at end of file
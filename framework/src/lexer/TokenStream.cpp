@@ -0,0 +1,81 @@
+// Copyright 2024 solar-mist
+
+
+#include "lexer/TokenStream.h"
+
+#include <stdexcept>
+
+namespace lexing
+{
+    TokenStream::TokenStream(const SourceBuffer& source)
+        : mSource(source)
+    {
+    }
+
+    void TokenStream::add(TokenType tokenType, std::uint32_t start, std::uint32_t end)
+    {
+        mTokenTypes.push_back(tokenType);
+        mStarts.push_back(start);
+        mEnds.push_back(end);
+    }
+
+    void TokenStream::add(TokenType tokenType, std::uint32_t start, std::uint32_t end, std::string_view text)
+    {
+        mText[mTokenTypes.size()] = text;
+        add(tokenType, start, end);
+    }
+
+    std::size_t TokenStream::size() const
+    {
+        return mTokenTypes.size();
+    }
+
+    Token TokenStream::at(std::size_t index) const
+    {
+        if (index >= size())
+        {
+            throw std::out_of_range("TokenStream::at");
+        }
+        return Token(this, index);
+    }
+
+    TokenType TokenStream::getTokenType(std::size_t index) const
+    {
+        return mTokenTypes[index];
+    }
+
+    std::string_view TokenStream::getText(std::size_t index) const
+    {
+        TokenType tokenType = mTokenTypes[index];
+        std::uint32_t start = mStarts[index];
+        std::uint32_t end = mEnds[index];
+
+        if (tokenType == TokenType::IntegerLiteral || tokenType == TokenType::StringLiteral)
+        {
+            auto it = mText.find(index);
+            if (it != mText.end()) return it->second;
+        }
+
+        if (tokenType == TokenType::StringLiteral) // Strip the quotes
+        {
+            return mSource.getText().substr(start + 1, end - start - 1);
+        }
+
+        return mSource.getText().substr(start, end - start + 1);
+    }
+
+    SourceLocation TokenStream::getStart(std::size_t index) const
+    {
+        return mSource.getLocation(mStarts[index]);
+    }
+
+    SourceLocation TokenStream::getEnd(std::size_t index) const
+    {
+        return mSource.getLocation(mEnds[index]);
+    }
+
+    const SourceBuffer& TokenStream::getSource() const
+    {
+        return mSource;
+    }
+}
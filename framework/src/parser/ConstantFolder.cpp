@@ -0,0 +1,138 @@
+// Copyright 2024 solar-mist
+
+
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
+
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ast/expression/BooleanLiteral.h"
+#include "parser/ast/expression/ArrayInitializer.h"
+#include "parser/ast/expression/StructInitializer.h"
+
+#include "type/IntegerType.h"
+
+namespace parser
+{
+    ConstantFolder::ConstantFolder(support::Arena& arena, diagnostic::Diagnostics& diag)
+        : mArena(arena)
+        , mDiag(diag)
+    {
+    }
+
+    diagnostic::Diagnostics& ConstantFolder::getDiagnostics()
+    {
+        return mDiag;
+    }
+
+    void ConstantFolder::fold(ASTNodePtr& node, Scope* scope)
+    {
+        if (!node) return;
+
+        if (ASTNodePtr literal = node->fold(*this, scope))
+        {
+            node = std::move(literal);
+        }
+    }
+
+    ASTNodePtr ConstantFolder::makeInteger(intmax_t value, Type* type, lexing::Token token)
+    {
+        return mArena.make<IntegerLiteral>(Wrap(value, type), type, std::move(token));
+    }
+
+    ASTNodePtr ConstantFolder::makeBoolean(bool value, lexing::Token token)
+    {
+        return mArena.make<BooleanLiteral>(value, std::move(token));
+    }
+
+    ASTNodePtr ConstantFolder::materialize(const ConstexprValue& value, lexing::Token token)
+    {
+        Type* type = value.type;
+        if (type->isIntegerType() || type->isEnumType())
+        {
+            return makeInteger(value.integer, type, std::move(token));
+        }
+        if (type->isBooleanType())
+        {
+            return makeBoolean(value.integer != 0, std::move(token));
+        }
+        if (!type->isArrayType() && !type->isStructType())
+        {
+            return nullptr;
+        }
+
+        // Tables built by a constexpr call become initializers, which emit as a single constant
+        std::vector<ASTNodePtr> body;
+        for (auto& element : value.elements)
+        {
+            ASTNodePtr node = materialize(element, token);
+            if (!node) return nullptr;
+
+            body.push_back(std::move(node));
+        }
+
+        if (type->isStructType())
+        {
+            return mArena.make<StructInitializer>(type, std::move(body), std::move(token));
+        }
+        if (body.empty())
+        {
+            return nullptr; // An empty initializer has no element type to give the array
+        }
+        return mArena.make<ArrayInitializer>(std::move(body), std::move(token));
+    }
+
+    void ConstantFolder::addLocal(Scope* scope, const std::string& name, intmax_t value)
+    {
+        mLocals[scope][name] = value;
+    }
+
+    std::optional<intmax_t> ConstantFolder::findLocal(Scope* scope, const std::string& name)
+    {
+        // The innermost local with this name shadows any constexpr further out, whether or not it is one itself
+        for (; scope; scope = scope->parent)
+        {
+            if (!scope->locals.contains(name)) continue;
+
+            auto it = mLocals.find(scope);
+            if (it == mLocals.end()) return std::nullopt;
+
+            auto local = it->second.find(name);
+            if (local == it->second.end()) return std::nullopt;
+
+            return local->second;
+        }
+        return std::nullopt;
+    }
+
+    intmax_t ConstantFolder::Wrap(intmax_t value, Type* type)
+    {
+        if (!type || !type->isIntegerType()) return value;
+
+        int bits = type->getSize();
+        if (bits >= 64) return value;
+
+        uintmax_t mask = (uintmax_t(1) << bits) - 1;
+        uintmax_t bitsValue = uintmax_t(value) & mask;
+        if (IsSigned(type) && (bitsValue >> (bits - 1)))
+        {
+            bitsValue |= ~mask;
+        }
+        return intmax_t(bitsValue);
+    }
+
+    intmax_t ConstantFolder::MinValue(Type* type)
+    {
+        if (!type || !type->isIntegerType() || type->getSize() >= 64) return INTMAX_MIN;
+
+        return -(intmax_t(1) << (type->getSize() - 1));
+    }
+
+    bool ConstantFolder::IsSigned(Type* type)
+    {
+        if (type && type->isIntegerType())
+        {
+            return static_cast<IntegerType*>(type)->isSigned();
+        }
+        return true; // Enum values are plain ints
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright 2024 solar-mist
+
+
+#include "parser/DeclarationIndex.h"
+
+namespace parser
+{
+    void DeclarationIndex::addFunction(int position, FunctionSignature signature)
+    {
+        mFunctions[position] = std::move(signature);
+    }
+
+    void DeclarationIndex::addStruct(int position, StructSignature signature)
+    {
+        mStructs[position] = std::move(signature);
+    }
+
+    void DeclarationIndex::addGlobal(int position, GlobalSignature signature)
+    {
+        mGlobals[position] = std::move(signature);
+    }
+
+    void DeclarationIndex::addComplete(int position, int endPosition)
+    {
+        mComplete[position] = endPosition;
+    }
+
+    const FunctionSignature& DeclarationIndex::getFunction(int position) const
+    {
+        return mFunctions.at(position);
+    }
+
+    const StructSignature& DeclarationIndex::getStruct(int position) const
+    {
+        return mStructs.at(position);
+    }
+
+    const GlobalSignature& DeclarationIndex::getGlobal(int position) const
+    {
+        return mGlobals.at(position);
+    }
+
+    int DeclarationIndex::getCompleteEnd(int position) const
+    {
+        auto it = mComplete.find(position);
+        if (it == mComplete.end()) return -1;
+
+        return it->second;
+    }
+}
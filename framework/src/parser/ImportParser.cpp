@@ -19,9 +19,10 @@
 
 namespace parser
 {
-    ImportParser::ImportParser(std::vector<lexing::Token>& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, bool hoistingParser)
+    ImportParser::ImportParser(const lexing::TokenStream& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, support::Arena& arena, bool hoistingParser)
         : mTokens(tokens)
         , mImportManager(importManager)
+        , mArena(arena)
         , mPosition(0)
         , mScope(nullptr)
         , mDiag(diag)
@@ -48,7 +49,7 @@ namespace parser
     {
         if (current().getTokenType() != tokenType)
         {
-            lexing::Token temp(tokenType, {0, 0}, {0, 0});
+            lexing::Token temp(tokenType);
             mDiag.compilerError(current().getStart(), current().getEnd(), std::format("expected '{}{}{}' before '{}{}{}' token",
                 fmt::bold, temp.getId(), fmt::defaults, fmt::bold, current().getId(), fmt::defaults));
         }
@@ -62,7 +63,7 @@ namespace parser
             if (current().getTokenType() == tokenType)
                 return;
 
-            lexing::Token temp(tokenType, {0, 0}, {0, 0});
+            lexing::Token temp(tokenType);
             tokensString += std::format("'{}{}{}', ", fmt::bold, temp.getId(), fmt::defaults);
         }
 
@@ -97,6 +98,16 @@ namespace parser
         return mSymbols;
     }
 
+    DeclarationIndex& ImportParser::getDeclarations()
+    {
+        return mDeclarations;
+    }
+
+    const symbol::InterfaceWriter& ImportParser::getInterface() const
+    {
+        return mInterface;
+    }
+
     ASTNodePtr ImportParser::parseGlobal(std::vector<ASTNodePtr>& nodes)
     {
         std::vector<GlobalAttribute> attributes;
@@ -121,6 +132,11 @@ namespace parser
             case lexing::TokenType::GlobalKeyword:
                 return parseGlobalDeclaration(exported);
             case lexing::TokenType::ConstexprKeyword:
+                if (peek(1).getTokenType() == lexing::TokenType::FuncKeyword) // Only the module defining a constexpr function evaluates calls to it
+                {
+                    consume();
+                    return parseFunction(exported, attributes);
+                }
                 return parseConstExpr(exported);
             case lexing::TokenType::ImportKeyword:
             {
@@ -137,7 +153,11 @@ namespace parser
                     consume();
                     StructDeclarationPtr structDecl = parseStructDeclaration(exported);
                     if (exported)
+                    {
                         Type::AddAlias(structDecl->getNames(), structDecl->getType());
+                        if (!mHoistingParser)
+                            mInterface.addAlias(structDecl->getNames(), structDecl->getType());
+                    }
                     return structDecl;
                 }
                 return parseUsingDeclaration(exported);
@@ -159,15 +179,15 @@ namespace parser
             expectToken(lexing::TokenType::Identifier);
             while (current().getTokenType() == lexing::TokenType::Identifier)
             {
-                names.push_back(consume().getText());
+                names.emplace_back(consume().getText());
                 if (peek(1).getTokenType() == lexing::TokenType::Identifier)
                 {
                     expectToken(lexing::TokenType::DoubleColon);
                     consume();
                 }
             }
-            std::vector<std::string> types = symbol::GetSymbol(names, mNamespaces);
-            for (auto& name : types)
+            std::vector<symbol::SymbolID> types = symbol::GetSymbol(names, mNamespaces);
+            for (auto name : types)
             {
                 type = StructType::Get(name);
                 if (type) break;
@@ -182,13 +202,13 @@ namespace parser
             std::vector<std::string> names;
             if (current().getTokenType() == lexing::TokenType::Type)
             {
-                names.push_back(consume().getText());
+                names.emplace_back(consume().getText());
             }
             else
             {
                 while (current().getTokenType() == lexing::TokenType::Identifier)
                 {
-                    names.push_back(consume().getText());
+                    names.emplace_back(consume().getText());
                     if (peek(1).getTokenType() == lexing::TokenType::Identifier)
                     {
                         expectToken(lexing::TokenType::DoubleColon);
@@ -197,10 +217,10 @@ namespace parser
                 }
             }
 
-            std::vector<std::string> types = symbol::GetSymbol(names, mNamespaces);
+            std::vector<symbol::SymbolID> types = symbol::GetSymbol(names, mNamespaces);
 
             lexing::Token token = peek(-1);
-            for (auto& name : types)
+            for (auto name : types)
             {
                 type = Type::Get(name);
                 if (type) break;
@@ -225,7 +245,7 @@ namespace parser
             {
                 consume();
                 expectToken(lexing::TokenType::IntegerLiteral);
-                int count = std::stoi(consume().getText(), 0, 0);
+                int count = std::stoi(std::string(consume().getText()), 0, 0);
                 expectToken(lexing::TokenType::RightSquareBracket);
                 consume();
                 type = ArrayType::Create(type, count);
@@ -237,13 +257,14 @@ namespace parser
 
     FunctionPtr ImportParser::parseFunction(bool exported, std::vector<GlobalAttribute> attributes)
     {
+        int position = mPosition;
         consume();
 
         expectToken(lexing::TokenType::Asperand);
         consume();
 
         expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
 
         expectToken(lexing::TokenType::LeftParen);
         consume();
@@ -253,7 +274,7 @@ namespace parser
         while (current().getTokenType() != lexing::TokenType::RightParen)
         {
             expectToken(lexing::TokenType::Identifier);
-            std::string name = consume().getText();
+            std::string name = std::string(consume().getText());
 
             expectToken(lexing::TokenType::Colon);
             consume();
@@ -283,11 +304,18 @@ namespace parser
         }
         Type* type = FunctionType::Create(returnType, std::move(argumentTypes));
 
+        if (mHoistingParser)
+            mDeclarations.addFunction(position, {false, name, type, arguments, mPosition});
+
         if (current().getTokenType() == lexing::TokenType::Semicolon) // Extern function declaration
         {
             consume();
             if (exported)
-                return std::make_unique<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
+            {
+                if (!mHoistingParser)
+                    mInterface.addFunction(attributes, name, type, arguments, false);
+                return mArena.make<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
+            }
             return nullptr;
         }
 
@@ -317,8 +345,10 @@ namespace parser
 
         if (exported)
         {
+            if (!mHoistingParser)
+                mInterface.addFunction(attributes, name, type, arguments, true);
             mSymbols.push_back({name, type});
-            return std::make_unique<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
+            return mArena.make<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
         }
         return nullptr;
     }
@@ -328,13 +358,16 @@ namespace parser
         consume(); // namespace
 
         expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
         mNamespaces.push_back(name);
 
         expectToken(lexing::TokenType::LeftBracket);
         consume();
 
-        Scope* scope = new Scope(mScope, nullptr);
+        if (!mHoistingParser)
+            mInterface.beginNamespace(name);
+
+        Scope* scope = mArena.create<Scope>(mScope, nullptr);
         mScope = scope;
         
         std::vector<ASTNodePtr> body;
@@ -351,16 +384,20 @@ namespace parser
         mScope = scope->parent;
         mNamespaces.pop_back();
 
+        if (!mHoistingParser)
+            mInterface.endNamespace();
+
         mSymbols.push_back({name, nullptr});
-        return std::make_unique<Namespace>(std::move(name), std::move(body), scope);
+        return mArena.make<Namespace>(std::move(name), std::move(body), scope);
     }
 
     StructDeclarationPtr ImportParser::parseStructDeclaration(bool exported)
     {
+        int position = mPosition;
         consume(); // struct
 
         expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
         std::vector<std::string> names = mNamespaces;
         names.push_back(name);
 
@@ -372,8 +409,16 @@ namespace parser
         std::vector<StructType::Field>& fieldTypes = structType->getFields();
         std::vector<StructField> fields;
         std::vector<StructMethod> methods;
+        std::vector<FunctionSignature> methodSignatures;
         while (current().getTokenType() != lexing::TokenType::RightBracket)
         {
+            std::vector<GlobalAttribute> attributes;
+            if (current().getTokenType() == lexing::TokenType::DoubleLeftSquareBracket)
+            {
+                parseAttributes(attributes);
+                expectEitherToken({ lexing::TokenType::PrivateKeyword, lexing::TokenType::FuncKeyword });
+            }
+
             bool priv = false;
             if (current().getTokenType() == lexing::TokenType::PrivateKeyword)
             {
@@ -388,7 +433,7 @@ namespace parser
                 consume();
 
                 expectToken(lexing::TokenType::Identifier);
-                std::string name = consume().getText();
+                std::string name = std::string(consume().getText());
 
                 expectToken(lexing::TokenType::LeftParen);
                 consume();
@@ -397,7 +442,7 @@ namespace parser
                 while (current().getTokenType() != lexing::TokenType::RightParen)
                 {
                     expectToken(lexing::TokenType::Identifier);
-                    std::string name = consume().getText();
+                    std::string name = std::string(consume().getText());
 
                     expectToken(lexing::TokenType::Colon);
                     consume();
@@ -427,6 +472,9 @@ namespace parser
                 }
                 Type* type = FunctionType::Create(returnType, std::move(argumentTypes));
 
+                if (mHoistingParser)
+                    methodSignatures.push_back({priv, name, type, arguments, mPosition, attributes});
+
                 if (current().getTokenType() == lexing::TokenType::Semicolon)
                 {
                     consume();
@@ -463,7 +511,7 @@ namespace parser
             else
             {
                 expectToken(lexing::TokenType::Identifier);
-                std::string name = consume().getText();
+                std::string name = std::string(consume().getText());
 
                 expectToken(lexing::TokenType::Colon);
                 consume();
@@ -479,7 +527,12 @@ namespace parser
         }
         consume();
 
-        auto decl = std::make_unique<StructDeclaration>(std::move(names), std::move(fields), std::move(methods), structType);
+        if (mHoistingParser)
+            mDeclarations.addStruct(position, {structType, fields, std::move(methodSignatures), mPosition});
+        else
+            mInterface.addStruct(names, fields, methods, exported);
+
+        auto decl = mArena.make<StructDeclaration>(std::move(names), std::move(fields), std::move(methods), structType);
         if (!exported)
             mStructTypesToRemove.push_back(decl->getType());
         return std::move(decl);
@@ -487,11 +540,12 @@ namespace parser
 
     GlobalDeclarationPtr ImportParser::parseGlobalDeclaration(bool exported)
     {
+        int position = mPosition;
         consume(); // global
 
         expectToken(lexing::TokenType::Identifier);
         std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
+        names.emplace_back(consume().getText());
 
         expectToken(lexing::TokenType::Colon);
         consume();
@@ -501,6 +555,9 @@ namespace parser
         expectToken(lexing::TokenType::Equals);
         consume();
 
+        if (mHoistingParser)
+            mDeclarations.addGlobal(position, {names, type, mPosition});
+
         while(current().getTokenType() != lexing::TokenType::Semicolon)
         {
             consume();
@@ -509,20 +566,23 @@ namespace parser
 
         if (exported)
         {
+            if (!mHoistingParser)
+                mInterface.addGlobal(names, type);
             mSymbols.push_back({names.back(), type});
-            return std::make_unique<GlobalDeclaration>(std::move(names), type, nullptr); // TODO: Extern
+            return mArena.make<GlobalDeclaration>(std::move(names), type, nullptr); // TODO: Extern
         }
         return nullptr;
     }
 
     ConstexprStatementPtr ImportParser::parseConstExpr(bool exported)
     {
+        int position = mPosition;
         consume(); // constexpr
 
         expectToken(lexing::TokenType::Identifier);
         lexing::Token token = current();
         std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
+        names.emplace_back(consume().getText());
 
         expectToken(lexing::TokenType::Colon);
         consume();
@@ -532,6 +592,9 @@ namespace parser
         expectToken(lexing::TokenType::Equals);
         consume();
 
+        if (mHoistingParser)
+            mDeclarations.addGlobal(position, {names, type, mPosition});
+
         while(current().getTokenType() != lexing::TokenType::Semicolon)
         {
             consume();
@@ -540,14 +603,17 @@ namespace parser
 
         if (exported)
         {
+            if (!mHoistingParser)
+                mInterface.addConstexpr(names, type);
             mSymbols.push_back({names.back(), type});
-            return std::make_unique<ConstexprStatement>(type, std::move(names), nullptr, token, true);
+            return mArena.make<ConstexprStatement>(type, std::move(names), nullptr, token, true);
         }
         return nullptr;
     }
 
     std::pair<std::vector<ASTNodePtr>, std::vector<GlobalSymbol>> ImportParser::parseImportStatement(bool exported)
     {
+        int position = mPosition;
         consume(); // import
 
         std::filesystem::path path;
@@ -564,8 +630,13 @@ namespace parser
         }
         consume();
 
+        if (mHoistingParser)
+            mDeclarations.addComplete(position, mPosition);
+
         if (exported)
         {
+            if (!mHoistingParser)
+                mInterface.addImport(path);
             return mImportManager.ImportSymbols(path, mDiag);
         }
         return {};
@@ -573,10 +644,11 @@ namespace parser
     
     UsingDeclarationPtr ImportParser::parseUsingDeclaration(bool exported)
     {
+        int position = mPosition;
         consume(); // using
 
         std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
+        names.emplace_back(consume().getText());
 
         expectToken(lexing::TokenType::Equals);
         consume();
@@ -586,8 +658,15 @@ namespace parser
         expectToken(lexing::TokenType::Semicolon);
         consume();
 
+        if (mHoistingParser)
+            mDeclarations.addComplete(position, mPosition);
+
         if (exported)
-            return std::make_unique<UsingDeclaration>(std::move(names), type);
+        {
+            if (!mHoistingParser)
+                mInterface.addUsing(names, type);
+            return mArena.make<UsingDeclaration>(std::move(names), type);
+        }
 
         return nullptr;
     }
@@ -596,10 +675,11 @@ namespace parser
 
     EnumDeclarationPtr ImportParser::parseEnumDeclaration(bool exported)
     {
+        int position = mPosition;
         consume(); // enum
 
         std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
+        names.emplace_back(consume().getText());
 
         expectToken(lexing::TokenType::LeftBracket);
         consume();
@@ -609,13 +689,13 @@ namespace parser
         while (current().getTokenType() != lexing::TokenType::RightBracket)
         {
             expectToken(lexing::TokenType::Identifier);
-            std::string name = consume().getText();
+            std::string name = std::string(consume().getText());
 
             if (current().getTokenType() == lexing::TokenType::Equals)
             {
                 consume();
                 expectToken(lexing::TokenType::IntegerLiteral);
-                currentValue = std::stoi(consume().getText(), 0, 0);
+                currentValue = std::stoi(std::string(consume().getText()), 0, 0);
             }
 
             fields.push_back({std::move(name), currentValue++});
@@ -627,15 +707,20 @@ namespace parser
             }
         }
         consume();
-        
+
+        if (mHoistingParser)
+            mDeclarations.addComplete(position, mPosition);
+
         if (exported)
         {
+            if (!mHoistingParser)
+                mInterface.addEnum(names, fields);
             mSymbols.push_back({names.back(), nullptr});
             for (auto field : fields)
             {
                 mSymbols.push_back({field.name, nullptr});
             }
-            return std::make_unique<EnumDeclaration>(std::move(names), std::move(fields));
+            return mArena.make<EnumDeclaration>(std::move(names), std::move(fields));
         }
         return nullptr;
     }
@@ -652,6 +737,14 @@ namespace parser
             {
                 attributes.push_back(GlobalAttribute(GlobalAttributeType::NoMangle));
             }
+            else if (token.getText() == "Inline")
+            {
+                attributes.push_back(GlobalAttribute(GlobalAttributeType::Inline));
+            }
+            else if (token.getText() == "NoInline")
+            {
+                attributes.push_back(GlobalAttribute(GlobalAttributeType::NoInline));
+            }
             else
             {
                 mDiag.compilerError(token.getStart(), token.getEnd(), std::format("unknown attribute '{}{}{}'", fmt::bold, token.getText(), fmt::defaults));
@@ -0,0 +1,162 @@
+// Copyright 2024 solar-mist
+
+
+#include "parser/Inliner.h"
+
+#include "parser/ast/statement/ReturnStatement.h"
+
+#include "symbol/CompilationContext.h"
+#include "symbol/Identifier.h"
+
+#include <vipir/IR/Instruction/AllocaInst.h>
+#include <vipir/IR/Instruction/PhiInst.h>
+#include <vipir/IR/Constant/ConstantInt.h>
+#include <vipir/IR/BasicBlock.h>
+
+#include <algorithm>
+
+namespace parser
+{
+    InlinePolicy Inliner::GetPolicy(const std::vector<GlobalAttribute>& attributes)
+    {
+        for (auto& attribute : attributes)
+        {
+            switch (attribute.getType())
+            {
+                case GlobalAttributeType::Inline:
+                    return InlinePolicy::Always;
+                case GlobalAttributeType::NoInline:
+                    return InlinePolicy::Never;
+                default:
+                    break;
+            }
+        }
+        return InlinePolicy::Default;
+    }
+
+    InlineFunction* Inliner::FindFunction(const std::vector<std::string>& names, const std::vector<std::string>& namespaces)
+    {
+        auto& globalFunctions = CompilationContext::Current().getGlobalFunctions();
+        auto& inlineFunctions = CompilationContext::Current().getInlineFunctions();
+        for (auto symbol : symbol::GetSymbol(names, namespaces))
+        {
+            // The call goes to the first of these that is a function, like ::FindFunction
+            if (!globalFunctions.contains(symbol)) continue;
+
+            auto it = inlineFunctions.find(symbol);
+            return it != inlineFunctions.end() ? it->second : nullptr;
+        }
+        return nullptr;
+    }
+
+    bool Inliner::ShouldInline(const InlineFunction& function)
+    {
+        if (function.emitting || function.body->empty()) return false;
+
+        switch (function.policy)
+        {
+            case InlinePolicy::Always:
+                return true;
+            case InlinePolicy::Never:
+                return false;
+            default:
+                return function.size <= MaxInlineSize;
+        }
+    }
+
+    vipir::Value* Inliner::Emit(InlineFunction& function, vipir::IRBuilder& builder, vipir::Module& module, std::vector<vipir::Value*> arguments, diagnostic::Diagnostics& diag)
+    {
+        Scope* scope = function.scope;
+        scope->clearSSAValues();
+
+        for (std::size_t i = 0; i < arguments.size(); ++i)
+        {
+            LocalSymbol& local = scope->locals[function.parameters[i]];
+            if (local.canPromote())
+            {
+                local.value = arguments[i];
+                continue;
+            }
+
+            vipir::AllocaInst* alloca = builder.CreateAlloca(local.type->getVipirType());
+            local.alloca = alloca;
+
+            builder.CreateStore(alloca, arguments[i]);
+        }
+
+        InlineReturn inlineReturn;
+        scope->inlineReturn = &inlineReturn;
+        function.emitting = true;
+
+        // A return at the end that nothing returned before needs no block to join, so its value is used where it is computed
+        std::vector<ASTNodePtr>& body = *function.body;
+        ReturnStatement* lastReturn = dynamic_cast<ReturnStatement*>(body.back().get());
+        for (std::size_t i = 0; i + 1 < body.size(); ++i)
+        {
+            body[i]->emit(builder, module, scope, diag);
+        }
+
+        bool isVoid = function.returnType->isVoidType();
+        vipir::Value* result = nullptr;
+        if (lastReturn && inlineReturn.values.empty())
+        {
+            if (lastReturn->getReturnValue())
+            {
+                result = lastReturn->getReturnValue()->emit(builder, module, scope, diag);
+            }
+        }
+        else
+        {
+            body.back()->emit(builder, module, scope, diag);
+
+            // Falling off the end returns zero, like it does from the function itself
+            vipir::Value* zero = isVoid ? nullptr : vipir::ConstantInt::Get(module, 0, function.returnType->getVipirType());
+            if (!lastReturn && inlineReturn.values.empty())
+            {
+                result = zero;
+            }
+            else
+            {
+                if (lastReturn || !scope->isReachable(builder)) // An if whose branches all return leaves the insert point on a join nothing reaches
+                {
+                    scope->endUnreachable(builder);
+                }
+                else
+                {
+                    inlineReturn.values.emplace_back(zero, builder.getInsertPoint());
+                    builder.CreateBr(inlineReturn.block);
+                }
+
+                builder.setInsertPoint(inlineReturn.block);
+                if (!isVoid)
+                {
+                    result = joinReturns(builder, function.returnType, inlineReturn);
+                }
+            }
+        }
+
+        scope->inlineReturn = nullptr;
+        function.emitting = false;
+
+        return result;
+    }
+
+    vipir::Value* Inliner::joinReturns(vipir::IRBuilder& builder, Type* type, const InlineReturn& inlineReturn)
+    {
+        vipir::Value* result = inlineReturn.values.front().first;
+        bool same = std::all_of(inlineReturn.values.begin(), inlineReturn.values.end(), [result](const auto& value) {
+            return value.first == result;
+        });
+        if (same)
+        {
+            return result;
+        }
+
+        vipir::PhiInst* phi = builder.CreatePhi(type->getVipirType());
+        for (auto& [value, block] : inlineReturn.values)
+        {
+            phi->addIncoming(value, block);
+        }
+        return phi;
+    }
+}
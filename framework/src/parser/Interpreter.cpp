@@ -0,0 +1,282 @@
+// Copyright 2024 solar-mist
+
+
+#include "parser/Interpreter.h"
+
+#include "parser/ast/global/Function.h"
+
+#include "symbol/CompilationContext.h"
+#include "symbol/Identifier.h"
+
+#include "type/ArrayType.h"
+#include "type/StructType.h"
+
+namespace parser
+{
+    static std::size_t SizeOf(Type* type)
+    {
+        if (!type || type->isVoidType()) return 0;
+        return type->getSize() / 8;
+    }
+
+    Interpreter::Interpreter()
+        : mFlow(Flow::Normal)
+        , mSteps(0)
+        , mMemory(0)
+        , mLimitExceeded(Limit::None)
+    {
+        mFrames.emplace_back(); // Holds temporaries made outside of any call
+    }
+
+    std::optional<ConstexprValue> Interpreter::call(Function& function, std::vector<ConstexprValue> arguments)
+    {
+        if (mFrames.size() > std::size_t(MaxCallDepth))
+        {
+            mLimitExceeded = Limit::CallDepth;
+            return std::nullopt;
+        }
+        if (!function.getScope() || arguments.size() != function.getArguments().size() || !step())
+        {
+            return std::nullopt;
+        }
+
+        mFrames.emplace_back();
+        Frame& frame = mFrames.back();
+
+        bool success = true;
+        for (std::size_t i = 0; i < arguments.size() && success; ++i)
+        {
+            success = declareLocal(function.getScope(), function.getArguments()[i].name, std::move(arguments[i]));
+        }
+        if (success)
+        {
+            success = run(function.getBody(), function.getScope());
+        }
+
+        std::optional<ConstexprValue> result;
+        if (success)
+        {
+            switch (mFlow)
+            {
+                case Flow::Return:
+                    result = std::move(frame.returnValue);
+                    break;
+                case Flow::Normal:
+                {
+                    // Falling off the end only has a value in a void function
+                    ConstexprValue value;
+                    if (function.getReturnType()->isVoidType() && makeZero(function.getReturnType(), value))
+                    {
+                        result = std::move(value);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        mFlow = Flow::Normal;
+        mMemory -= frame.memory;
+        mFrames.pop_back();
+        return result;
+    }
+
+    Interpreter::Limit Interpreter::getLimitExceeded() const
+    {
+        return mLimitExceeded;
+    }
+
+    bool Interpreter::run(std::vector<ASTNodePtr>& body, Scope* scope)
+    {
+        for (auto& node : body)
+        {
+            if (!step()) return false;
+
+            ConstexprValue value;
+            if (!node->evaluate(*this, scope, value)) return false;
+
+            if (mFlow != Flow::Normal) break;
+        }
+        return true;
+    }
+
+    bool Interpreter::step()
+    {
+        if (mLimitExceeded != Limit::None) return false;
+
+        if (++mSteps > MaxSteps)
+        {
+            mLimitExceeded = Limit::Steps;
+            return false;
+        }
+        return true;
+    }
+
+    Interpreter::Flow Interpreter::getFlow() const
+    {
+        return mFlow;
+    }
+
+    void Interpreter::setFlow(Flow flow)
+    {
+        mFlow = flow;
+    }
+
+    bool Interpreter::continueLoop()
+    {
+        switch (mFlow)
+        {
+            case Flow::Break:
+                mFlow = Flow::Normal;
+                return false;
+            case Flow::Continue:
+                mFlow = Flow::Normal;
+                return true;
+            case Flow::Return:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    ConstexprValue& Interpreter::getReturnValue()
+    {
+        return mFrames.back().returnValue;
+    }
+
+    bool Interpreter::declareLocal(Scope* scope, const std::string& name, ConstexprValue value)
+    {
+        Frame& frame = mFrames.back();
+        auto& locals = frame.locals[scope];
+
+        // A declaration run again by a loop replaces the previous iteration's local
+        auto it = locals.find(name);
+        if (it != locals.end())
+        {
+            std::size_t size = SizeOf(it->second.type);
+            mMemory -= size;
+            frame.memory -= size;
+            locals.erase(it);
+        }
+
+        std::size_t size = SizeOf(value.type);
+        if (!allocate(size)) return false;
+        frame.memory += size;
+
+        locals.emplace(name, std::move(value));
+        return true;
+    }
+
+    ConstexprValue* Interpreter::findLocal(Scope* scope, const std::string& name)
+    {
+        auto& locals = mFrames.back().locals;
+        for (; scope; scope = scope->parent)
+        {
+            if (!scope->locals.contains(name)) continue;
+
+            auto it = locals.find(scope);
+            if (it == locals.end()) return nullptr;
+
+            auto local = it->second.find(name);
+            if (local == it->second.end()) return nullptr;
+
+            return &local->second;
+        }
+        return nullptr;
+    }
+
+    ConstexprValue* Interpreter::makeTemporary(ConstexprValue value)
+    {
+        Frame& frame = mFrames.back();
+
+        std::size_t size = SizeOf(value.type);
+        if (!allocate(size)) return nullptr;
+        frame.memory += size;
+
+        return &frame.temporaries.emplace_back(std::move(value));
+    }
+
+    Interpreter::TemporaryScope::TemporaryScope(Interpreter& interpreter)
+        : mInterpreter(interpreter)
+        , mCount(interpreter.mFrames.back().temporaries.size())
+    {
+    }
+
+    Interpreter::TemporaryScope::~TemporaryScope()
+    {
+        // Calls made by the expression have returned, so the frame is the one it started in
+        Frame& frame = mInterpreter.mFrames.back();
+        while (frame.temporaries.size() > mCount)
+        {
+            std::size_t size = SizeOf(frame.temporaries.back().type);
+            mInterpreter.mMemory -= size;
+            frame.memory -= size;
+            frame.temporaries.pop_back();
+        }
+    }
+
+    bool Interpreter::makeZero(Type* type, ConstexprValue& value)
+    {
+        if (!type) return false;
+
+        if (SizeOf(type) > MaxMemory)
+        {
+            mLimitExceeded = Limit::Memory;
+            return false;
+        }
+
+        value = ConstexprValue{ type };
+        if (type->isVoidType() || type->isIntegerType() || type->isBooleanType() || type->isEnumType())
+        {
+            return true;
+        }
+
+        if (type->isArrayType())
+        {
+            ArrayType* arrayType = static_cast<ArrayType*>(type);
+            ConstexprValue element;
+            if (!makeZero(arrayType->getBaseType(), element)) return false;
+
+            value.elements.assign(arrayType->getCount(), element);
+            return true;
+        }
+
+        if (type->isStructType())
+        {
+            for (auto& field : static_cast<StructType*>(type)->getFields())
+            {
+                ConstexprValue& element = value.elements.emplace_back();
+                if (!makeZero(field.type, element)) return false;
+            }
+            return true;
+        }
+
+        return false; // Pointers have no address to point to at compile time
+    }
+
+    Function* Interpreter::FindFunction(const std::vector<std::string>& names, const std::vector<std::string>& namespaces)
+    {
+        auto& functions = CompilationContext::Current().getConstexprFunctions();
+        for (auto symbol : symbol::GetSymbol(names, namespaces))
+        {
+            auto it = functions.find(symbol);
+            if (it != functions.end())
+            {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    bool Interpreter::allocate(std::size_t bytes)
+    {
+        if (mMemory + bytes > MaxMemory)
+        {
+            mLimitExceeded = Limit::Memory;
+            return false;
+        }
+        mMemory += bytes;
+        return true;
+    }
+}
@@ -16,10 +16,15 @@
 
 #include "symbol/Identifier.h"
 #include "symbol/Import.h"
+#include "symbol/NameMangling.h"
+#include "symbol/CompilationContext.h"
 
 #include "type/PointerType.h"
 #include "type/StructType.h"
 #include "type/ArrayType.h"
+#include "type/FunctionType.h"
+
+#include "support/TimeReport.h"
 
 #include <algorithm>
 #include <filesystem>
@@ -29,27 +34,44 @@
 
 namespace parser
 {
-    Parser::Parser(std::vector<lexing::Token>& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager)
+    Parser::Parser(const lexing::TokenStream& tokens, diagnostic::Diagnostics& diag, symbol::ImportManager& importManager, support::Arena& arena)
         : mTokens(tokens)
         , mImportManager(importManager)
+        , mArena(arena)
         , mPosition(0)
+        , mPendingSemicolon(false)
         , mScope(nullptr)
         , mDiag(diag)
+        , mSwitchDepth(0)
     {
     }
 
     lexing::Token Parser::current() const
     {
+        if (mPendingSemicolon) return lexing::Token(lexing::TokenType::Semicolon);
+
         return mTokens.at(mPosition);
     }
 
     lexing::Token Parser::consume()
     {
+        if (mPendingSemicolon)
+        {
+            mPendingSemicolon = false;
+            return lexing::Token(lexing::TokenType::Semicolon);
+        }
+
         return mTokens.at(mPosition++);
     }
 
     lexing::Token Parser::peek(int offset) const
     {
+        if (mPendingSemicolon && offset >= 0)
+        {
+            if (offset == 0) return lexing::Token(lexing::TokenType::Semicolon);
+            --offset;
+        }
+
         return mTokens.at(mPosition + offset);
     }
 
@@ -57,7 +79,7 @@ namespace parser
     {
         if (current().getTokenType() != tokenType)
         {
-            lexing::Token temp(tokenType, {0, 0}, {0, 0});
+            lexing::Token temp(tokenType);
             mDiag.compilerError(current().getStart(), current().getEnd(), std::format("expected '{}{}{}' before '{}{}{}' token",
                 fmt::bold, temp.getId(), fmt::defaults, fmt::bold, current().getId(), fmt::defaults));
         }
@@ -71,7 +93,7 @@ namespace parser
             if (current().getTokenType() == tokenType)
                 return;
 
-            lexing::Token temp(tokenType, {0, 0}, {0, 0});
+            lexing::Token temp(tokenType);
             tokensString += std::format("'{}{}{}', ", fmt::bold, temp.getId(), fmt::defaults);
         }
 
@@ -85,19 +107,22 @@ namespace parser
     {
         std::vector<ASTNodePtr> result;
 
-        auto tokensCopy = mTokens;
-
-        ImportParser hoistingParser(tokensCopy, mDiag, mImportManager, true);
+        {
+            support::TimeReport::Phase phase("hoisting parse");
+            ImportParser hoistingParser(mTokens, mDiag, mImportManager, mArena, true);
 
-        auto nodes = hoistingParser.parse();
-        auto symbols = hoistingParser.getSymbols();
+            auto nodes = hoistingParser.parse();
+            auto symbols = hoistingParser.getSymbols();
+            mDeclarations = std::move(hoistingParser.getDeclarations());
 
-        std::move(nodes.begin(), nodes.end(), std::back_inserter(result));
-        std::move(symbols.begin(), symbols.end(), std::back_inserter(mSymbols));
+            std::move(nodes.begin(), nodes.end(), std::back_inserter(result));
+            std::move(symbols.begin(), symbols.end(), std::back_inserter(mSymbols));
+        }
 
+        support::TimeReport::Phase phase("main parse");
         while (mPosition < mTokens.size())
         {
-            auto node = parseGlobal(result);
+            auto node = parseGlobal();
             if (node)
             {
                 result.push_back(std::move(node));
@@ -107,7 +132,12 @@ namespace parser
         return result;
     }
 
-    ASTNodePtr Parser::parseGlobal(std::vector<ASTNodePtr>& nodes)
+    const std::vector<FunctionBody>& Parser::getFunctionBodies() const
+    {
+        return mFunctionBodies;
+    }
+
+    ASTNodePtr Parser::parseGlobal()
     {
         std::vector<GlobalAttribute> attributes;
         if (current().getTokenType() == lexing::TokenType::DoubleLeftSquareBracket)
@@ -123,6 +153,12 @@ namespace parser
                                 lexing::TokenType::UsingKeyword, lexing::TokenType::EnumKeyword });
         }
 
+        if (int endPosition = mDeclarations.getCompleteEnd(mPosition); endPosition != -1) // Already parsed by the hoisting pass
+        {
+            mPosition = endPosition;
+            return nullptr;
+        }
+
         switch (current().getTokenType())
         {
             case lexing::TokenType::FuncKeyword:
@@ -132,28 +168,21 @@ namespace parser
             case lexing::TokenType::GlobalKeyword:
                 return parseGlobalDeclaration();
             case lexing::TokenType::ConstexprKeyword:
-                return parseConstexprStatement(true);
-            case lexing::TokenType::ImportKeyword:
-            {
-                auto symbols = parseImportStatement();
-                std::move(symbols.first.begin(), symbols.first.end(), std::back_inserter(nodes));
-                std::move(symbols.second.begin(), symbols.second.end(), std::back_inserter(mSymbols));
-                return nullptr;
-            }
-            case lexing::TokenType::NamespaceKeyword:
-                return parseNamespace();
-            case lexing::TokenType::UsingKeyword:
-                if (peek(1).getTokenType() == lexing::TokenType::StructKeyword)
+                if (peek(1).getTokenType() == lexing::TokenType::FuncKeyword)
                 {
                     consume();
-                    StructDeclarationPtr structDecl = parseStructDeclaration();
-                    Type::AddAlias(structDecl->getNames(), structDecl->getType());
-                    return structDecl;
+                    return parseFunction(attributes, true);
                 }
-                return parseUsingDeclaration();
-                
-            case lexing::TokenType::EnumKeyword:
-                return parseEnumDeclaration();
+                return parseConstexprStatement(true);
+            case lexing::TokenType::NamespaceKeyword:
+                return parseNamespace();
+            case lexing::TokenType::UsingKeyword: // Only using struct has a body left to parse
+            {
+                consume();
+                StructDeclarationPtr structDecl = parseStructDeclaration();
+                Type::AddAlias(structDecl->getNames(), structDecl->getType());
+                return structDecl;
+            }
             default:
                 mDiag.compilerError(current().getStart(), current().getEnd(), "Unexpected token. Expected global statement");
         }
@@ -248,14 +277,14 @@ namespace parser
             expectToken(lexing::TokenType::Identifier);
             while (current().getTokenType() == lexing::TokenType::Identifier)
             {
-                names.push_back(consume().getText());
+                names.emplace_back(consume().getText());
                 if (current().getTokenType() == lexing::TokenType::DoubleColon)
                 {
                     consume();
                 }
             }
-            std::vector<std::string> types = symbol::GetSymbol(names, mNamespaces);
-            for (auto& name : types)
+            std::vector<symbol::SymbolID> types = symbol::GetSymbol(names, mNamespaces);
+            for (auto name : types)
             {
                 type = StructType::Get(name);
                 if (type) break;
@@ -275,13 +304,13 @@ namespace parser
             std::vector<std::string> names;
             if (current().getTokenType() == lexing::TokenType::Type)
             {
-                names.push_back(consume().getText());
+                names.emplace_back(consume().getText());
             }
             else
             {
                 while (current().getTokenType() == lexing::TokenType::Identifier)
                 {
-                    names.push_back(consume().getText());
+                    names.emplace_back(consume().getText());
                     if (current().getTokenType() == lexing::TokenType::DoubleColon)
                     {
                         consume();
@@ -289,10 +318,10 @@ namespace parser
                 }
             }
 
-            std::vector<std::string> types = symbol::GetSymbol(names, mNamespaces);
+            std::vector<symbol::SymbolID> types = symbol::GetSymbol(names, mNamespaces);
 
             lexing::Token token = peek(-1);
-            for (auto& name : types)
+            for (auto name : types)
             {
                 type = Type::Get(name);
                 if (type) break;
@@ -326,7 +355,7 @@ namespace parser
             {
                 consume();
                 expectToken(lexing::TokenType::IntegerLiteral);
-                int count = std::stoi(consume().getText(), 0, 0);
+                int count = std::stoi(std::string(consume().getText()), 0, 0);
                 expectToken(lexing::TokenType::RightSquareBracket);
                 consume();
                 type = ArrayType::Create(type, count);
@@ -349,7 +378,7 @@ namespace parser
                 {
                     expectToken(lexing::TokenType::RightParen);
                     consume();
-                    lhs = std::make_unique<CastExpression>(parseExpression(nullptr, prefixOperatorPrecedence), type, std::move(operatorToken));
+                    lhs = mArena.make<CastExpression>(parseExpression(nullptr, prefixOperatorPrecedence), type, std::move(operatorToken));
                 }
                 else // Parenthesized expression
                 {
@@ -358,7 +387,20 @@ namespace parser
             }
             else
             {
-                lhs = std::make_unique<UnaryExpression>(parseExpression(preferredType, prefixOperatorPrecedence), std::move(operatorToken));
+                ASTNodePtr operand = parseExpression(preferredType, prefixOperatorPrecedence);
+                switch (operatorToken.getTokenType())
+                {
+                    case lexing::TokenType::DoublePlus:
+                    case lexing::TokenType::DoubleMinus:
+                        markLocal(operand.get(), false);
+                        break;
+                    case lexing::TokenType::Ampersand:
+                        markLocal(operand.get(), true);
+                        break;
+                    default:
+                        break;
+                }
+                lhs = mArena.make<UnaryExpression>(std::move(operand), std::move(operatorToken));
             }
         }
         else
@@ -376,7 +418,8 @@ namespace parser
 
             lexing::Token operatorToken = consume();
 
-            lhs = std::make_unique<UnaryExpression>(std::move(lhs), std::move(operatorToken), true);
+            markLocal(lhs.get(), false); // Postfix operators are all increments and decrements
+            lhs = mArena.make<UnaryExpression>(std::move(lhs), std::move(operatorToken), true);
         }
 
         while (true)
@@ -404,12 +447,18 @@ namespace parser
             else if (operatorToken.getTokenType() == lexing::TokenType::DoubleColon)
             {
                 lexing::Token token = current();
-                lhs = std::make_unique<ScopeResolution>(std::move(lhs), token, parseExpression(nullptr, binaryOperatorPrecedence));
+                lhs = mArena.make<ScopeResolution>(std::move(lhs), token, parseExpression(nullptr, binaryOperatorPrecedence));
             }
             else
             {
                 ASTNodePtr rhs = parseExpression(nullptr, binaryOperatorPrecedence);
-                lhs = std::make_unique<BinaryExpression>(std::move(lhs), std::move(operatorToken), std::move(rhs));
+                if (operatorToken.getTokenType() == lexing::TokenType::Equals ||
+                    operatorToken.getTokenType() == lexing::TokenType::PlusEquals ||
+                    operatorToken.getTokenType() == lexing::TokenType::MinusEquals)
+                {
+                    markLocal(lhs.get(), false);
+                }
+                lhs = mArena.make<BinaryExpression>(std::move(lhs), std::move(operatorToken), std::move(rhs));
             }
 
             if (operatorToken.getTokenType() == lexing::TokenType::LeftSquareBracket)
@@ -447,17 +496,17 @@ namespace parser
             case lexing::TokenType::SwitchKeyword:
                 return parseSwitchStatement();
             case lexing::TokenType::BreakKeyword:
-                return std::make_unique<BreakStatement>(std::move(consume()));
+                return mArena.make<BreakStatement>(std::move(consume()));
             case lexing::TokenType::ContinueKeyword:
-                return std::make_unique<ContinueStatement>(std::move(consume()));
+                return mArena.make<ContinueStatement>(std::move(consume()));
 
             case lexing::TokenType::TrueKeyword:
-                return std::make_unique<BooleanLiteral>(true, consume());
+                return mArena.make<BooleanLiteral>(true, consume());
             case lexing::TokenType::FalseKeyword:
-                return std::make_unique<BooleanLiteral>(false, consume());
+                return mArena.make<BooleanLiteral>(false, consume());
 
             case lexing::TokenType::NullptrKeyword:
-                return std::make_unique<NullptrLiteral>(preferredType, consume());
+                return mArena.make<NullptrLiteral>(preferredType, consume());
 
             case lexing::TokenType::SizeofKeyword:
                 return parseSizeof(preferredType);
@@ -498,57 +547,21 @@ namespace parser
         return expression;
     }
 
-    FunctionPtr Parser::parseFunction(std::vector<GlobalAttribute> attributes)
+    FunctionPtr Parser::parseFunction(std::vector<GlobalAttribute> attributes, bool isConstexpr)
     {
-        consume();
+        const FunctionSignature& signature = mDeclarations.getFunction(mPosition);
+        std::string name = signature.name;
+        std::vector<FunctionArgument> arguments = signature.arguments;
+        Type* type = signature.type;
+        mPosition = signature.bodyPosition;
 
-        expectToken(lexing::TokenType::Asperand);
-        consume();
-
-        expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
-
-        expectToken(lexing::TokenType::LeftParen);
-        consume();
-
-        std::vector<FunctionArgument> arguments;
-
-        Scope* functionScope = new Scope(mScope, nullptr);
+        Scope* functionScope = mArena.create<Scope>(mScope, nullptr);
         mScope = functionScope;
 
-        while (current().getTokenType() != lexing::TokenType::RightParen)
-        {
-            expectToken(lexing::TokenType::Identifier);
-            std::string name = consume().getText();
-
-            expectToken(lexing::TokenType::Colon);
-            consume();
-
-            Type* type = parseType();
-            mScope->locals[name] = LocalSymbol(nullptr, type);
-            arguments.push_back({std::move(name), type});
-
-            if (current().getTokenType() != lexing::TokenType::RightParen)
-            {
-                expectToken(lexing::TokenType::Comma);
-                consume();
-            }
-        }
-        consume();
-
-        Type* returnType = Type::Get("void");
-        if (current().getTokenType() == lexing::TokenType::RightArrow)
-        {
-            consume();
-            returnType = parseType();
-        }
-
-        std::vector<Type*> argumentTypes;
         for (auto& argument : arguments)
         {
-            argumentTypes.push_back(argument.type);
+            mScope->locals[argument.name] = LocalSymbol(nullptr, argument.type);
         }
-        Type* type = FunctionType::Create(returnType, std::move(argumentTypes));
 
         mSymbols.push_back({name, type});
 
@@ -556,10 +569,38 @@ namespace parser
         {
             consume();
             mScope = functionScope->parent;
-            delete functionScope;
-            return std::make_unique<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
+            std::destroy_at(functionScope);
+            return mArena.make<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<ASTNodePtr>(), nullptr);
+        }
+
+        int bodyStart = mPosition;
+        std::vector<ASTNodePtr> body = parseFunctionBody(type);
+
+        mScope = functionScope->parent;
+
+        std::vector<std::string> names = mNamespaces;
+        names.push_back(name);
+
+        bool mangled = std::find_if(attributes.begin(), attributes.end(), [](const auto& attribute){
+            return attribute.getType() == GlobalAttributeType::NoMangle;
+        }) == attributes.end();
+        std::string symbolName = mangled ? symbol::mangleFunctionName(names, static_cast<FunctionType*>(type)->getArgumentTypes()) : name;
+
+        FunctionPtr function = mArena.make<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::move(body), functionScope);
+        function->setSourceRange({mTokens.getSource().getPath().native(), bodyStart, mPosition});
+
+        if (isConstexpr) // Registered here since calls to it are folded before anything is emitted
+        {
+            symbol::AddIdentifier(symbolName, names);
+            CompilationContext::Current().getConstexprFunctions()[symbol::Intern(symbolName)] = function.get();
         }
+        CompilationContext::Current().getInlineFunctions()[symbol::Intern(symbolName)] = &function->getInlineFunction();
+        mFunctionBodies.push_back({bodyStart, mPosition, function.get()});
+        return function;
+    }
 
+    std::vector<ASTNodePtr> Parser::parseFunctionBody(Type* type)
+    {
         expectEitherToken({lexing::TokenType::LeftBracket, lexing::TokenType::Equals});
         bool isExpressionBodied = current().getTokenType() == lexing::TokenType::Equals;
         consume();
@@ -571,7 +612,7 @@ namespace parser
             if (type->isVoidType())
                 body.push_back(std::move(exp));
             else
-                body.push_back(std::make_unique<ReturnStatement>(std::move(exp)));
+                body.push_back(mArena.make<ReturnStatement>(std::move(exp)));
             expectToken(lexing::TokenType::Semicolon);
             consume();
         }
@@ -585,10 +626,34 @@ namespace parser
             }
             consume();
         }
+        return body;
+    }
 
-        mScope = functionScope->parent;
+    bool Parser::reparseFunctionBody(const lexing::TokenStream& tokens, Function& function)
+    {
+        Scope* parent = function.getScope()->parent;
+
+        Parser parser(tokens, mDiag, mImportManager, mArena);
+        parser.mSymbols = mSymbols;
+        parser.mNamespaces = parent ? parent->getNamespaces() : std::vector<std::string>();
 
-        return std::make_unique<Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::move(body), functionScope);
+        Scope* functionScope = mArena.create<Scope>(parent, nullptr);
+        parser.mScope = functionScope;
+        for (auto& argument : function.getArguments())
+        {
+            functionScope->locals[argument.name] = LocalSymbol(nullptr, argument.type);
+        }
+
+        std::vector<ASTNodePtr> body = parser.parseFunctionBody(function.getFunctionType());
+        if (parser.mPosition != static_cast<int>(tokens.size()))
+        {
+            std::destroy_at(functionScope);
+            return false;
+        }
+
+        function.setBody(std::move(body), functionScope);
+        function.setSourceRange({tokens.getSource().getPath().native(), 0, parser.mPosition});
+        return true;
     }
 
     NamespacePtr Parser::parseNamespace()
@@ -596,19 +661,19 @@ namespace parser
         consume(); // namespace
 
         expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
         mNamespaces.push_back(name);
 
         expectToken(lexing::TokenType::LeftBracket);
         consume();
 
-        Scope* scope = new Scope(mScope, nullptr);
+        Scope* scope = mArena.create<Scope>(mScope, nullptr);
         mScope = scope;
         
         std::vector<ASTNodePtr> body;
         while(current().getTokenType() != lexing::TokenType::RightBracket)
         {
-            ASTNodePtr node = parseGlobal(body);
+            ASTNodePtr node = parseGlobal();
             if (node)
             {
                 body.push_back(std::move(node));
@@ -620,161 +685,76 @@ namespace parser
         mScope = scope->parent;
         mNamespaces.pop_back();
 
-        return std::make_unique<Namespace>(std::move(name), std::move(body), scope);
+        return mArena.make<Namespace>(std::move(name), std::move(body), scope);
     }
 
     StructDeclarationPtr Parser::parseStructDeclaration()
     {
-        consume(); // struct
-
-        expectToken(lexing::TokenType::Identifier);
-        std::string name = consume().getText();
-        std::vector<std::string> names = mNamespaces;
-        names.push_back(name);
-
-        expectToken(lexing::TokenType::LeftBracket);
-        consume();
-
-        StructType* structType = StructType::Create(names, {});
+        const StructSignature& signature = mDeclarations.getStruct(mPosition);
+        StructType* structType = signature.type;
 
-        std::vector<StructType::Field>& fieldTypes = structType->getFields();
-        std::vector<StructField> fields;
         std::vector<StructMethod> methods;
-        while (current().getTokenType() != lexing::TokenType::RightBracket)
+        for (auto& method : signature.methods)
         {
-            bool priv = false;
-            if (current().getTokenType() == lexing::TokenType::PrivateKeyword)
-            {
-                consume();
-                priv = true;
-            }
+            mPosition = method.bodyPosition;
 
-            if (current().getTokenType() == lexing::TokenType::FuncKeyword)
+            if (current().getTokenType() == lexing::TokenType::Semicolon)
             {
                 consume();
-                expectToken(lexing::TokenType::Asperand);
-                consume();
-
-                expectToken(lexing::TokenType::Identifier);
-                std::string name = consume().getText();
-
-                expectToken(lexing::TokenType::LeftParen);
-                consume();
-
-                Scope* scope = new Scope(mScope, structType);
-                mScope = scope;
-
-                std::vector<FunctionArgument> arguments;
-                while (current().getTokenType() != lexing::TokenType::RightParen)
-                {
-                    expectToken(lexing::TokenType::Identifier);
-                    std::string name = consume().getText();
-
-                    expectToken(lexing::TokenType::Colon);
-                    consume();
-
-                    Type* type = parseType();
-                    mScope->locals[name] = LocalSymbol(nullptr, type);
-                    arguments.push_back({std::move(name), type});
-
-                    if (current().getTokenType() != lexing::TokenType::RightParen)
-                    {
-                        expectToken(lexing::TokenType::Comma);
-                        consume();
-                    }
-                }
-                consume();
-
-                Type* returnType = Type::Get("void");
-                if (current().getTokenType() == lexing::TokenType::RightArrow)
-                {
-                    consume();
-                    returnType = parseType();
-                }
+                methods.push_back({method.priv, method.name, method.type, method.arguments, std::vector<ASTNodePtr>(), nullptr});
+                continue;
+            }
 
-                std::vector<Type*> argumentTypes { PointerType::Create(structType) };
-                for (auto& argument : arguments)
-                {
-                    argumentTypes.push_back(argument.type);
-                }
-                Type* type = FunctionType::Create(returnType, std::move(argumentTypes));
+            Scope* scope = mArena.create<Scope>(mScope, structType);
+            mScope = scope;
 
-                if (current().getTokenType() == lexing::TokenType::Semicolon)
-                {
-                    consume();
-                    methods.push_back({priv, std::move(name), type, std::move(arguments), std::vector<ASTNodePtr>(), nullptr});
-                    continue;
-                }
+            for (auto& argument : method.arguments)
+            {
+                mScope->locals[argument.name] = LocalSymbol(nullptr, argument.type);
+            }
+            mScope->locals["this"] = LocalSymbol(nullptr, PointerType::Create(structType));
 
-                mScope->locals["this"] = LocalSymbol(nullptr, PointerType::Create(structType));
+            bool isExpressionBodied = current().getTokenType() == lexing::TokenType::Equals;
+            int bodyStart = mPosition;
+            consume();
 
-                expectEitherToken({lexing::TokenType::LeftBracket, lexing::TokenType::Equals});
-                bool isExpressionBodied = current().getTokenType() == lexing::TokenType::Equals;
+            std::vector<ASTNodePtr> body;
+            if (isExpressionBodied)
+            {
+                ASTNodePtr exp = parseExpression(method.type);
+                if (method.type->isVoidType())
+                    body.push_back(std::move(exp));
+                else
+                    body.push_back(mArena.make<ReturnStatement>(std::move(exp)));
+                expectToken(lexing::TokenType::Semicolon);
                 consume();
-
-                std::vector<ASTNodePtr> body;
-                if (isExpressionBodied)
+            }
+            else
+            {
+                while (current().getTokenType() != lexing::TokenType::RightBracket)
                 {
-                    ASTNodePtr exp = parseExpression(type);
-                    if (type->isVoidType())
-                        body.push_back(std::move(exp));
-                    else
-                        body.push_back(std::make_unique<ReturnStatement>(std::move(exp)));
+                    body.push_back(parseExpression());
                     expectToken(lexing::TokenType::Semicolon);
                     consume();
                 }
-                else
-                {
-                    while (current().getTokenType() != lexing::TokenType::RightBracket)
-                    {
-                        body.push_back(parseExpression());
-                        expectToken(lexing::TokenType::Semicolon);
-                        consume();
-                    }
-                    consume();
-                }
-
-                mScope = mScope->parent;
-
-                methods.push_back({priv, name, type, std::move(arguments), std::move(body), ScopePtr(scope)});
-            }
-            else
-            {
-                expectToken(lexing::TokenType::Identifier);
-                std::string name = consume().getText();
-
-                expectToken(lexing::TokenType::Colon);
                 consume();
+            }
 
-                Type* type = parseType();
-
-                fieldTypes.push_back({priv, name, type});
-                fields.push_back({priv, std::move(name), type});
+            mScope = mScope->parent;
 
-                expectToken(lexing::TokenType::Semicolon);
-                consume();
-            }
+            methods.push_back({method.priv, method.name, method.type, method.arguments, std::move(body), ScopePtr(scope), {mTokens.getSource().getPath().native(), bodyStart, mPosition}, method.attributes});
         }
-        consume();
+        mPosition = signature.endPosition;
 
-        return std::make_unique<StructDeclaration>(std::move(names), std::move(fields), std::move(methods), structType);
+        return mArena.make<StructDeclaration>(structType->getNames(), signature.fields, std::move(methods), structType);
     }
 
     GlobalDeclarationPtr Parser::parseGlobalDeclaration()
     {
-        consume(); // global
-
-        expectToken(lexing::TokenType::Identifier);
-        std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
-
-        expectToken(lexing::TokenType::Colon);
-        consume();
-
-        Type* type = parseType();
-
-        expectToken(lexing::TokenType::Equals);
-        consume();
+        const GlobalSignature& signature = mDeclarations.getGlobal(mPosition);
+        std::vector<std::string> names = signature.names;
+        Type* type = signature.type;
+        mPosition = signature.valuePosition;
 
         ASTNodePtr initVal = parseExpression(type);
 
@@ -783,90 +763,14 @@ namespace parser
 
         mSymbols.push_back({names.back(), type});
 
-        return std::make_unique<GlobalDeclaration>(std::move(names), type, std::move(initVal));
-    }
-
-    std::pair<std::vector<ASTNodePtr>, std::vector<GlobalSymbol>> Parser::parseImportStatement()
-    {
-        consume(); // import
-
-        std::filesystem::path path;
-        while (current().getTokenType() != lexing::TokenType::Semicolon)
-        {
-            expectToken(lexing::TokenType::Identifier);
-            path /= consume().getText();
-
-            if (current().getTokenType() != lexing::TokenType::Semicolon)
-            {
-                expectToken(lexing::TokenType::Dot);
-                consume();
-            }
-        }
-        consume();
-
-        return mImportManager.ImportSymbols(path, mDiag);
-    }
-    
-    UsingDeclarationPtr Parser::parseUsingDeclaration()
-    {
-        consume(); // using
-
-        std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
-
-        expectToken(lexing::TokenType::Equals);
-        consume();
-
-        Type* type = parseType();
-
-        expectToken(lexing::TokenType::Semicolon);
-        consume();
-
-        return std::make_unique<UsingDeclaration>(std::move(names), type);
-    }
-
-    EnumDeclarationPtr Parser::parseEnumDeclaration()
-    {
-        consume(); // enum
-
-        std::vector<std::string> names = mNamespaces;
-        names.push_back(consume().getText());
-
-        expectToken(lexing::TokenType::LeftBracket);
-        consume();
-
-        std::vector<EnumField> fields;
-        int currentValue = 0;
-        while (current().getTokenType() != lexing::TokenType::RightBracket)
-        {
-            expectToken(lexing::TokenType::Identifier);
-            std::string name = consume().getText();
-
-            if (current().getTokenType() == lexing::TokenType::Equals)
-            {
-                consume();
-                IntegerLiteralPtr literal = parseIntegerLiteral();
-                currentValue = literal->getValue();
-            }
-
-            fields.push_back({std::move(name), currentValue++});
-
-            if (current().getTokenType() != lexing::TokenType::RightBracket)
-            {
-                expectToken(lexing::TokenType::Comma);
-                consume();
-            }
-        }
-        consume();
-
-        return std::make_unique<EnumDeclaration>(std::move(names), std::move(fields));
+        return mArena.make<GlobalDeclaration>(std::move(names), type, std::move(initVal));
     }
 
     CompoundStatementPtr Parser::parseCompoundStatement()
     {
         consume(); // left bracket
 
-        Scope* blockScope = new Scope(mScope, nullptr);
+        Scope* blockScope = mArena.create<Scope>(mScope, nullptr);
         mScope = blockScope;
 
         std::vector<ASTNodePtr> body;
@@ -878,11 +782,11 @@ namespace parser
         }
         consume();
 
-        mTokens.insert(mTokens.begin()+mPosition, lexing::Token(lexing::TokenType::Semicolon, {0, 0}, {0, 0}));
+        mPendingSemicolon = true;
 
         mScope = blockScope->parent;
 
-        return std::make_unique<CompoundStatement>(std::move(body), blockScope);
+        return mArena.make<CompoundStatement>(std::move(body), blockScope);
     }
 
     ReturnStatementPtr Parser::parseReturnStatement()
@@ -891,17 +795,17 @@ namespace parser
 
         if (current().getTokenType() == lexing::TokenType::Semicolon)
         {
-            return std::make_unique<ReturnStatement>(nullptr);
+            return mArena.make<ReturnStatement>(nullptr);
         }
 
-        return std::make_unique<ReturnStatement>(parseExpression()); // TODO: Pass preferred type as current function return type
+        return mArena.make<ReturnStatement>(parseExpression()); // TODO: Pass preferred type as current function return type
     }
 
     VariableDeclarationPtr Parser::parseVariableDeclaration()
     {
         consume(); // let
 
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
 
         expectToken(lexing::TokenType::Colon);
         consume();
@@ -909,50 +813,54 @@ namespace parser
         Type* type = parseType();
         
         mScope->locals[name] = LocalSymbol(nullptr, type);
+        mScope->locals[name].needsAlloca = mSwitchDepth > 0;
 
         if (current().getTokenType() == lexing::TokenType::Semicolon)
         {
-            return std::make_unique<VariableDeclaration>(type, std::move(name), nullptr);
+            return mArena.make<VariableDeclaration>(type, std::move(name), nullptr);
         }
 
         expectToken(lexing::TokenType::Equals);
         consume();
 
-        return std::make_unique<VariableDeclaration>(type, std::move(name), parseExpression(type));
+        return mArena.make<VariableDeclaration>(type, std::move(name), parseExpression(type));
     }
 
     ConstexprStatementPtr Parser::parseConstexprStatement(bool global)
     {
+        if (global)
+        {
+            const GlobalSignature& signature = mDeclarations.getGlobal(mPosition);
+            lexing::Token token = peek(1);
+            mPosition = signature.valuePosition;
+
+            mSymbols.push_back({signature.names.back(), signature.type});
+
+            ASTNodePtr value = parseExpression(signature.type);
+
+            expectToken(lexing::TokenType::Semicolon);
+            consume();
+
+            return mArena.make<ConstexprStatement>(signature.type, signature.names, std::move(value), token, true);
+        }
+
         consume(); // constexpr
 
         lexing::Token token = current();
-        std::string name = consume().getText();
-
-        auto names = mNamespaces;
-        names.push_back(name);
+        std::string name = std::string(consume().getText());
 
         expectToken(lexing::TokenType::Colon);
         consume();
 
         Type* type = parseType();
-
-        if (global)
-            mSymbols.push_back({name, type});
-        else
-            mScope->locals[name] = LocalSymbol(nullptr, type);
+        mScope->locals[name] = LocalSymbol(nullptr, type);
 
         expectToken(lexing::TokenType::Equals);
         consume();
 
         ASTNodePtr value = parseExpression(type);
 
-        if (global)
-        {
-            expectToken(lexing::TokenType::Semicolon);
-            consume();
-        }
-
-        return std::make_unique<ConstexprStatement>(type, global ? std::move(names) : std::vector<std::string>{name}, std::move(value), token, global);
+        return mArena.make<ConstexprStatement>(type, std::vector<std::string>{name}, std::move(value), token, false);
     }
 
     IfStatementPtr Parser::parseIfStatement()
@@ -980,7 +888,7 @@ namespace parser
             elseBody = parseExpression();
         }
 
-        return std::make_unique<IfStatement>(std::move(condition), std::move(body), std::move(elseBody));
+        return mArena.make<IfStatement>(std::move(condition), std::move(body), std::move(elseBody));
     }
 
     WhileStatementPtr Parser::parseWhileStatement()
@@ -990,9 +898,11 @@ namespace parser
         expectToken(lexing::TokenType::LeftParen);
         consume();
 
-        Scope* whileScope = new Scope(mScope, nullptr);
+        Scope* whileScope = mArena.create<Scope>(mScope, nullptr);
         mScope = whileScope;
 
+        mLoopScopes.push_back(whileScope);
+
         ASTNodePtr condition = parseExpression();
 
         expectToken(lexing::TokenType::RightParen);
@@ -1000,9 +910,10 @@ namespace parser
 
         ASTNodePtr body = parseExpression();
 
+        mLoopScopes.pop_back();
         mScope = whileScope->parent;
 
-        return std::make_unique<WhileStatement>(std::move(condition), std::move(body), whileScope);
+        return mArena.make<WhileStatement>(std::move(condition), std::move(body), whileScope);
     }
 
     ForStatementPtr Parser::parseForStatement()
@@ -1016,7 +927,7 @@ namespace parser
         ASTNodePtr condition = nullptr;
         std::vector<ASTNodePtr> loopExpr;
 
-        Scope* forScope = new Scope(mScope, nullptr);
+        Scope* forScope = mArena.create<Scope>(mScope, nullptr);
         mScope = forScope;
 
         if (current().getTokenType() != lexing::TokenType::Semicolon)
@@ -1026,6 +937,8 @@ namespace parser
         }
         consume();
 
+        mLoopScopes.push_back(forScope); // The initializer runs once, before the loop
+
         if (current().getTokenType() != lexing::TokenType::Semicolon)
         {
             condition = parseExpression();
@@ -1050,9 +963,10 @@ namespace parser
 
         ASTNodePtr body = parseExpression();
 
+        mLoopScopes.pop_back();
         mScope = forScope->parent;
 
-        return std::make_unique<ForStatement>(std::move(init), std::move(condition), std::move(loopExpr), std::move(body), forScope);
+        return mArena.make<ForStatement>(std::move(init), std::move(condition), std::move(loopExpr), std::move(body), forScope);
     }
 
     SwitchStatementPtr Parser::parseSwitchStatement()
@@ -1108,6 +1022,7 @@ namespace parser
             expectToken(lexing::TokenType::Colon);
             consume();
 
+            ++mSwitchDepth;
             std::vector<ASTNodePtr> body;
             while (current().getTokenType() != lexing::TokenType::RightBracket &&
                 current().getTokenType() != lexing::TokenType::CaseKeyword &&
@@ -1120,14 +1035,15 @@ namespace parser
                     consume();
                 }
             }
+            --mSwitchDepth;
 
             sections.push_back({std::move(label), std::move(body)});
         }
         consume();
 
-        mTokens.insert(mTokens.begin() + mPosition, lexing::Token(lexing::TokenType::Semicolon, {0, 0}, {0, 0}));
+        mPendingSemicolon = true;
 
-        return std::make_unique<SwitchStatement>(std::move(value), std::move(sections));
+        return mArena.make<SwitchStatement>(std::move(value), std::move(sections));
     }
 
     SizeofExpressionPtr Parser::parseSizeof(Type* preferredType)
@@ -1141,32 +1057,32 @@ namespace parser
         expectToken(lexing::TokenType::RightParen);
         consume();
 
-        return std::make_unique<SizeofExpression>(preferredType, type, std::move(token));
+        return mArena.make<SizeofExpression>(preferredType, type, std::move(token));
     }
 
     IntegerLiteralPtr Parser::parseIntegerLiteral(Type* preferredType)
     {
         lexing::Token token = consume();
-        unsigned long long value = std::stoull(token.getText(), 0, 0);
-        return std::make_unique<IntegerLiteral>(value, preferredType, std::move(token));
+        unsigned long long value = std::stoull(std::string(token.getText()), 0, 0);
+        return mArena.make<IntegerLiteral>(value, preferredType, std::move(token));
     }
 
     StringLiteralPtr Parser::parseStringLiteral()
     {
         lexing::Token token = consume();
-        std::string text = token.getText();
-        return std::make_unique<StringLiteral>(std::move(text), std::move(token));
+        std::string text = std::string(token.getText());
+        return mArena.make<StringLiteral>(std::move(text), std::move(token));
     }
 
     VariableExpressionPtr Parser::parseVariableExpression(Type*)
     {
         lexing::Token nameToken = current();
-        std::string name = consume().getText();
+        std::string name = std::string(consume().getText());
 
         auto local = mScope->findVariable(name);
         if (local)
         {
-            return std::make_unique<VariableExpression>(std::move(name), local->type, std::move(nameToken));
+            return mArena.make<VariableExpression>(std::move(name), local->type, std::move(nameToken));
         }
 
         auto it = std::find_if(mSymbols.begin(), mSymbols.end(), [&name](const GlobalSymbol& symbol) {
@@ -1175,7 +1091,7 @@ namespace parser
 
         if (it != mSymbols.end())
         {
-            return std::make_unique<VariableExpression>(std::move(name), it->type, std::move(nameToken));
+            return mArena.make<VariableExpression>(std::move(name), it->type, std::move(nameToken));
         }
 
         mDiag.compilerError(nameToken.getStart(), nameToken.getEnd(), std::format("Unknown symbol '{}{}{}'", fmt::bold, name, fmt::defaults));
@@ -1198,14 +1114,14 @@ namespace parser
         }
         consume();
 
-        return std::make_unique<CallExpression>(std::move(function), std::move(parameters), std::move(token));
+        return mArena.make<CallExpression>(std::move(function), std::move(parameters), std::move(token));
     }
 
     MemberAccessPtr Parser::parseMemberAccess(ASTNodePtr struc, bool pointer)
     {
         lexing::Token nameToken = consume();
 
-        return std::make_unique<MemberAccess>(std::move(struc), std::string(nameToken.getText()), pointer, std::move(nameToken));
+        return mArena.make<MemberAccess>(std::move(struc), std::string(nameToken.getText()), pointer, std::move(nameToken));
     }
 
     StructInitializerPtr Parser::parseStructInitializer(Type* type, lexing::Token token)
@@ -1235,7 +1151,7 @@ namespace parser
         }
         consume();
 
-        return std::make_unique<StructInitializer>(type, std::move(body), std::move(token));
+        return mArena.make<StructInitializer>(type, std::move(body), std::move(token));
     }
 
     ArrayInitializerPtr Parser::parseArrayInitializer(Type* preferredType)
@@ -1257,7 +1173,7 @@ namespace parser
         }
         consume();
 
-        return std::make_unique<ArrayInitializer>(std::move(values), std::move(token));
+        return mArena.make<ArrayInitializer>(std::move(values), std::move(token));
     }
 
     void Parser::parseAttributes(std::vector<GlobalAttribute>& attributes)
@@ -1272,6 +1188,14 @@ namespace parser
             {
                 attributes.push_back(GlobalAttribute(GlobalAttributeType::NoMangle));
             }
+            else if (token.getText() == "Inline")
+            {
+                attributes.push_back(GlobalAttribute(GlobalAttributeType::Inline));
+            }
+            else if (token.getText() == "NoInline")
+            {
+                attributes.push_back(GlobalAttribute(GlobalAttributeType::NoInline));
+            }
             else
             {
                 mDiag.compilerError(token.getStart(), token.getEnd(), std::format("unknown attribute '{}{}{}'", fmt::bold, token.getText(), fmt::defaults));
@@ -1285,4 +1209,33 @@ namespace parser
         }
         consume();
     }
+
+    void Parser::markLocal(ASTNode* node, bool addressTaken)
+    {
+        auto variable = dynamic_cast<VariableExpression*>(node);
+        if (!variable || !mScope)
+        {
+            return;
+        }
+
+        LocalSymbol* local = mScope->findVariable(variable->getName());
+        if (!local)
+        {
+            return;
+        }
+
+        // Switch sections are entered from the middle of the dispatch, which has no single value to give a local written in them
+        if (addressTaken || mSwitchDepth > 0)
+        {
+            local->needsAlloca = true;
+        }
+
+        for (Scope* loopScope : mLoopScopes)
+        {
+            if (std::find(loopScope->assignedLocals.begin(), loopScope->assignedLocals.end(), local) == loopScope->assignedLocals.end())
+            {
+                loopScope->assignedLocals.push_back(local);
+            }
+        }
+    }
 }
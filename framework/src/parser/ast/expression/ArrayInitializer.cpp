@@ -2,6 +2,8 @@
 
 
 #include "parser/ast/expression/ArrayInitializer.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include "type/ArrayType.h"
 
@@ -35,6 +37,28 @@ namespace parser
         }
     }
 
+    ASTNodePtr ArrayInitializer::fold(ConstantFolder& folder, Scope* scope)
+    {
+        for (auto& node : mBody)
+        {
+            folder.fold(node, scope);
+        }
+
+        return nullptr;
+    }
+
+    bool ArrayInitializer::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        ConstexprValue value{ mType };
+        for (auto& node : mBody)
+        {
+            if (!node->evaluate(interpreter, scope, value.elements.emplace_back())) return false;
+        }
+
+        result = std::move(value);
+        return true;
+    }
+
     vipir::Value* ArrayInitializer::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         std::vector<vipir::Value*> values;
@@ -2,6 +2,10 @@
 
 
 #include "parser/ast/expression/BinaryExpression.h"
+#include "parser/ast/expression/VariableExpression.h"
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include "type/ArrayType.h"
 #include "type/IntegerType.h"
@@ -13,6 +17,7 @@
 #include <vipir/IR/Instruction/LoadInst.h>
 
 #include <cassert>
+#include <cstdint>
 
 namespace parser
 {
@@ -189,6 +194,128 @@ namespace parser
         mRight->typeCheck(scope, diag);
     }
 
+    ASTNodePtr BinaryExpression::fold(ConstantFolder& folder, Scope* scope)
+    {
+        // Assignments need their left side to stay an lvalue and arrays are indexed through their address, so only its children can fold
+        bool leftIsLvalue = mOperator == Operator::Assign || mOperator == Operator::AddAssign || mOperator == Operator::SubAssign || mOperator == Operator::ArrayAccess;
+        if (leftIsLvalue)
+        {
+            mLeft->fold(folder, scope);
+        }
+        else
+        {
+            folder.fold(mLeft, scope);
+        }
+        folder.fold(mRight, scope);
+
+        auto left = dynamic_cast<IntegerLiteral*>(mLeft.get());
+        auto right = dynamic_cast<IntegerLiteral*>(mRight.get());
+        if (!left || !right || !mLeft->getType()->isIntegerType() || mLeft->getType() != mRight->getType())
+        {
+            return nullptr;
+        }
+
+        std::optional<intmax_t> value = Compute(mOperator, left->getValue(), right->getValue(), mLeft->getType());
+        if (!value)
+        {
+            return nullptr;
+        }
+
+        if (mType->isBooleanType())
+        {
+            return folder.makeBoolean(*value != 0, mToken);
+        }
+        return folder.makeInteger(*value, mType, mToken);
+    }
+
+    bool BinaryExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        if (mOperator == Operator::ArrayAccess)
+        {
+            Interpreter::TemporaryScope temporaries(interpreter);
+            ConstexprValue* element = evaluateLvalue(interpreter, scope);
+            if (!element) return false;
+
+            result = *element;
+            return true;
+        }
+
+        if (mOperator == Operator::Assign || mOperator == Operator::AddAssign || mOperator == Operator::SubAssign)
+        {
+            Interpreter::TemporaryScope temporaries(interpreter);
+
+            // The target is loaded before the right side is emitted, so a compound assignment combines with its old value
+            ConstexprValue* target = mLeft->evaluateLvalue(interpreter, scope);
+            if (!target) return false;
+            ConstexprValue old{ target->type, target->integer };
+
+            ConstexprValue value;
+            if (!mRight->evaluate(interpreter, scope, value)) return false;
+
+            if (mOperator != Operator::Assign)
+            {
+                if (!old.type->isIntegerType()) return false;
+
+                std::optional<intmax_t> combined = Compute(mOperator == Operator::AddAssign ? Operator::Add : Operator::Sub, old.integer, value.integer, old.type);
+                if (!combined) return false;
+                value = ConstexprValue{ old.type, *combined };
+            }
+
+            *target = value;
+            result = std::move(value);
+            return true;
+        }
+
+        ConstexprValue left;
+        ConstexprValue right;
+        if (!mLeft->evaluate(interpreter, scope, left) || !mRight->evaluate(interpreter, scope, right))
+        {
+            return false;
+        }
+        if (!left.elements.empty() || !right.elements.empty())
+        {
+            return false;
+        }
+
+        std::optional<intmax_t> value = Compute(mOperator, left.integer, right.integer, left.type);
+        if (!value)
+        {
+            return false;
+        }
+
+        result = ConstexprValue{ mType, *value };
+        return true;
+    }
+
+    ConstexprValue* BinaryExpression::evaluateLvalue(Interpreter& interpreter, Scope* scope)
+    {
+        if (mOperator != Operator::ArrayAccess)
+        {
+            return nullptr;
+        }
+
+        ConstexprValue index;
+        if (!mRight->evaluate(interpreter, scope, index)) return nullptr;
+
+        // Arrays that aren't stored anywhere, like a call's result, are indexed through a temporary
+        ConstexprValue* array = mLeft->evaluateLvalue(interpreter, scope);
+        if (!array)
+        {
+            ConstexprValue value;
+            if (!mLeft->evaluate(interpreter, scope, value)) return nullptr;
+
+            array = interpreter.makeTemporary(std::move(value));
+            if (!array) return nullptr;
+        }
+
+        // Indexing out of bounds has no value to give, so the call is left for runtime
+        if (!array->type->isArrayType() || uintmax_t(index.integer) >= array->elements.size())
+        {
+            return nullptr;
+        }
+        return &array->elements[index.integer];
+    }
+
     vipir::Value* BinaryExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* left  = mLeft->emit(builder, module, scope, diag);
@@ -251,6 +378,12 @@ namespace parser
 
             case Operator::Assign:
             {
+                if (LocalSymbol* local = VariableExpression::FindPromotedLocal(mLeft.get(), scope))
+                {
+                    local->value = right;
+                    return right;
+                }
+
                 vipir::Value* pointerOperand = vipir::getPointerOperand(left);
                 checkAssignmentLvalue(pointerOperand, diag);
 
@@ -261,9 +394,6 @@ namespace parser
             }
             case Operator::AddAssign:
             {
-                vipir::Value* pointerOperand = vipir::getPointerOperand(left);
-                checkAssignmentLvalue(pointerOperand, diag);
-
                 vipir::Value* add;
                 if (left->getType()->isPointerType())
                 {
@@ -274,14 +404,30 @@ namespace parser
                     add = builder.CreateAdd(left, right);
                 }
 
+                if (LocalSymbol* local = VariableExpression::FindPromotedLocal(mLeft.get(), scope))
+                {
+                    local->value = add;
+                    return add;
+                }
+
+                vipir::Value* pointerOperand = vipir::getPointerOperand(left);
+                checkAssignmentLvalue(pointerOperand, diag);
+
                 return builder.CreateStore(pointerOperand, add);
             }
             case Operator::SubAssign:
             {
+                vipir::Value* sub = builder.CreateSub(left, right);
+
+                if (LocalSymbol* local = VariableExpression::FindPromotedLocal(mLeft.get(), scope))
+                {
+                    local->value = sub;
+                    return sub;
+                }
+
                 vipir::Value* pointerOperand = vipir::getPointerOperand(left);
                 checkAssignmentLvalue(pointerOperand, diag);
 
-                vipir::Value* sub = builder.CreateSub(left, right);
                 return builder.CreateStore(pointerOperand, sub);
             }
 
@@ -309,4 +455,56 @@ namespace parser
             diag.compilerError(mToken.getStart(), mToken.getEnd(), std::format("lvalue required as left operand of assignment"));
         }
     }
+
+    std::optional<intmax_t> BinaryExpression::Compute(Operator op, intmax_t left, intmax_t right, Type* type)
+    {
+        bool isSigned = ConstantFolder::IsSigned(type);
+
+        // Arithmetic is done unsigned so it wraps instead of overflowing, then truncated to the operand width
+        uintmax_t lhs = left;
+        uintmax_t rhs = right;
+
+        switch (op)
+        {
+            case Operator::Add:
+                return ConstantFolder::Wrap(lhs + rhs, type);
+            case Operator::Sub:
+                return ConstantFolder::Wrap(lhs - rhs, type);
+            case Operator::Mul:
+                return ConstantFolder::Wrap(lhs * rhs, type);
+
+            case Operator::Div:
+                if (rhs == 0) return std::nullopt; // Left for the program to trap on at runtime
+                if (isSigned)
+                {
+                    if (left == ConstantFolder::MinValue(type) && right == -1) return std::nullopt; // Overflows, and traps like division by zero
+                    return ConstantFolder::Wrap(left / right, type);
+                }
+                return ConstantFolder::Wrap(lhs / rhs, type);
+
+            case Operator::BitwiseOr:
+                return ConstantFolder::Wrap(lhs | rhs, type);
+            case Operator::BitwiseAnd:
+                return ConstantFolder::Wrap(lhs & rhs, type);
+            case Operator::BitwiseXor:
+                return ConstantFolder::Wrap(lhs ^ rhs, type);
+
+            case Operator::Equal:
+                return lhs == rhs;
+            case Operator::NotEqual:
+                return lhs != rhs;
+
+            case Operator::LessThan:
+                return isSigned ? left < right : lhs < rhs;
+            case Operator::GreaterThan:
+                return isSigned ? left > right : lhs > rhs;
+            case Operator::LessEqual:
+                return isSigned ? left <= right : lhs <= rhs;
+            case Operator::GreaterEqual:
+                return isSigned ? left >= right : lhs >= rhs;
+
+            default:
+                return std::nullopt;
+        }
+    }
 }
@@ -1,6 +1,7 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/expression/BooleanLiteral.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Constant/ConstantBool.h>
 
@@ -28,6 +29,17 @@ namespace parser
         }
     }
 
+    ASTNodePtr BooleanLiteral::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool BooleanLiteral::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        result = ConstexprValue{ mType, mValue };
+        return true;
+    }
+
     vipir::Value* BooleanLiteral::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         return builder.CreateConstantBool(mValue);
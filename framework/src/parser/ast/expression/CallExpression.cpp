@@ -7,6 +7,9 @@
 #include "parser/ast/expression/ScopeResolution.h"
 
 #include "parser/ast/global/StructDeclaration.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Inliner.h"
+#include "parser/Interpreter.h"
 
 #include "symbol/NameMangling.h"
 
@@ -73,6 +76,72 @@ namespace parser
         }
     }
 
+    ASTNodePtr CallExpression::fold(ConstantFolder& folder, Scope* scope)
+    {
+        // The callee is left alone, method calls look through it for the object
+        for (auto& parameter : mParameters)
+        {
+            folder.fold(parameter, scope);
+        }
+
+        if (!findConstexprFunction(scope) || mType->isVoidType())
+        {
+            return nullptr;
+        }
+
+        Interpreter interpreter;
+        ConstexprValue value;
+        if (evaluate(interpreter, scope, value))
+        {
+            return folder.materialize(value, mPreferredDebugToken);
+        }
+
+        std::string limit;
+        switch (interpreter.getLimitExceeded())
+        {
+            case Interpreter::Limit::Steps:
+                limit = std::format("the limit of {} evaluation steps", Interpreter::MaxSteps);
+                break;
+            case Interpreter::Limit::Memory:
+                limit = std::format("the limit of {} bytes of locals", Interpreter::MaxMemory);
+                break;
+            case Interpreter::Limit::CallDepth:
+                limit = std::format("the call depth limit of {}", Interpreter::MaxCallDepth);
+                break;
+            case Interpreter::Limit::None:
+                return nullptr; // Calls with arguments that aren't constant are expected to run at runtime
+        }
+
+        lexing::Token token = mFunction->getDebugToken();
+        folder.getDiagnostics().compilerWarning(token.getStart(), token.getEnd(), std::format("constexpr call to '{}{}{}' exceeded {} and will be evaluated at runtime",
+            fmt::bold, token.getText(), fmt::defaults, limit));
+        return nullptr;
+    }
+
+    bool CallExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        Function* function = findConstexprFunction(scope);
+        if (!function)
+        {
+            return false;
+        }
+
+        std::vector<ConstexprValue> arguments;
+        for (auto& parameter : mParameters)
+        {
+            if (!parameter->evaluate(interpreter, scope, arguments.emplace_back())) return false;
+        }
+
+        std::optional<ConstexprValue> value = interpreter.call(*function, std::move(arguments));
+        if (!value)
+        {
+            return false;
+        }
+
+        result = std::move(*value);
+        return true;
+    }
+
     vipir::Value* CallExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         std::vector<Type*> manglingArguments;
@@ -91,7 +160,7 @@ namespace parser
 
             vipir::Function* function = FindFunction({name}, namespaceNames, manglingArguments)->function;
 
-            return builder.CreateCall(function, std::move(parameters));
+            return emitCall(builder, module, diag, {name}, namespaceNames, function, std::move(parameters));
         }
         else if (MemberAccess* member = dynamic_cast<MemberAccess*>(mFunction.get()))
         {
@@ -126,9 +195,8 @@ namespace parser
             }
             else
             {
-                mParameters.insert(mParameters.begin(), std::move(member->mStruct));
                 parameters.insert(parameters.begin(), value);
-                manglingArguments.insert(manglingArguments.begin(), mParameters[0]->getType());
+                manglingArguments.insert(manglingArguments.begin(), member->mStruct->getType());
             }
 
             FunctionSymbol* func = FindFunction(structNames, namespaceNames, manglingArguments);
@@ -146,7 +214,7 @@ namespace parser
 
             vipir::Function* function = func->function;
 
-            return builder.CreateCall(function, std::move(parameters));
+            return emitCall(builder, module, diag, structNames, namespaceNames, function, std::move(parameters));
         }
         else if (auto scopeRes = dynamic_cast<ScopeResolution*>(mFunction.get()))
         {
@@ -154,7 +222,7 @@ namespace parser
 
             FunctionSymbol* func = FindFunction(names, namespaceNames, manglingArguments);
 
-            return builder.CreateCall(func->function, std::move(parameters));
+            return emitCall(builder, module, diag, names, namespaceNames, func->function, std::move(parameters));
         }
         else
         {
@@ -163,4 +231,36 @@ namespace parser
             return builder.CreateCall(function, std::move(parameters));
         }
     }
+
+    vipir::Value* CallExpression::emitCall(vipir::IRBuilder& builder, vipir::Module& module, diagnostic::Diagnostics& diag, const std::vector<std::string>& names, const std::vector<std::string>& namespaces, vipir::Function* function, std::vector<vipir::Value*> parameters)
+    {
+        InlineFunction* inlineFunction = Inliner::FindFunction(names, namespaces);
+        if (inlineFunction && Inliner::ShouldInline(*inlineFunction))
+        {
+            return Inliner::Emit(*inlineFunction, builder, module, std::move(parameters), diag);
+        }
+
+        return builder.CreateCall(function, std::move(parameters));
+    }
+
+    Function* CallExpression::findConstexprFunction(Scope* scope)
+    {
+        // Methods take the object's address as this, which has no value at compile time
+        std::vector<std::string> names;
+        if (VariableExpression* variable = dynamic_cast<VariableExpression*>(mFunction.get()))
+        {
+            names = { variable->mName };
+        }
+        else if (auto scopeRes = dynamic_cast<ScopeResolution*>(mFunction.get()))
+        {
+            names = scopeRes->getNames();
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        std::vector<std::string> namespaces = scope ? scope->getNamespaces() : std::vector<std::string>();
+        return Interpreter::FindFunction(names, namespaces);
+    }
 }
@@ -2,6 +2,9 @@
 
 
 #include "parser/ast/expression/CastExpression.h"
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include "type/IntegerType.h"
 
@@ -27,6 +30,38 @@ namespace parser
         // maybe check for type compatibility here in future
     }
 
+    ASTNodePtr CastExpression::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mOperand, scope);
+
+        // A cast to the same type is kept so emitting it still warns
+        auto operand = dynamic_cast<IntegerLiteral*>(mOperand.get());
+        if (!operand || mOperand->getType() == mType || !mOperand->getType()->isIntegerType() || !mType->isIntegerType())
+        {
+            return nullptr;
+        }
+
+        // Literals are stored sign or zero extended from their own type, so this also covers extending them
+        return folder.makeInteger(operand->getValue(), mType, mToken);
+    }
+
+    bool CastExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        if (!mOperand->evaluate(interpreter, scope, result)) return false;
+
+        if (mOperand->getType() == mType)
+        {
+            return true;
+        }
+        if (!mOperand->getType()->isIntegerType() || !mType->isIntegerType())
+        {
+            return false;
+        }
+
+        result = ConstexprValue{ mType, ConstantFolder::Wrap(result.integer, mType) };
+        return true;
+    }
+
     vipir::Value* CastExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* operand = mOperand->emit(builder, module, scope, diag);
@@ -1,6 +1,7 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Constant/ConstantInt.h>
 
@@ -27,6 +28,17 @@ namespace parser
         }
     }
 
+    ASTNodePtr IntegerLiteral::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool IntegerLiteral::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        result = ConstexprValue{ mType, mValue };
+        return true;
+    }
+
     vipir::Value* IntegerLiteral::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         return vipir::ConstantInt::Get(module, mValue, mType->getVipirType());
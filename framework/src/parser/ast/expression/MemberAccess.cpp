@@ -2,6 +2,7 @@
 
 
 #include "parser/ast/expression/MemberAccess.h"
+#include "parser/Interpreter.h"
 
 #include "type/StructType.h"
 #include "type/PointerType.h"
@@ -47,6 +48,59 @@ namespace parser
         mStruct->typeCheck(scope, diag);
     }
 
+    ASTNodePtr MemberAccess::fold(ConstantFolder& folder, Scope* scope)
+    {
+        mStruct->fold(folder, scope); // The struct is accessed through its address, so only its children can fold
+
+        return nullptr;
+    }
+
+    bool MemberAccess::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        Interpreter::TemporaryScope temporaries(interpreter);
+        ConstexprValue* field = evaluateLvalue(interpreter, scope);
+        if (!field) return false;
+
+        result = *field;
+        return true;
+    }
+
+    ConstexprValue* MemberAccess::evaluateLvalue(Interpreter& interpreter, Scope* scope)
+    {
+        if (mPointer)
+        {
+            return nullptr; // Pointers have no address to point to at compile time
+        }
+
+        ConstexprValue* struc = mStruct->evaluateLvalue(interpreter, scope);
+        if (!struc)
+        {
+            ConstexprValue value;
+            if (!mStruct->evaluate(interpreter, scope, value)) return nullptr;
+
+            struc = interpreter.makeTemporary(std::move(value));
+            if (!struc) return nullptr;
+        }
+
+        if (!struc->type->isStructType())
+        {
+            return nullptr;
+        }
+
+        StructType* structType = static_cast<StructType*>(struc->type);
+        if (!structType->hasField(mField))
+        {
+            return nullptr;
+        }
+
+        std::size_t index = structType->getFieldOffset(mField);
+        if (index >= struc->elements.size())
+        {
+            return nullptr;
+        }
+        return &struc->elements[index];
+    }
+
     vipir::Value* MemberAccess::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* struc;
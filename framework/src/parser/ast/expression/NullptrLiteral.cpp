@@ -2,6 +2,7 @@
 
 
 #include "parser/ast/expression/NullptrLiteral.h"
+#include "parser/Interpreter.h"
 #include "type/PointerType.h"
 
 #include <vipir/IR/Constant/ConstantNullPtr.h>
@@ -23,6 +24,16 @@ namespace parser
         }
     }
 
+    ASTNodePtr NullptrLiteral::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool NullptrLiteral::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false; // Pointers have no address to point to at compile time
+    }
+
     vipir::Value* NullptrLiteral::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         return vipir::ConstantNullPtr::Get(module, mType->getVipirType());
@@ -3,7 +3,10 @@
 
 #include "parser/ast/expression/ScopeResolution.h"
 #include "parser/ast/expression/VariableExpression.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/Identifier.h"
 
 #include <vipir/IR/Instruction/LoadInst.h>
@@ -15,17 +18,19 @@ namespace parser
         , mToken(std::move(token))
         , mRight(std::move(right))
     {
-        std::vector<std::string> symbols = symbol::GetSymbol(getNames(), getNames());
+        std::vector<symbol::SymbolID> symbols = symbol::GetSymbol(getNames(), getNames());
+        auto& globalVariables = CompilationContext::Current().getGlobalVariables();
+        auto& globalFunctions = CompilationContext::Current().getGlobalFunctions();
         
         for (auto symbol : symbols)
         {
-            if (GlobalVariables.contains(symbol))
+            if (globalVariables.contains(symbol))
             {
-                mType = GlobalVariables[symbol].type;
+                mType = globalVariables[symbol].type;
             }
-            else if (GlobalFunctions.contains(symbol))
+            else if (globalFunctions.contains(symbol))
             {
-                mType = GlobalFunctions[symbol].type;
+                mType = globalFunctions[symbol].type;
             }
         }
         mPreferredDebugToken = token;
@@ -37,6 +42,39 @@ namespace parser
         mRight->typeCheck(scope, diag);
     }
 
+    ASTNodePtr ScopeResolution::fold(ConstantFolder& folder, Scope* scope)
+    {
+        std::vector<std::string> namespaces = scope ? scope->getNamespaces() : std::vector<std::string>();
+        auto& constants = CompilationContext::Current().getConstants();
+        for (auto symbol : symbol::GetSymbol(getNames(), namespaces))
+        {
+            auto it = constants.find(symbol);
+            if (it != constants.end())
+            {
+                return folder.makeInteger(it->second, mType, mToken); // Enum fields have no type until they are emitted, which makes them i32 like their emitted constants
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool ScopeResolution::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        std::vector<std::string> namespaces = scope ? scope->getNamespaces() : std::vector<std::string>();
+        auto& constants = CompilationContext::Current().getConstants();
+        for (auto symbol : symbol::GetSymbol(getNames(), namespaces))
+        {
+            auto it = constants.find(symbol);
+            if (it != constants.end())
+            {
+                result = ConstexprValue{ mType ? mType : Type::Get("i32"), it->second };
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     std::vector<std::string> ScopeResolution::getNames()
     {
         std::vector<std::string> ret;
@@ -60,13 +98,14 @@ namespace parser
 
     vipir::Value* ScopeResolution::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
-        std::vector<std::string> symbols = symbol::GetSymbol(getNames(), scope->getNamespaces());
+        std::vector<symbol::SymbolID> symbols = symbol::GetSymbol(getNames(), scope->getNamespaces());
+        auto& globalVariables = CompilationContext::Current().getGlobalVariables();
         
         for (auto symbol : symbols)
         {
-            if (GlobalVariables.find(symbol) != GlobalVariables.end())
+            if (globalVariables.find(symbol) != globalVariables.end())
             {
-                vipir::Value* value = GlobalVariables[symbol].global;
+                vipir::Value* value = globalVariables[symbol].global;
                 if (value->isConstant()) return value;
 
                 if (value->getType()->isPointerType()) return builder.CreateLoad(value); // TODO: Something better than this
@@ -1,4 +1,6 @@
 #include "parser/ast/expression/SizeofExpression.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Constant/ConstantInt.h>
 
@@ -20,6 +22,22 @@ namespace parser
         }
     }
 
+    ASTNodePtr SizeofExpression::fold(ConstantFolder& folder, Scope* scope)
+    {
+        if (!mType->isIntegerType())
+        {
+            return nullptr;
+        }
+
+        return folder.makeInteger(mTypeToSize->getSize() / 8, mType, mPreferredDebugToken);
+    }
+
+    bool SizeofExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        result = ConstexprValue{ mType, mTypeToSize->getSize() / 8 };
+        return true;
+    }
+
     vipir::Value* SizeofExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         return vipir::ConstantInt::Get(module, mTypeToSize->getSize() / 8, mType->getVipirType());
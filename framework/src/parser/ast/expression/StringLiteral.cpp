@@ -1,6 +1,7 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/expression/StringLiteral.h"
+#include "parser/Interpreter.h"
 
 #include "type/PointerType.h"
 
@@ -27,9 +28,19 @@ namespace parser
             }
     }
 
+    ASTNodePtr StringLiteral::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool StringLiteral::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false; // Pointers have no address to point to at compile time
+    }
+
     vipir::Value* StringLiteral::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
-        vipir::GlobalString* string = vipir::GlobalString::Create(module, std::move(mValue));
+        vipir::GlobalString* string = vipir::GlobalString::Create(module, mValue); // Copied, an inlined body is emitted once for each call
 
         return builder.CreateAddrOf(string);
     }
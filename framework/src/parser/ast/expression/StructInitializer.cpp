@@ -2,6 +2,8 @@
 
 
 #include "parser/ast/expression/StructInitializer.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Constant/ConstantStruct.h>
 
@@ -39,6 +41,28 @@ namespace parser
         }
     }
 
+    ASTNodePtr StructInitializer::fold(ConstantFolder& folder, Scope* scope)
+    {
+        for (auto& node : mBody)
+        {
+            folder.fold(node, scope);
+        }
+
+        return nullptr;
+    }
+
+    bool StructInitializer::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        ConstexprValue value{ mType };
+        for (auto& node : mBody)
+        {
+            if (!node->evaluate(interpreter, scope, value.elements.emplace_back())) return false;
+        }
+
+        result = std::move(value);
+        return true;
+    }
+
     vipir::Value* StructInitializer::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         std::vector<vipir::Value*> values;
@@ -2,6 +2,10 @@
 
 
 #include "parser/ast/expression/UnaryExpression.h"
+#include "parser/ast/expression/VariableExpression.h"
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include "type/PointerType.h"
 
@@ -103,61 +107,98 @@ namespace parser
         mOperand->typeCheck(scope, diag);
     }
 
-    vipir::Value* UnaryExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
+    ASTNodePtr UnaryExpression::fold(ConstantFolder& folder, Scope* scope)
     {
-        vipir::Value* operand = mOperand->emit(builder, module, scope, diag);
+        if (mOperator != Operator::Negate && mOperator != Operator::BitwiseNot && mOperator != Operator::Indirection)
+        {
+            mOperand->fold(folder, scope); // Increments and address-of need their operand to stay an lvalue, only its children can fold
+            return nullptr;
+        }
 
-        switch(mOperator)
+        folder.fold(mOperand, scope);
+
+        auto operand = dynamic_cast<IntegerLiteral*>(mOperand.get());
+        if (!operand || mOperator == Operator::Indirection || !mType->isIntegerType())
+        {
+            return nullptr;
+        }
+
+        uintmax_t value = operand->getValue();
+        if (mOperator == Operator::Negate)
+        {
+            return folder.makeInteger(0 - value, mType, mPreferredDebugToken);
+        }
+        return folder.makeInteger(~value, mType, mPreferredDebugToken);
+    }
+
+    bool UnaryExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        switch (mOperator)
         {
             case Operator::PreIncrement:
+            case Operator::PreDecrement:
+            case Operator::PostIncrement:
+            case Operator::PostDecrement:
             {
-                vipir::Value* ptr = vipir::getPointerOperand(operand);
-                checkAssignmentLvalue(ptr, diag);
-                vipir::Value* add;
-                if (mType->isPointerType())
-                    add = builder.CreateGEP(operand, vipir::ConstantInt::Get(module, 1, vipir::Type::GetIntegerType(32)));
-                else
-                    add = builder.CreateAdd(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
-                builder.CreateStore(ptr, add);
-                return add;
+                Interpreter::TemporaryScope temporaries(interpreter);
+                ConstexprValue* operand = mOperand->evaluateLvalue(interpreter, scope);
+                if (!operand || !operand->type->isIntegerType()) return false;
+
+                ConstexprValue old = *operand;
+                uintmax_t delta = (mOperator == Operator::PreIncrement || mOperator == Operator::PostIncrement) ? 1 : -1;
+                operand->integer = ConstantFolder::Wrap(uintmax_t(operand->integer) + delta, operand->type);
+
+                result = mPostfix ? std::move(old) : *operand;
+                return true;
             }
-            case Operator::PreDecrement:
+
+            case Operator::Negate:
+            case Operator::BitwiseNot:
             {
-                vipir::Value* ptr = vipir::getPointerOperand(operand);
-                checkAssignmentLvalue(ptr, diag);
-                vipir::Value* sub;
-                if (mType->isPointerType())
-                    sub = builder.CreateGEP(operand, vipir::ConstantInt::Get(module, -1, vipir::Type::GetIntegerType(32)));
-                else
-                    sub = builder.CreateSub(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
-                builder.CreateStore(ptr, sub);
-                return sub;
+                ConstexprValue operand;
+                if (!mOperand->evaluate(interpreter, scope, operand) || !mType->isIntegerType()) return false;
+
+                uintmax_t value = operand.integer;
+                result = ConstexprValue{ mType, ConstantFolder::Wrap(mOperator == Operator::Negate ? 0 - value : ~value, mType) };
+                return true;
             }
+
+            default:
+                return false; // Pointers have no address to point to at compile time
+        }
+    }
+
+    vipir::Value* UnaryExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
+    {
+        vipir::Value* operand = mOperand->emit(builder, module, scope, diag);
+
+        switch(mOperator)
+        {
+            case Operator::PreIncrement:
+            case Operator::PreDecrement:
             case Operator::PostIncrement:
+            case Operator::PostDecrement:
             {
-                vipir::Value* ptr = vipir::getPointerOperand(operand);
-                checkAssignmentLvalue(ptr, diag);
-                vipir::Value* load = builder.CreateLoad(ptr);
-                vipir::Value* add;
+                bool increment = mOperator == Operator::PreIncrement || mOperator == Operator::PostIncrement;
+
+                vipir::Value* step;
                 if (mType->isPointerType())
-                    add = builder.CreateGEP(operand, vipir::ConstantInt::Get(module, 1, vipir::Type::GetIntegerType(32)));
+                    step = builder.CreateGEP(operand, vipir::ConstantInt::Get(module, increment ? 1 : -1, vipir::Type::GetIntegerType(32)));
+                else if (increment)
+                    step = builder.CreateAdd(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
                 else
-                    add = builder.CreateAdd(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
-                builder.CreateStore(ptr, add);
-                return load;
-            }
-            case Operator::PostDecrement:
-            {
+                    step = builder.CreateSub(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
+
+                if (LocalSymbol* local = VariableExpression::FindPromotedLocal(mOperand.get(), scope))
+                {
+                    local->value = step;
+                    return mPostfix ? operand : step;
+                }
+
                 vipir::Value* ptr = vipir::getPointerOperand(operand);
                 checkAssignmentLvalue(ptr, diag);
-                vipir::Value* load = builder.CreateLoad(ptr);
-                vipir::Value* sub;
-                if (mType->isPointerType())
-                    sub = builder.CreateGEP(operand, vipir::ConstantInt::Get(module, -1, vipir::Type::GetIntegerType(32)));
-                else
-                    sub = builder.CreateSub(operand, vipir::ConstantInt::Get(module, 1, mType->getVipirType()));
-                builder.CreateStore(ptr, sub);
-                return load;
+                builder.CreateStore(ptr, step);
+                return mPostfix ? operand : step;
             }
             case Operator::Negate:
                 return builder.CreateNeg(operand);
@@ -1,7 +1,10 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/expression/VariableExpression.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/Identifier.h"
 
 #include <vipir/IR/Instruction/AllocaInst.h>
@@ -22,33 +25,108 @@ namespace parser
         return mName;
     }
 
+    LocalSymbol* VariableExpression::FindPromotedLocal(ASTNode* node, Scope* scope)
+    {
+        auto variable = dynamic_cast<VariableExpression*>(node);
+        if (!variable || !scope)
+        {
+            return nullptr;
+        }
+
+        LocalSymbol* local = scope->findVariable(variable->mName);
+        if (!local || !local->value)
+        {
+            return nullptr;
+        }
+        return local;
+    }
+
     void VariableExpression::typeCheck(Scope* scope, diagnostic::Diagnostics& diag)
     {
     }
 
+    ASTNodePtr VariableExpression::fold(ConstantFolder& folder, Scope* scope)
+    {
+        if (auto value = folder.findLocal(scope, mName))
+        {
+            return folder.makeInteger(*value, mType, mToken);
+        }
+        if (scope && scope->findVariable(mName))
+        {
+            return nullptr;
+        }
+
+        std::vector<std::string> namespaces = scope ? scope->getNamespaces() : std::vector<std::string>();
+        auto& constants = CompilationContext::Current().getConstants();
+        for (auto symbol : symbol::GetSymbol({mName}, namespaces))
+        {
+            auto it = constants.find(symbol);
+            if (it != constants.end())
+            {
+                return folder.makeInteger(it->second, mType, mToken);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool VariableExpression::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        if (ConstexprValue* local = evaluateLvalue(interpreter, scope))
+        {
+            result = *local;
+            return true;
+        }
+        if (scope && scope->findVariable(mName))
+        {
+            return false;
+        }
+
+        std::vector<std::string> namespaces = scope ? scope->getNamespaces() : std::vector<std::string>();
+        auto& constants = CompilationContext::Current().getConstants();
+        for (auto symbol : symbol::GetSymbol({mName}, namespaces))
+        {
+            auto it = constants.find(symbol);
+            if (it != constants.end())
+            {
+                result = ConstexprValue{ mType ? mType : Type::Get("i32"), it->second };
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    ConstexprValue* VariableExpression::evaluateLvalue(Interpreter& interpreter, Scope* scope)
+    {
+        return interpreter.findLocal(scope, mName);
+    }
+
     vipir::Value* VariableExpression::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         LocalSymbol* local = scope->findVariable(mName);
 
-        std::vector<std::string> symbols = symbol::GetSymbol({mName}, scope->getNamespaces());
-
         if (local)
         {
+            if (local->value) return local->value;
             if (local->alloca->isConstant()) return local->alloca;
 
             return builder.CreateLoad(local->alloca);
         }
         else
         {
-            for (auto& symbol : symbols)
+            std::vector<symbol::SymbolID> symbols = symbol::GetSymbol({mName}, scope->getNamespaces());
+            auto& globalFunctions = CompilationContext::Current().getGlobalFunctions();
+            auto& globalVariables = CompilationContext::Current().getGlobalVariables();
+            for (auto symbol : symbols)
             {
-                if (GlobalFunctions.find(symbol) != GlobalFunctions.end())
+                if (globalFunctions.find(symbol) != globalFunctions.end())
                 {
-                    return GlobalFunctions.at(symbol).function;
+                    return globalFunctions.at(symbol).function;
                 }
-                else if (GlobalVariables.find(symbol) != GlobalVariables.end())
+                else if (globalVariables.find(symbol) != globalVariables.end())
                 {
-                    vipir::Value* value = GlobalVariables[symbol].global;
+                    vipir::Value* value = globalVariables[symbol].global;
                     if (value->isConstant()) return value;
 
                     if (value->getType()->isPointerType()) return builder.CreateLoad(value); // TODO: Something better than this
@@ -2,7 +2,9 @@
 
 
 #include "parser/ast/global/EnumDeclaration.h"
+#include "parser/Interpreter.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/Identifier.h"
 
 #include "type/EnumType.h"
@@ -26,6 +28,7 @@ namespace parser
             std::vector<std::string> names = mNames;
             names.push_back(field.name);
 
+            CompilationContext::Current().getConstants()[symbol::Intern(mangledName)] = field.value;
             symbol::AddIdentifier(std::move(mangledName), std::move(names));
         }
     }
@@ -34,6 +37,16 @@ namespace parser
     {
     }
 
+    ASTNodePtr EnumDeclaration::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool EnumDeclaration::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* EnumDeclaration::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         for (auto& field : mFields)
@@ -41,7 +54,7 @@ namespace parser
             std::string mangledName = "_EM" + field.name;
 
             vipir::Value* constant = vipir::ConstantInt::Get(module, field.value, vipir::Type::GetIntegerType(32));
-            GlobalVariables[mangledName] = GlobalSymbol(constant, mType);
+            CompilationContext::Current().getGlobalVariables()[symbol::Intern(mangledName)] = GlobalSymbol(constant, mType);
         }
 
         return nullptr;
@@ -3,9 +3,14 @@
 #include "parser/ast/global/Function.h"
 
 #include "parser/ast/statement/ReturnStatement.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/NameMangling.h"
 
+#include "support/Trace.h"
+
 #include <vipir/IR/Function.h>
 #include <vipir/IR/BasicBlock.h>
 #include <vipir/IR/Constant/ConstantInt.h>
@@ -24,6 +29,14 @@ namespace parser
         , mBody(std::move(body))
         , mScope(scope)
     {
+        for (auto& argument : mArguments)
+        {
+            mInlineFunction.parameters.push_back(argument.name);
+        }
+        mInlineFunction.returnType = getReturnType();
+        mInlineFunction.body = &mBody;
+        mInlineFunction.scope = scope;
+        mInlineFunction.policy = Inliner::GetPolicy(mAttributes);
     }
 
     Type* Function::getReturnType() const
@@ -31,8 +44,48 @@ namespace parser
         return static_cast<FunctionType*>(mType)->getReturnType();
     }
 
+    Type* Function::getFunctionType() const
+    {
+        return mType;
+    }
+
+    const std::vector<FunctionArgument>& Function::getArguments() const
+    {
+        return mArguments;
+    }
+
+    Scope* Function::getScope() const
+    {
+        return mScope.get();
+    }
+
+    std::vector<ASTNodePtr>& Function::getBody()
+    {
+        return mBody;
+    }
+
+    InlineFunction& Function::getInlineFunction()
+    {
+        return mInlineFunction;
+    }
+
+    void Function::setBody(std::vector<ASTNodePtr> body, Scope* scope)
+    {
+        mBody = std::move(body);
+        mScope = ScopePtr(scope);
+        mInlineFunction.scope = scope;
+    }
+
+    void Function::setSourceRange(SourceRange sourceRange)
+    {
+        mSourceRange = sourceRange;
+        mInlineFunction.size = sourceRange.tokenEnd - sourceRange.tokenStart;
+    }
+
     void Function::typeCheck(Scope* scope, diagnostic::Diagnostics& diag)
     {
+        support::Trace::Span span("typeCheck", mName, mSourceRange.fileName, mSourceRange.tokenStart, mSourceRange.tokenEnd);
+
         if (mScope)
         {
             scope = mScope.get();
@@ -44,8 +97,30 @@ namespace parser
         }
     }
 
+    ASTNodePtr Function::fold(ConstantFolder& folder, Scope* scope)
+    {
+        if (mScope)
+        {
+            scope = mScope.get();
+        }
+
+        for (auto& node : mBody)
+        {
+            folder.fold(node, scope);
+        }
+
+        return nullptr;
+    }
+
+    bool Function::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* Function::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
+        support::Trace::Span span("emit", mName, mSourceRange.fileName, mSourceRange.tokenStart, mSourceRange.tokenEnd);
+
         if (!mBody.empty()) scope = mScope.get();
 
         std::vector<Type*> manglingArguments;
@@ -72,9 +147,11 @@ namespace parser
         vipir::FunctionType* functionType = static_cast<vipir::FunctionType*>(mType->getVipirType());
         vipir::Function* func;
 
-        if (GlobalFunctions.contains(name))
+        auto& globalFunctions = CompilationContext::Current().getGlobalFunctions();
+        auto it = globalFunctions.find(symbol::Intern(name));
+        if (it != globalFunctions.end())
         {
-            func = GlobalFunctions[name].function;
+            func = it->second.function;
             assert(func->getFunctionType() == functionType);
             // assert func is empty
         }
@@ -92,11 +169,21 @@ namespace parser
         vipir::BasicBlock* entryBasicBlock = vipir::BasicBlock::Create("", func);
         builder.setInsertPoint(entryBasicBlock);
 
+        scope->clearSSAValues();
+        mInlineFunction.emitting = true;
+
         int index = 0;
         for (auto& argument : mArguments)
         {
+            LocalSymbol& local = scope->locals[argument.name];
+            if (local.canPromote())
+            {
+                local.value = func->getArgument(index++);
+                continue;
+            }
+
             vipir::AllocaInst* alloca = builder.CreateAlloca(argument.type->getVipirType());
-            scope->locals[argument.name].alloca = alloca;
+            local.alloca = alloca;
 
             builder.CreateStore(alloca, func->getArgument(index++));
         }
@@ -118,6 +205,8 @@ namespace parser
             }
         }
 
+        mInlineFunction.emitting = false;
+
         return func;
     }
 
@@ -2,7 +2,10 @@
 
 
 #include "parser/ast/global/GlobalDeclaration.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/Identifier.h"
 
 #include <vipir/Module.h>
@@ -22,7 +25,7 @@ namespace parser
             mangledName += name;
         }
         symbol::AddIdentifier(mangledName, mNames);
-        GlobalVariables[mangledName] = GlobalSymbol(nullptr, mType);
+        CompilationContext::Current().getGlobalVariables()[symbol::Intern(mangledName)] = GlobalSymbol(nullptr, mType);
     }
 
     void GlobalDeclaration::typeCheck(Scope* scope, diagnostic::Diagnostics& diag)
@@ -39,6 +42,18 @@ namespace parser
         }
     }
 
+    ASTNodePtr GlobalDeclaration::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mInitVal, scope);
+
+        return nullptr;
+    }
+
+    bool GlobalDeclaration::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* GlobalDeclaration::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         std::string mangledName = "_G" + mType->getMangleID();
@@ -48,11 +63,13 @@ namespace parser
             mangledName += name;
         }
 
+        symbol::SymbolID id = symbol::Intern(mangledName);
+        auto& globalVariables = CompilationContext::Current().getGlobalVariables();
         vipir::GlobalVar* global;
 
-        if (GlobalVariables.contains(mangledName))
+        if (globalVariables.contains(id))
         {
-            global = dynamic_cast<vipir::GlobalVar*>(GlobalVariables[mangledName].global);
+            global = dynamic_cast<vipir::GlobalVar*>(globalVariables[id].global);
             if (!global)
             {
                 global = module.createGlobalVar(mType->getVipirType());
@@ -69,7 +86,7 @@ namespace parser
             global->setInitialValue(initVal);
         }
 
-        GlobalVariables[mangledName] = GlobalSymbol(global, mType);
+        globalVariables[id] = GlobalSymbol(global, mType);
 
         return nullptr;
     }
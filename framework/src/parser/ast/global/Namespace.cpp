@@ -2,6 +2,8 @@
 
 
 #include "parser/ast/global/Namespace.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 namespace parser
 {
@@ -20,6 +22,23 @@ namespace parser
         }
     }
 
+    ASTNodePtr Namespace::fold(ConstantFolder& folder, Scope* scope)
+    {
+        scope = mScope.get();
+
+        for (auto& node : mBody)
+        {
+            folder.fold(node, scope);
+        }
+
+        return nullptr;
+    }
+
+    bool Namespace::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* Namespace::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         scope = mScope.get();
@@ -2,12 +2,17 @@
 
 
 #include "parser/ast/global/StructDeclaration.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include "type/StructType.h"
 #include "type/PointerType.h"
 
+#include "symbol/CompilationContext.h"
 #include "symbol/NameMangling.h"
 
+#include "support/Trace.h"
+
 #include <vipir/IR/BasicBlock.h>
 #include <vipir/Type/FunctionType.h>
 
@@ -43,6 +48,23 @@ namespace parser
             std::string name = symbol::mangleFunctionName(names, std::move(manglingArguments));
 
             FunctionSymbol::Create(nullptr, name, names, method.type, method.priv);
+
+            if (!method.body.empty())
+            {
+                InlineFunction& inlineFunction = method.inlineFunction;
+                inlineFunction.parameters.push_back("this");
+                for (auto& argument : method.arguments)
+                {
+                    inlineFunction.parameters.push_back(argument.name);
+                }
+                inlineFunction.returnType = static_cast<FunctionType*>(method.type)->getReturnType();
+                inlineFunction.body = &method.body;
+                inlineFunction.scope = method.scope.get();
+                inlineFunction.size = method.sourceRange.tokenEnd - method.sourceRange.tokenStart;
+                inlineFunction.policy = Inliner::GetPolicy(method.attributes);
+
+                CompilationContext::Current().getInlineFunctions()[symbol::Intern(name)] = &inlineFunction;
+            }
         }
     }
 
@@ -65,6 +87,8 @@ namespace parser
     {
         for (auto& method : mMethods)
         {
+            support::Trace::Span span("typeCheck", mNames.back() + "::" + method.name, method.sourceRange.fileName, method.sourceRange.tokenStart, method.sourceRange.tokenEnd);
+
             if (method.scope)
             {
                 scope = method.scope.get();
@@ -77,10 +101,34 @@ namespace parser
         }
     }
 
+    ASTNodePtr StructDeclaration::fold(ConstantFolder& folder, Scope* scope)
+    {
+        for (auto& method : mMethods)
+        {
+            if (method.scope)
+            {
+                scope = method.scope.get();
+            }
+            for (auto& node : method.body)
+            {
+                folder.fold(node, scope);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool StructDeclaration::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* StructDeclaration::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         for (StructMethod& method : mMethods)
         {
+            support::Trace::Span span("emit", mNames.back() + "::" + method.name, method.sourceRange.fileName, method.sourceRange.tokenStart, method.sourceRange.tokenEnd);
+
             std::vector<Type*> manglingArguments;
             std::vector<vipir::Type*> argumentTypes;
 
@@ -99,8 +147,11 @@ namespace parser
             names.push_back(method.name);
             std::string name = symbol::mangleFunctionName(names, std::move(manglingArguments));
 
-            vipir::Function* func = vipir::Function::Create(functionType, module, name);
-            GlobalFunctions[name].function = func;
+            vipir::Function*& func = CompilationContext::Current().getGlobalFunctions()[symbol::Intern(name)].function;
+            if (!func) // The hoisted declaration and the definition share one function
+            {
+                func = vipir::Function::Create(functionType, module, name);
+            }
 
             if (method.body.empty())
             {
@@ -112,17 +163,35 @@ namespace parser
             vipir::BasicBlock* entryBasicBlock = vipir::BasicBlock::Create("", func);
             builder.setInsertPoint(entryBasicBlock);
 
+            scope->clearSSAValues();
+            method.inlineFunction.emitting = true;
+
             int index = 0;
 
-            vipir::AllocaInst* alloca = builder.CreateAlloca(vipir::Type::GetPointerType(mType->getVipirType()));
-            scope->locals["this"].alloca = alloca;
+            LocalSymbol& self = scope->locals["this"];
+            if (self.canPromote())
+            {
+                self.value = func->getArgument(index++);
+            }
+            else
+            {
+                vipir::AllocaInst* alloca = builder.CreateAlloca(vipir::Type::GetPointerType(mType->getVipirType()));
+                self.alloca = alloca;
 
-            builder.CreateStore(alloca, func->getArgument(index++));
+                builder.CreateStore(alloca, func->getArgument(index++));
+            }
 
             for (auto& argument : method.arguments)
             {
+                LocalSymbol& local = scope->locals[argument.name];
+                if (local.canPromote())
+                {
+                    local.value = func->getArgument(index++);
+                    continue;
+                }
+
                 vipir::AllocaInst* alloca = builder.CreateAlloca(argument.type->getVipirType());
-                scope->locals[argument.name].alloca = alloca;
+                local.alloca = alloca;
 
                 builder.CreateStore(alloca, func->getArgument(index++));
             }
@@ -131,6 +200,8 @@ namespace parser
             {
                 node->emit(builder, module, scope, diag);
             }
+
+            method.inlineFunction.emitting = false;
         }
 
         return nullptr;
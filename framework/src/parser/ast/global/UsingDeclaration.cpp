@@ -2,6 +2,7 @@
 
 
 #include "parser/ast/global/UsingDeclaration.h"
+#include "parser/Interpreter.h"
 
 #include <utility>
 
@@ -18,6 +19,16 @@ namespace parser
     {
     }
 
+    ASTNodePtr UsingDeclaration::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool UsingDeclaration::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return false;
+    }
+
     vipir::Value* UsingDeclaration::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         return nullptr;
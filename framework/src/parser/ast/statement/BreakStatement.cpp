@@ -2,6 +2,7 @@
 
 
 #include "parser/ast/statement/BreakStatement.h"
+#include "parser/Interpreter.h"
 
 namespace parser
 {
@@ -14,6 +15,17 @@ namespace parser
     {
     }
 
+    ASTNodePtr BreakStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool BreakStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        interpreter.setFlow(Interpreter::Flow::Break);
+        return true;
+    }
+
     vipir::Value* BreakStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::BasicBlock* breakTo = scope->findBreakBB();
@@ -23,6 +35,7 @@ namespace parser
             diag.compilerError(mToken.getStart(), mToken.getEnd(), "break statement not within loop");
         }
 
+        scope->addSSAEdge(builder, breakTo);
         builder.CreateBr(breakTo);
 
         return nullptr;
@@ -1,6 +1,8 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/statement/CompoundStatement.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Instruction/RetInst.h>
 
@@ -22,9 +24,27 @@ namespace parser
         }
     }
 
+    ASTNodePtr CompoundStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        scope = mScope.get();
+
+        for (auto& node : mBody)
+        {
+            folder.fold(node, scope);
+        }
+
+        return nullptr;
+    }
+
+    bool CompoundStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        return interpreter.run(mBody, mScope.get());
+    }
+
     vipir::Value* CompoundStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         scope = mScope.get();
+        scope->clearSSAValues();
 
         for (ASTNodePtr& node : mBody)
         {
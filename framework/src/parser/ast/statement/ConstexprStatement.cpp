@@ -1,4 +1,9 @@
 #include "parser/ast/statement/ConstexprStatement.h"
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
+
+#include "symbol/CompilationContext.h"
 #include "symbol/Identifier.h"
 
 namespace parser
@@ -13,14 +18,9 @@ namespace parser
 
         if (mGlobal)
         {
-            std::string mangledName = "_CE" + mType->getMangleID();
-            for (auto& name : mNames)
-            {
-                mangledName += std::to_string(name.length());
-                mangledName += name;
-            }
+            std::string mangledName = getMangledName();
             symbol::AddIdentifier(mangledName, mNames);
-            GlobalVariables[mangledName] = GlobalSymbol(nullptr, mType);
+            CompilationContext::Current().getGlobalVariables()[symbol::Intern(mangledName)] = GlobalSymbol(nullptr, mType);
         }
     }
 
@@ -38,6 +38,41 @@ namespace parser
         }
     }
 
+    ASTNodePtr ConstexprStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mValue, scope);
+
+        auto literal = dynamic_cast<IntegerLiteral*>(mValue.get());
+        if (!literal)
+        {
+            return nullptr;
+        }
+
+        if (mGlobal)
+        {
+            CompilationContext::Current().getConstants()[symbol::Intern(getMangledName())] = literal->getValue();
+        }
+        else if (mNames.size() == 1)
+        {
+            folder.addLocal(scope, mNames[0], literal->getValue());
+        }
+
+        return nullptr;
+    }
+
+    bool ConstexprStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        if (mGlobal || mNames.size() != 1)
+        {
+            return false;
+        }
+
+        ConstexprValue value;
+        if (!mValue->evaluate(interpreter, scope, value)) return false;
+
+        return interpreter.declareLocal(scope, mNames[0], std::move(value));
+    }
+
     vipir::Value* ConstexprStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         if (!mValue) return nullptr;
@@ -53,17 +88,21 @@ namespace parser
         }
         else
         {
-            std::string mangledName = "_CE" + mType->getMangleID();
-            for (auto& name : mNames)
-            {
-                mangledName += std::to_string(name.length());
-                mangledName += name;
-            }
-
             vipir::Value* constant = mValue->emit(builder, module, scope, diag);
-            GlobalVariables[mangledName] = GlobalSymbol(constant, mType);
+            CompilationContext::Current().getGlobalVariables()[symbol::Intern(getMangledName())] = GlobalSymbol(constant, mType);
         }
 
         return nullptr;
     }
+
+    std::string ConstexprStatement::getMangledName()
+    {
+        std::string mangledName = "_CE" + mType->getMangleID();
+        for (auto& name : mNames)
+        {
+            mangledName += std::to_string(name.length());
+            mangledName += name;
+        }
+        return mangledName;
+    }
 }
\ No newline at end of file
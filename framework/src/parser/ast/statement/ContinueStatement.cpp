@@ -1,4 +1,5 @@
 #include "parser/ast/statement/ContinueStatement.h"
+#include "parser/Interpreter.h"
 
 namespace parser
 {
@@ -11,6 +12,17 @@ namespace parser
     {
     }
 
+    ASTNodePtr ContinueStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        return nullptr;
+    }
+
+    bool ContinueStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        interpreter.setFlow(Interpreter::Flow::Continue);
+        return true;
+    }
+
     vipir::Value* ContinueStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::BasicBlock* continueTo = scope->findContinueBB();
@@ -20,6 +32,7 @@ namespace parser
             diag.compilerError(mToken.getStart(), mToken.getEnd(), "continue statement not within loop");
         }
 
+        scope->addSSAEdge(builder, continueTo);
         builder.CreateBr(continueTo);
 
         return nullptr;
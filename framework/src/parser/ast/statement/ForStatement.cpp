@@ -1,6 +1,8 @@
 #include "parser/ast/statement/ForStatement.h"
 
 #include "parser/ast/expression/BooleanLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 namespace parser
 {
@@ -34,6 +36,48 @@ namespace parser
         mBody->typeCheck(scope, diag);
     }
 
+    ASTNodePtr ForStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        scope = mScope.get();
+
+        folder.fold(mInit, scope);
+        folder.fold(mCondition, scope);
+        for (auto& node : mLoopExpr)
+        {
+            folder.fold(node, scope);
+        }
+        folder.fold(mBody, scope);
+
+        return nullptr;
+    }
+
+    bool ForStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        scope = mScope.get();
+
+        if (mInit && !mInit->evaluate(interpreter, scope, result)) return false;
+
+        while (interpreter.step())
+        {
+            if (mCondition)
+            {
+                ConstexprValue condition;
+                if (!mCondition->evaluate(interpreter, scope, condition)) return false;
+                if (!condition.integer) return true;
+            }
+
+            if (!mBody->evaluate(interpreter, scope, result)) return false;
+            if (!interpreter.continueLoop()) return true;
+
+            for (auto& node : mLoopExpr)
+            {
+                ConstexprValue value;
+                if (!node->evaluate(interpreter, scope, value)) return false;
+            }
+        }
+        return false;
+    }
+
     vipir::Value* ForStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::BasicBlock* conditionBasicBlock = vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent());
@@ -41,6 +85,7 @@ namespace parser
         vipir::BasicBlock* doneBasicBlock = vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent());
 
         scope = mScope.get();
+        scope->clearSSAValues();
         scope->breakTo = doneBasicBlock;
         scope->continueTo = conditionBasicBlock;
 
@@ -52,19 +97,7 @@ namespace parser
 
         if (!mCondition)
         {
-            builder.CreateBr(bodyBasicBlock);
-            builder.setInsertPoint(bodyBasicBlock);
-
-            mBody->emit(builder, module, scope, diag);
-            for (auto& node : mLoopExpr)
-            {
-                node->emit(builder, module, scope, diag);
-            }
-
-            builder.CreateBr(bodyBasicBlock);
-
-            builder.setInsertPoint(doneBasicBlock);
-
+            emitEndlessLoop(builder, module, scope, diag, bodyBasicBlock, doneBasicBlock);
             return nullptr;
         }
 
@@ -74,28 +107,23 @@ namespace parser
             conditionBasicBlock->loopEnd() = nullptr;
             if (boolean->getValue())
             {
-                builder.CreateBr(bodyBasicBlock);
-                builder.setInsertPoint(bodyBasicBlock);
-
-                mBody->emit(builder, module, scope, diag);
-                for (auto& node : mLoopExpr) {
-                    node->emit(builder, module, scope, diag);
-                }
-
-                builder.CreateBr(bodyBasicBlock);
+                emitEndlessLoop(builder, module, scope, diag, bodyBasicBlock, doneBasicBlock);
             }
             else
             {
                 builder.CreateBr(doneBasicBlock);
+                builder.setInsertPoint(doneBasicBlock);
             }
-
-            builder.setInsertPoint(doneBasicBlock);
             return nullptr;
         }
 
+        SSAEdge entry = scope->getSSAEdge(builder);
         builder.CreateBr(conditionBasicBlock);
         builder.setInsertPoint(conditionBasicBlock);
+        auto phis = scope->createLoopPhis(builder, entry);
+
         vipir::Value* condition = mCondition->emit(builder, module, scope, diag);
+        SSAEdge exit = scope->getSSAEdge(builder);
         builder.CreateCondBr(condition, bodyBasicBlock, doneBasicBlock);
 
         builder.setInsertPoint(bodyBasicBlock);
@@ -106,10 +134,38 @@ namespace parser
             node->emit(builder, module, scope, diag);
         }
 
-        builder.CreateBr(conditionBasicBlock);
+        std::vector<SSAEdge> backEdges = scope->takeSSAEdges(conditionBasicBlock);
+        scope->branchWithSSAEdge(builder, conditionBasicBlock, backEdges);
+        Scope::CompleteLoopPhis(phis, backEdges);
 
         builder.setInsertPoint(doneBasicBlock);
+        std::vector<SSAEdge> exits = scope->takeSSAEdges(doneBasicBlock);
+        exits.insert(exits.begin(), std::move(exit));
+        scope->joinSSAEdges(builder, exits);
 
         return nullptr;
     }
-}
\ No newline at end of file
+
+    void ForStatement::emitEndlessLoop(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::BasicBlock* bodyBasicBlock, vipir::BasicBlock* doneBasicBlock)
+    {
+        scope->continueTo = bodyBasicBlock; // Nothing is emitted into the condition block
+
+        SSAEdge entry = scope->getSSAEdge(builder);
+        builder.CreateBr(bodyBasicBlock);
+        builder.setInsertPoint(bodyBasicBlock);
+        auto phis = scope->createLoopPhis(builder, entry);
+
+        mBody->emit(builder, module, scope, diag);
+        for (auto& node : mLoopExpr)
+        {
+            node->emit(builder, module, scope, diag);
+        }
+
+        std::vector<SSAEdge> backEdges = scope->takeSSAEdges(bodyBasicBlock);
+        scope->branchWithSSAEdge(builder, bodyBasicBlock, backEdges);
+        Scope::CompleteLoopPhis(phis, backEdges);
+
+        builder.setInsertPoint(doneBasicBlock);
+        scope->joinSSAEdges(builder, scope->takeSSAEdges(doneBasicBlock));
+    }
+}
@@ -1,6 +1,8 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/statement/IfStatement.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Instruction/RetInst.h>
 
@@ -28,6 +30,31 @@ namespace parser
             mElseBody->typeCheck(scope, diag);
     }
 
+    ASTNodePtr IfStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mCondition, scope);
+        folder.fold(mBody, scope);
+        folder.fold(mElseBody, scope);
+
+        return nullptr;
+    }
+
+    bool IfStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        ConstexprValue condition;
+        if (!mCondition->evaluate(interpreter, scope, condition)) return false;
+
+        if (condition.integer)
+        {
+            return mBody->evaluate(interpreter, scope, result);
+        }
+        if (mElseBody)
+        {
+            return mElseBody->evaluate(interpreter, scope, result);
+        }
+        return true;
+    }
+
     vipir::Value* IfStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* condition = mCondition->emit(builder, module, scope, diag);
@@ -43,27 +70,33 @@ namespace parser
 
         trueBasicBlock->loopEnd() = mergeBasicBlock;
 
+        SSAEdge entry = scope->getSSAEdge(builder);
+        std::vector<SSAEdge> edges;
         if (mElseBody)
         {
             builder.CreateCondBr(condition, trueBasicBlock, falseBasicBlock);
         }
         else
         {
+            if (scope->isReachable(builder))
+                edges.push_back(entry);
             builder.CreateCondBr(condition, trueBasicBlock, mergeBasicBlock);
         }
 
         builder.setInsertPoint(trueBasicBlock);
         mBody->emit(builder, module, scope, diag);
-        builder.CreateBr(mergeBasicBlock);
+        scope->branchWithSSAEdge(builder, mergeBasicBlock, edges);
+        scope->restoreSSAEdge(entry);
 
         if (mElseBody)
         {
             builder.setInsertPoint(falseBasicBlock);
             mElseBody->emit(builder, module, scope, diag);
-            builder.CreateBr(mergeBasicBlock);
+            scope->branchWithSSAEdge(builder, mergeBasicBlock, edges);
         }
 
         builder.setInsertPoint(mergeBasicBlock);
+        scope->joinSSAEdges(builder, edges);
 
         return nullptr;
     }
@@ -1,9 +1,13 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/statement/ReturnStatement.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Instruction/RetInst.h>
 
+#include <vipir/IR/BasicBlock.h>
+
 namespace parser
 {
     ReturnStatement::ReturnStatement(ASTNodePtr&& returnValue)
@@ -11,6 +15,11 @@ namespace parser
     {
     }
 
+    ASTNode* ReturnStatement::getReturnValue() const
+    {
+        return mReturnValue.get();
+    }
+
     void ReturnStatement::typeCheck(Scope* scope, diagnostic::Diagnostics& diag)
     {
         Type* returnType = mReturnValue ? mReturnValue->getType() : Type::Get("void");
@@ -24,6 +33,24 @@ namespace parser
             mReturnValue->typeCheck(scope, diag);
     }
 
+    ASTNodePtr ReturnStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mReturnValue, scope);
+
+        return nullptr;
+    }
+
+    bool ReturnStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        if (mReturnValue && !mReturnValue->evaluate(interpreter, scope, interpreter.getReturnValue()))
+        {
+            return false;
+        }
+
+        interpreter.setFlow(Interpreter::Flow::Return);
+        return true;
+    }
+
     vipir::Value* ReturnStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* returnValue = nullptr;
@@ -32,6 +59,22 @@ namespace parser
             returnValue = mReturnValue->emit(builder, module, scope, diag);
         }
 
+        if (InlineReturn* inlineReturn = scope->findInlineReturn())
+        {
+            if (!scope->isReachable(builder)) // Adds no value to the join
+            {
+                scope->endUnreachable(builder);
+                return nullptr;
+            }
+
+            if (!inlineReturn->block)
+            {
+                inlineReturn->block = vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent());
+            }
+            inlineReturn->values.emplace_back(returnValue, builder.getInsertPoint());
+            return builder.CreateBr(inlineReturn->block);
+        }
+
         return builder.CreateRet(returnValue);
     }
 
@@ -4,10 +4,108 @@
 #include "parser/ast/statement/ContinueStatement.h"
 #include "parser/ast/statement/ReturnStatement.h"
 
+#include "parser/ast/expression/IntegerLiteral.h"
+#include "parser/ast/expression/ScopeResolution.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
+
+#include "symbol/CompilationContext.h"
+#include "symbol/Identifier.h"
+
+#include "type/ArrayType.h"
+#include "type/IntegerType.h"
+
 #include <vipir/IR/Instruction/BinaryInst.h>
+#include <vipir/IR/Instruction/SExtInst.h>
+#include <vipir/IR/Instruction/ZExtInst.h>
+#include <vipir/IR/Constant/ConstantArray.h>
+#include <vipir/IR/Constant/ConstantInt.h>
+#include <vipir/IR/GlobalVar.h>
+#include <vipir/Module.h>
+
+#include <algorithm>
 
 namespace parser
 {
+    // Below this many cases a chain of compares costs no more than a tree
+    constexpr std::size_t MinCasesForTree = 4;
+
+    // Ranges of a decision tree's leaves are tested one after another
+    constexpr std::size_t LeafRanges = 2;
+
+    // Lookup tables fill the gaps between cases with the default, so they must be mostly cases
+    constexpr std::size_t MaxTableEntriesPerCase = 4;
+    constexpr std::size_t MaxTableSize = 4096;
+
+    // Consecutive case values that go to the same body
+    struct CaseRange
+    {
+        intmax_t low;
+        intmax_t high;
+        int body;
+    };
+
+    // A compare and branch in a lowered switch. A target is the test with that index, or if
+    // it is negative the body -target - 1, where one past the last body is the end block
+    struct SwitchTest
+    {
+        enum class Compare { Equal, Less, Greater };
+
+        Compare compare;
+        intmax_t constant;
+        int onTrue;
+        int onFalse;
+    };
+
+    static int BodyTarget(int body)
+    {
+        return -body - 1;
+    }
+
+    // Plans the tests for ranges[first, last), between which the value is known to lie if low and high are set
+    static int PlanDecisionTree(std::vector<SwitchTest>& tests, const std::vector<CaseRange>& ranges, std::size_t first, std::size_t last,
+        std::optional<intmax_t> low, std::optional<intmax_t> high, int miss)
+    {
+        if (last - first <= LeafRanges)
+        {
+            // Each range is tried in ascending order, so a value below a range's low end falls between ranges
+            int next = miss;
+            for (std::size_t i = last; i-- > first;)
+            {
+                const CaseRange& range = ranges[i];
+                bool aboveLow = i == first && low && *low >= range.low;
+                bool belowHigh = high && *high <= range.high;
+
+                int entry = BodyTarget(range.body);
+                if (range.low == range.high && !(aboveLow && belowHigh))
+                {
+                    tests.push_back({SwitchTest::Compare::Equal, range.low, entry, next});
+                    next = tests.size() - 1;
+                    continue;
+                }
+                if (!belowHigh)
+                {
+                    tests.push_back({SwitchTest::Compare::Greater, range.high, next, entry});
+                    entry = tests.size() - 1;
+                }
+                if (!aboveLow)
+                {
+                    tests.push_back({SwitchTest::Compare::Less, range.low, miss, entry});
+                    entry = tests.size() - 1;
+                }
+                next = entry;
+            }
+            return next;
+        }
+
+        std::size_t middle = first + (last - first) / 2;
+        int left = PlanDecisionTree(tests, ranges, first, middle, low, ranges[middle].low - 1, miss);
+        int right = PlanDecisionTree(tests, ranges, middle, last, ranges[middle].low, high, miss);
+        tests.push_back({SwitchTest::Compare::Less, ranges[middle].low, left, right});
+        return tests.size() - 1;
+    }
+
+
     SwitchStatement::SwitchStatement(ASTNodePtr&& value, std::vector<SwitchSection>&& sections)
         : mValue(std::move(value))
         , mSections(std::move(sections))
@@ -27,6 +125,60 @@ namespace parser
         }
     }
 
+    ASTNodePtr SwitchStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mValue, scope);
+
+        for (auto& section : mSections)
+        {
+            folder.fold(section.label, scope);
+            for (auto& node : section.body)
+            {
+                folder.fold(node, scope);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool SwitchStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        ConstexprValue value;
+        if (!mValue->evaluate(interpreter, scope, value)) return false;
+
+        // Labels are tried in order like the emitted compare chain, so a default stops the search
+        std::size_t start = mSections.size();
+        for (std::size_t i = 0; i < mSections.size(); ++i)
+        {
+            if (!mSections[i].label)
+            {
+                start = i;
+                break;
+            }
+
+            ConstexprValue label;
+            if (!mSections[i].label->evaluate(interpreter, scope, label)) return false;
+            if (label.integer == value.integer)
+            {
+                start = i;
+                break;
+            }
+        }
+
+        // Sections fall through into the next one until something changes the flow
+        for (std::size_t i = start; i < mSections.size(); ++i)
+        {
+            if (!interpreter.run(mSections[i].body, scope)) return false;
+            if (interpreter.getFlow() != Interpreter::Flow::Normal) break;
+        }
+
+        if (interpreter.getFlow() == Interpreter::Flow::Break)
+        {
+            interpreter.setFlow(Interpreter::Flow::Normal);
+        }
+        return true;
+    }
+
     vipir::Value* SwitchStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::Value* value = mValue->emit(builder, module, scope, diag);
@@ -34,6 +186,108 @@ namespace parser
         if (mSections.empty())
             return nullptr;
 
+        // The compare chain never reaches sections after the default, so neither do the other lowerings
+        int defaultSection = std::find_if(mSections.begin(), mSections.end(), [](const SwitchSection& section) {
+            return !section.label;
+        }) - mSections.begin();
+
+        // The tree compares values as signed, which is only right for unsigned values that can't have their top bit set
+        Type* type = mValue->getType();
+        auto isOrdered = [type](intmax_t label) {
+            if (type->isEnumType()) return true;
+            if (!type->isIntegerType()) return false;
+
+            IntegerType* integerType = static_cast<IntegerType*>(type);
+            return integerType->isSigned() || (label >= 0 && (integerType->getSize() >= 64 || label < (intmax_t(1) << (integerType->getSize() - 1))));
+        };
+
+        std::vector<Case> cases;
+        for (int i = 0; i < defaultSection; ++i)
+        {
+            std::optional<intmax_t> label = getLabelValue(mSections[i].label.get(), scope);
+            if (!label || !isOrdered(*label))
+            {
+                cases.clear();
+                break;
+            }
+            cases.push_back({*label, i});
+        }
+
+        if (cases.size() < MinCasesForTree)
+        {
+            emitCompareChain(builder, module, scope, diag, value);
+            return nullptr;
+        }
+
+        // The first section with a value is the one the compare chain would pick
+        std::stable_sort(cases.begin(), cases.end(), [](const Case& lhs, const Case& rhs) {
+            return lhs.value < rhs.value;
+        });
+        cases.erase(std::unique(cases.begin(), cases.end(), [](const Case& lhs, const Case& rhs) {
+            return lhs.value == rhs.value;
+        }), cases.end());
+
+        if (!emitLookupTable(builder, module, scope, value, cases, defaultSection))
+        {
+            emitDecisionTree(builder, module, scope, diag, value, cases, defaultSection);
+        }
+
+        return nullptr;
+    }
+
+
+    // Case labels are compared as they are emitted unless they are literals or enum fields
+    std::optional<intmax_t> SwitchStatement::getLabelValue(ASTNode* label, Scope* scope)
+    {
+        if (auto literal = dynamic_cast<IntegerLiteral*>(label))
+        {
+            return literal->getValue();
+        }
+
+        if (auto resolution = dynamic_cast<ScopeResolution*>(label))
+        {
+            auto& constants = CompilationContext::Current().getConstants();
+            for (auto symbol : symbol::GetSymbol(resolution->getNames(), scope->getNamespaces()))
+            {
+                auto it = constants.find(symbol);
+                if (it != constants.end()) return it->second;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Empty bodies fall through, so a case can go straight to the next body with something in it
+    int SwitchStatement::getBodyFor(int section)
+    {
+        while (section < static_cast<int>(mSections.size()) && mSections[section].body.empty())
+        {
+            ++section;
+        }
+        return section;
+    }
+
+    // The value section returns if its body only returns an integer literal
+    std::optional<intmax_t> SwitchStatement::getReturnedConstant(int section)
+    {
+        int body = getBodyFor(section);
+        if (body == static_cast<int>(mSections.size()) || mSections[body].body.size() != 1)
+            return std::nullopt;
+
+        auto returnStatement = dynamic_cast<ReturnStatement*>(mSections[body].body.front().get());
+        if (!returnStatement)
+            return std::nullopt;
+
+        auto literal = dynamic_cast<IntegerLiteral*>(returnStatement->getReturnValue());
+        if (!literal)
+            return std::nullopt;
+
+        return literal->getValue();
+    }
+
+
+    void SwitchStatement::emitCompareChain(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::Value* value)
+    {
         std::vector<vipir::BasicBlock*> conditionBlocks;
         std::vector<vipir::BasicBlock*> bodyBlocks;
 
@@ -43,6 +297,7 @@ namespace parser
             bodyBlocks.push_back(vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent()));
 
         vipir::BasicBlock* endBlock = vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent());
+        vipir::BasicBlock* breakTo = scope->breakTo;
         scope->breakTo = endBlock;
 
         for (int i = 0; i < mSections.size(); i++)
@@ -50,7 +305,7 @@ namespace parser
             auto& sec = mSections[i];
             auto conditionBlock = conditionBlocks[i];
             auto bodyBlock = bodyBlocks[i];
-            
+
             builder.setInsertPoint(conditionBlock);
             if (sec.label)
             {
@@ -71,8 +326,152 @@ namespace parser
                 node->emit(builder, module, scope, diag);
         }
 
+        endSwitch(builder, scope, endBlock, breakTo);
+    }
+
+    // Binary search over the case values, with runs of values that share a body tested as one range
+    void SwitchStatement::emitDecisionTree(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag, vipir::Value* value, const std::vector<Case>& cases, int defaultSection)
+    {
+        std::vector<CaseRange> ranges;
+        for (auto& switchCase : cases)
+        {
+            int body = getBodyFor(switchCase.section);
+            if (!ranges.empty() && ranges.back().body == body && switchCase.value - 1 == ranges.back().high)
+                ranges.back().high = switchCase.value;
+            else
+                ranges.push_back({switchCase.value, switchCase.value, body});
+        }
+
+        int miss = BodyTarget(getBodyFor(defaultSection)); // The end block if there is no default
+
+        std::vector<SwitchTest> tests;
+        int root = PlanDecisionTree(tests, ranges, 0, ranges.size(), std::nullopt, std::nullopt, miss);
+
+        // Bodies keep their order after the tests, since one without a break falls through into the next
+        vipir::Function* function = builder.getInsertPoint()->getParent();
+        std::vector<vipir::BasicBlock*> testBlocks;
+        for (std::size_t i = 0; i < tests.size(); ++i)
+            testBlocks.push_back(vipir::BasicBlock::Create("", function));
+
+        std::vector<vipir::BasicBlock*> bodyBlocks;
+        for (std::size_t i = 0; i < mSections.size(); ++i)
+            bodyBlocks.push_back(vipir::BasicBlock::Create("", function));
+
+        vipir::BasicBlock* endBlock = vipir::BasicBlock::Create("", function);
+        bodyBlocks.push_back(endBlock);
+        vipir::BasicBlock* breakTo = scope->breakTo;
+        scope->breakTo = endBlock;
+
+        auto getBlock = [&](int target) {
+            return target >= 0 ? testBlocks[target] : bodyBlocks[-target - 1];
+        };
+
+        builder.CreateBr(getBlock(root));
+        for (std::size_t i = 0; i < tests.size(); ++i)
+        {
+            builder.setInsertPoint(testBlocks[i]);
+
+            vipir::Value* constant = vipir::ConstantInt::Get(module, tests[i].constant, mValue->getType()->getVipirType());
+            vipir::Value* condition;
+            switch (tests[i].compare)
+            {
+                case SwitchTest::Compare::Equal:
+                    condition = builder.CreateCmpEQ(value, constant);
+                    break;
+                case SwitchTest::Compare::Less:
+                    condition = builder.CreateCmpLT(value, constant);
+                    break;
+                case SwitchTest::Compare::Greater:
+                    condition = builder.CreateCmpGT(value, constant);
+                    break;
+            }
+            builder.CreateCondBr(condition, getBlock(tests[i].onTrue), getBlock(tests[i].onFalse));
+        }
+
+        for (std::size_t i = 0; i < mSections.size(); ++i)
+        {
+            builder.setInsertPoint(bodyBlocks[i]);
+            for (auto& node : mSections[i].body)
+                node->emit(builder, module, scope, diag);
+        }
+
+        endSwitch(builder, scope, endBlock, breakTo);
+    }
+
+    // A switch whose cases all return constants becomes a bounds check and a load from a table of them
+    bool SwitchStatement::emitLookupTable(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, vipir::Value* value, const std::vector<Case>& cases, int defaultSection)
+    {
+        Type* returnType = scope->currentReturnType;
+        if (scope->findInlineReturn()) // Returns from a body emitted in place of a call don't leave the function
+            return false;
+        if (defaultSection == static_cast<int>(mSections.size()) || !returnType || !returnType->isIntegerType())
+            return false;
+
+        intmax_t low = cases.front().value;
+        intmax_t high = cases.back().value;
+        uintmax_t span = static_cast<uintmax_t>(high) - static_cast<uintmax_t>(low); // Can't overflow, unlike high - low
+        if (span >= MaxTableSize || span >= cases.size() * MaxTableEntriesPerCase)
+            return false;
+
+        std::optional<intmax_t> defaultValue = getReturnedConstant(defaultSection);
+        if (!defaultValue)
+            return false;
+
+        std::vector<intmax_t> entries(span + 1, *defaultValue);
+        for (auto& switchCase : cases)
+        {
+            std::optional<intmax_t> returned = getReturnedConstant(switchCase.section);
+            if (!returned)
+                return false;
+            entries[switchCase.value - low] = *returned;
+        }
+
+        std::vector<vipir::Value*> values;
+        for (intmax_t entry : entries)
+        {
+            values.push_back(vipir::ConstantInt::Get(module, entry, returnType->getVipirType()));
+        }
+
+        Type* tableType = ArrayType::Create(returnType, entries.size());
+        vipir::GlobalVar* table = module.createGlobalVar(tableType->getVipirType());
+        table->setInitialValue(vipir::ConstantArray::Get(module, tableType->getVipirType(), std::move(values)));
+
+        vipir::Function* function = builder.getInsertPoint()->getParent();
+        vipir::BasicBlock* highCheckBlock = vipir::BasicBlock::Create("", function);
+        vipir::BasicBlock* lookupBlock = vipir::BasicBlock::Create("", function);
+        vipir::BasicBlock* defaultBlock = vipir::BasicBlock::Create("", function);
+        vipir::BasicBlock* endBlock = vipir::BasicBlock::Create("", function); // Nothing reaches what follows the switch
+
+        vipir::Type* valueType = mValue->getType()->getVipirType();
+        builder.CreateCondBr(builder.CreateCmpLT(value, vipir::ConstantInt::Get(module, low, valueType)), defaultBlock, highCheckBlock);
+
+        builder.setInsertPoint(highCheckBlock);
+        builder.CreateCondBr(builder.CreateCmpGT(value, vipir::ConstantInt::Get(module, high, valueType)), defaultBlock, lookupBlock);
+
+        // The span can be wider than the value's type holds, e.g. -100 to 100 in an i8, so the index is computed in 64 bits
+        builder.setInsertPoint(lookupBlock);
+        vipir::Type* indexType = vipir::Type::GetIntegerType(64);
+        if (mValue->getType()->getSize() < 64)
+        {
+            value = ConstantFolder::IsSigned(mValue->getType()) ? builder.CreateSExt(value, indexType) : builder.CreateZExt(value, indexType);
+        }
+        vipir::Value* index = builder.CreateSub(value, vipir::ConstantInt::Get(module, low, indexType));
+        vipir::Value* entry = builder.CreateGEP(table, index);
+        builder.CreateRet(builder.CreateLoad(entry));
+
+        builder.setInsertPoint(defaultBlock);
+        builder.CreateRet(vipir::ConstantInt::Get(module, *defaultValue, returnType->getVipirType()));
+
         builder.setInsertPoint(endBlock);
+        return true;
+    }
 
-        return nullptr;
+    void SwitchStatement::endSwitch(vipir::IRBuilder& builder, Scope* scope, vipir::BasicBlock* endBlock, vipir::BasicBlock* breakTo)
+    {
+        // Locals written in a switch stay in memory, so every break leaves with the values the switch was entered with
+        scope->takeSSAEdges(endBlock);
+        scope->breakTo = breakTo;
+
+        builder.setInsertPoint(endBlock);
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,11 @@
 // Copyright 2024 solar-mist
 
 #include "parser/ast/statement/VariableDeclaration.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
+#include <vipir/IR/Constant/ConstantInt.h>
+#include <vipir/IR/Constant/ConstantNullPtr.h>
 #include <vipir/IR/Instruction/AllocaInst.h>
 #include <vipir/IR/Instruction/StoreInst.h>
 
@@ -28,8 +32,52 @@ namespace parser
         }
     }
 
+    ASTNodePtr VariableDeclaration::fold(ConstantFolder& folder, Scope* scope)
+    {
+        folder.fold(mInitialValue, scope);
+
+        return nullptr;
+    }
+
+    bool VariableDeclaration::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        ConstexprValue value;
+        if (mInitialValue)
+        {
+            if (!mInitialValue->evaluate(interpreter, scope, value)) return false;
+        }
+        else if (!interpreter.makeZero(mType, value))
+        {
+            return false;
+        }
+
+        return interpreter.declareLocal(scope, mName, std::move(value));
+    }
+
     vipir::Value* VariableDeclaration::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
+        LocalSymbol& local = scope->locals[mName];
+        if (local.canPromote())
+        {
+            if (mInitialValue)
+            {
+                local.value = mInitialValue->emit(builder, module, scope, diag);
+            }
+            else if (mType->isBooleanType())
+            {
+                local.value = builder.CreateConstantBool(false);
+            }
+            else if (mType->isPointerType())
+            {
+                local.value = vipir::ConstantNullPtr::Get(module, mType->getVipirType());
+            }
+            else
+            {
+                local.value = vipir::ConstantInt::Get(module, 0, mType->getVipirType());
+            }
+            return nullptr;
+        }
+
         vipir::AllocaInst* alloca = builder.CreateAlloca(mType->getVipirType());
 
         if (mInitialValue)
@@ -2,6 +2,8 @@
 
 #include "parser/ast/statement/WhileStatement.h"
 #include "parser/ast/expression/BooleanLiteral.h"
+#include "parser/ConstantFolder.h"
+#include "parser/Interpreter.h"
 
 #include <vipir/IR/Instruction/RetInst.h>
 
@@ -27,6 +29,32 @@ namespace parser
         mBody->typeCheck(scope, diag);
     }
 
+    ASTNodePtr WhileStatement::fold(ConstantFolder& folder, Scope* scope)
+    {
+        scope = mScope.get();
+
+        folder.fold(mCondition, scope);
+        folder.fold(mBody, scope);
+
+        return nullptr;
+    }
+
+    bool WhileStatement::evaluate(Interpreter& interpreter, Scope* scope, ConstexprValue& result)
+    {
+        scope = mScope.get();
+
+        while (interpreter.step())
+        {
+            ConstexprValue condition;
+            if (!mCondition->evaluate(interpreter, scope, condition)) return false;
+            if (!condition.integer) return true;
+
+            if (!mBody->evaluate(interpreter, scope, result)) return false;
+            if (!interpreter.continueLoop()) return true;
+        }
+        return false;
+    }
+
     vipir::Value* WhileStatement::emit(vipir::IRBuilder& builder, vipir::Module& module, Scope* scope, diagnostic::Diagnostics& diag)
     {
         vipir::BasicBlock* conditionBasicBlock = vipir::BasicBlock::Create("", builder.getInsertPoint()->getParent());
@@ -46,29 +74,50 @@ namespace parser
             conditionBasicBlock->loopEnd() = nullptr;
             if (boolean->getValue())
             {
+                scope->continueTo = bodyBasicBlock; // Nothing is emitted into the condition block
+
+                SSAEdge entry = scope->getSSAEdge(builder);
                 builder.CreateBr(bodyBasicBlock);
                 builder.setInsertPoint(bodyBasicBlock);
+                auto phis = scope->createLoopPhis(builder, entry);
+
                 mBody->emit(builder, module, scope, diag);
-                builder.CreateBr(bodyBasicBlock);
+
+                std::vector<SSAEdge> backEdges = scope->takeSSAEdges(bodyBasicBlock);
+                scope->branchWithSSAEdge(builder, bodyBasicBlock, backEdges);
+                Scope::CompleteLoopPhis(phis, backEdges);
+
+                builder.setInsertPoint(doneBasicBlock);
+                scope->joinSSAEdges(builder, scope->takeSSAEdges(doneBasicBlock));
             }
             else
             {
                 builder.CreateBr(doneBasicBlock);
+                builder.setInsertPoint(doneBasicBlock);
             }
-            builder.setInsertPoint(doneBasicBlock);
             return nullptr;
         }
 
+        SSAEdge entry = scope->getSSAEdge(builder);
         builder.CreateBr(conditionBasicBlock);
         builder.setInsertPoint(conditionBasicBlock);
+        auto phis = scope->createLoopPhis(builder, entry);
+
         vipir::Value* condition = mCondition->emit(builder, module, scope, diag);
+        SSAEdge exit = scope->getSSAEdge(builder);
         builder.CreateCondBr(condition, bodyBasicBlock, doneBasicBlock);
 
         builder.setInsertPoint(bodyBasicBlock);
         mBody->emit(builder, module, scope, diag);
-        builder.CreateBr(conditionBasicBlock);
+
+        std::vector<SSAEdge> backEdges = scope->takeSSAEdges(conditionBasicBlock);
+        scope->branchWithSSAEdge(builder, conditionBasicBlock, backEdges);
+        Scope::CompleteLoopPhis(phis, backEdges);
 
         builder.setInsertPoint(doneBasicBlock);
+        std::vector<SSAEdge> exits = scope->takeSSAEdges(doneBasicBlock);
+        exits.insert(exits.begin(), std::move(exit));
+        scope->joinSSAEdges(builder, exits);
 
         return nullptr;
     }
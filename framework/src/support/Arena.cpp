@@ -0,0 +1,49 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace support
+{
+    Arena::Arena()
+        : mCurrent(nullptr)
+        , mEnd(nullptr)
+        , mBytesAllocated(0)
+    {
+    }
+
+    void* Arena::allocate(std::size_t size, std::size_t alignment)
+    {
+        std::uintptr_t current = reinterpret_cast<std::uintptr_t>(mCurrent);
+        std::uintptr_t aligned = (current + alignment - 1) & ~(alignment - 1);
+
+        if (!mCurrent || aligned + size > reinterpret_cast<std::uintptr_t>(mEnd))
+        {
+            newBlock(size + alignment);
+            current = reinterpret_cast<std::uintptr_t>(mCurrent);
+            aligned = (current + alignment - 1) & ~(alignment - 1);
+        }
+
+        mCurrent = reinterpret_cast<std::byte*>(aligned + size);
+        mBytesAllocated += size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    std::size_t Arena::getBytesAllocated() const
+    {
+        return mBytesAllocated;
+    }
+
+    void Arena::newBlock(std::size_t minSize)
+    {
+        std::size_t size = std::max(BlockSize, minSize);
+
+        MemoryReport::Owning owning(MemoryReport::Owner::ArenaBlocks);
+        mBlocks.emplace_back(new std::byte[size]);
+        mCurrent = mBlocks.back().get();
+        mEnd = mCurrent + size;
+    }
+}
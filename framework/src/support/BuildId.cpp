@@ -0,0 +1,93 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/BuildId.h"
+
+#include <cstring>
+#include <format>
+
+#include <elf.h>
+#include <link.h>
+#include <sys/stat.h>
+
+#ifndef VIPER_VERSION
+#define VIPER_VERSION "unknown"
+#endif
+
+namespace support
+{
+    // The GNU build id note is a hash of the whole linked output, so it is empty if the object has none
+    static std::string FindBuildIdNote(const dl_phdr_info* info)
+    {
+        for (int i = 0; i < info->dlpi_phnum; ++i)
+        {
+            const ElfW(Phdr)& segment = info->dlpi_phdr[i];
+            if (segment.p_type != PT_NOTE) continue;
+
+            std::size_t alignment = segment.p_align == 8 ? 8 : 4;
+            auto align = [alignment](std::size_t size) { return (size + alignment - 1) & ~(alignment - 1); };
+
+            const char* position = reinterpret_cast<const char*>(info->dlpi_addr + segment.p_vaddr);
+            const char* end = position + segment.p_memsz;
+            while (static_cast<std::size_t>(end - position) >= sizeof(ElfW(Nhdr)))
+            {
+                ElfW(Nhdr) note;
+                std::memcpy(&note, position, sizeof(note));
+                const char* name = position + sizeof(note);
+                const char* description = name + align(note.n_namesz);
+                if (description + note.n_descsz > end) break;
+                position = description + align(note.n_descsz);
+
+                if (note.n_type == NT_GNU_BUILD_ID && note.n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0)
+                {
+                    std::string id;
+                    for (std::size_t j = 0; j < note.n_descsz; ++j)
+                    {
+                        id += std::format("{:02x}", static_cast<unsigned char>(description[j]));
+                    }
+                    return id;
+                }
+            }
+        }
+        return std::string();
+    }
+
+    static std::string FindBuildId()
+    {
+        struct Objects
+        {
+            std::string ids;
+            bool program{ true }; // The executable is always reported first
+        } objects;
+
+        dl_iterate_phdr([](dl_phdr_info* info, std::size_t, void* data) {
+            Objects& objects = *static_cast<Objects*>(data);
+            bool program = objects.program;
+            objects.program = false;
+
+            // vipir does the code generation, so a shared build of it is part of the compiler too
+            if (!program && (!info->dlpi_name || !std::strstr(info->dlpi_name, "vipir"))) return 0;
+
+            std::string id = FindBuildIdNote(info);
+            if (id.empty() && program)
+            {
+                // Linked without a build id, so the file itself stands in for it. Any relink changes it
+                struct stat status;
+                if (stat("/proc/self/exe", &status) == 0)
+                {
+                    id = std::format("{:x}-{:x}.{:x}", status.st_size, status.st_mtim.tv_sec, status.st_mtim.tv_nsec);
+                }
+            }
+            objects.ids += "+" + id;
+            return 0;
+        }, &objects);
+
+        return VIPER_VERSION + objects.ids;
+    }
+
+    const std::string& BuildId()
+    {
+        static const std::string buildId = FindBuildId();
+        return buildId;
+    }
+}
@@ -0,0 +1,18 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/Hash.h"
+
+namespace support
+{
+    std::uint64_t Hash(std::string_view data, std::uint64_t seed)
+    {
+        std::uint64_t hash = seed;
+        for (unsigned char c : data)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,280 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/MemoryReport.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <limits>
+#include <new>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace support
+{
+    static thread_local MemoryReport* currentReport = nullptr;
+    static thread_local MemoryReport::Owner currentOwner = MemoryReport::Owner::Other;
+    static thread_local bool bookkeeping = false; // The report's own allocations are not part of the compilation
+
+    static bool Recording()
+    {
+        return currentReport && !bookkeeping;
+    }
+
+    static constexpr std::size_t RepeatedPhase = std::numeric_limits<std::size_t>::max();
+
+    static constexpr std::string_view OwnerNames[] = {
+        "other",
+        "tokens",
+        "AST nodes",
+        "scopes",
+        "types",
+        "identifiers",
+        "vipir objects",
+        "arena blocks (hold the AST nodes and scopes)",
+    };
+    static_assert(std::size(OwnerNames) == static_cast<std::size_t>(MemoryReport::Owner::Count));
+
+    static double KiB(std::int64_t bytes)
+    {
+        return bytes / 1024.0;
+    }
+
+
+    MemoryReport::Owning::Owning(Owner owner)
+        : mPrevious(currentOwner)
+    {
+        currentOwner = owner;
+    }
+
+    MemoryReport::Owning::~Owning()
+    {
+        currentOwner = mPrevious;
+    }
+
+
+    MemoryReport::Phase::Phase(std::string_view name)
+        : mReport(currentReport)
+    {
+        if (mReport)
+        {
+            mReport->enterPhase(name);
+        }
+    }
+
+    MemoryReport::Phase::~Phase()
+    {
+        if (mReport)
+        {
+            mReport->exitPhase();
+        }
+    }
+
+
+    MemoryReport::MemoryReport()
+        : mLiveBytes(0)
+        , mHighWaterMark(0)
+    {
+    }
+
+    MemoryReport::~MemoryReport()
+    {
+        if (currentReport == this)
+        {
+            currentReport = nullptr;
+        }
+    }
+
+    MemoryReport* MemoryReport::Current()
+    {
+        return currentReport;
+    }
+
+    void MemoryReport::makeCurrent()
+    {
+        currentReport = this;
+    }
+
+    void MemoryReport::RecordAllocation(std::size_t bytes)
+    {
+        if (Recording())
+        {
+            currentReport->allocate(bytes);
+        }
+    }
+
+    void MemoryReport::RecordDeallocation(std::size_t bytes)
+    {
+        if (Recording())
+        {
+            currentReport->mLiveBytes -= bytes; // Can go below zero when freeing memory allocated before the report existed
+        }
+    }
+
+    void MemoryReport::countArenaObject(Owner owner, std::size_t bytes)
+    {
+        Usage& usage = mOwners[static_cast<std::size_t>(owner)];
+        ++usage.allocations;
+        usage.bytes += bytes;
+    }
+
+    void MemoryReport::print(std::ostream& stream, std::string_view fileName) const
+    {
+        bookkeeping = true;
+
+        std::string report = std::format("memory report for {}:\n", fileName);
+        report += std::format("  {:<48}{:>12}{:>14}{:>18}\n", "phase", "allocations", "KiB", "high-water KiB");
+        for (auto& phase : mPhases)
+        {
+            report += std::format("  {:<48}{:>12}{:>14.1f}{:>18.1f}\n", phase.name, phase.usage.allocations, KiB(phase.usage.bytes), KiB(phase.highWaterMark));
+        }
+        report += std::format("  {:<48}{:>12}{:>14.1f}{:>18.1f}\n", "total", mTotal.allocations, KiB(mTotal.bytes), KiB(mHighWaterMark));
+
+        report += "  by owner:\n";
+        for (std::size_t i = 0; i < mOwners.size(); ++i)
+        {
+            report += std::format("    {:<46}{:>12}{:>14.1f}\n", OwnerNames[i], mOwners[i].allocations, KiB(mOwners[i].bytes));
+        }
+
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        report += std::format("  peak RSS of the process: {} KiB\n", usage.ru_maxrss);
+
+        stream << report;
+
+        bookkeeping = false;
+    }
+
+    void MemoryReport::enterPhase(std::string_view name)
+    {
+        bookkeeping = true;
+
+        auto it = std::find_if(mPhases.begin(), mPhases.end(), [name](const PhaseMemory& phase) {
+            return phase.name == name;
+        });
+        if (it == mPhases.end())
+        {
+            mPhases.push_back({std::string(name), Usage(), mLiveBytes, 0});
+            it = mPhases.end() - 1;
+        }
+        ++it->count;
+
+        std::size_t index = it - mPhases.begin();
+        if (std::find(mActivePhases.begin(), mActivePhases.end(), index) != mActivePhases.end())
+        {
+            index = RepeatedPhase;
+        }
+        mActivePhases.push_back(index);
+
+        bookkeeping = false;
+    }
+
+    void MemoryReport::exitPhase()
+    {
+        mActivePhases.pop_back();
+    }
+
+    void MemoryReport::allocate(std::size_t bytes)
+    {
+        ++mTotal.allocations;
+        mTotal.bytes += bytes;
+
+        Usage& owner = mOwners[static_cast<std::size_t>(currentOwner)];
+        ++owner.allocations;
+        owner.bytes += bytes;
+
+        mLiveBytes += bytes;
+        mHighWaterMark = std::max(mHighWaterMark, mLiveBytes);
+
+        for (std::size_t index : mActivePhases)
+        {
+            if (index == RepeatedPhase) continue;
+
+            PhaseMemory& phase = mPhases[index];
+            ++phase.usage.allocations;
+            phase.usage.bytes += bytes;
+            phase.highWaterMark = std::max(phase.highWaterMark, mLiveBytes);
+        }
+    }
+}
+
+
+// Replacing the global allocation functions is the only way to see the allocations made inside
+// the standard library and vipir. Without a report they cost the thread-local check and nothing else
+namespace
+{
+    void* Allocate(std::size_t size)
+    {
+        void* pointer = std::malloc(size ? size : 1);
+        if (pointer && support::Recording())
+        {
+            support::MemoryReport::RecordAllocation(malloc_usable_size(pointer));
+        }
+        return pointer;
+    }
+
+    void Deallocate(void* pointer)
+    {
+        if (pointer && support::Recording())
+        {
+            support::MemoryReport::RecordDeallocation(malloc_usable_size(pointer));
+        }
+        std::free(pointer);
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* pointer = Allocate(size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    Deallocate(pointer);
+}
@@ -0,0 +1,114 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/Sha256.h"
+
+#include <bit>
+#include <format>
+
+namespace support
+{
+    static constexpr std::uint32_t RoundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    Sha256::Sha256()
+        : mState{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 }
+        , mBlock{}
+        , mBlockSize(0)
+        , mLength(0)
+    {
+    }
+
+    void Sha256::update(std::string_view data)
+    {
+        mLength += data.size();
+        for (unsigned char c : data)
+        {
+            mBlock[mBlockSize++] = c;
+            if (mBlockSize == mBlock.size())
+            {
+                compress(mBlock.data());
+                mBlockSize = 0;
+            }
+        }
+    }
+
+    std::string Sha256::hexDigest()
+    {
+        std::uint64_t bits = mLength * 8;
+
+        // A one bit, zeros up to the last 8 bytes of a block, then the length in bits
+        mBlock[mBlockSize++] = 0x80;
+        if (mBlockSize > mBlock.size() - 8)
+        {
+            while (mBlockSize < mBlock.size()) mBlock[mBlockSize++] = 0;
+            compress(mBlock.data());
+            mBlockSize = 0;
+        }
+        while (mBlockSize < mBlock.size() - 8) mBlock[mBlockSize++] = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+            mBlock[mBlockSize++] = static_cast<unsigned char>(bits >> (i * 8));
+        }
+        compress(mBlock.data());
+
+        std::string digest;
+        for (std::uint32_t word : mState)
+        {
+            digest += std::format("{:08x}", word);
+        }
+        return digest;
+    }
+
+    void Sha256::compress(const unsigned char* block)
+    {
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+        {
+            w[i] = std::uint32_t(block[i * 4]) << 24 | std::uint32_t(block[i * 4 + 1]) << 16 | std::uint32_t(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; ++i)
+        {
+            std::uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        auto [a, b, c, d, e, f, g, h] = mState;
+        for (int i = 0; i < 64; ++i)
+        {
+            std::uint32_t s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+            std::uint32_t choice = (e & f) ^ (~e & g);
+            std::uint32_t temp1 = h + s1 + choice + RoundConstants[i] + w[i];
+            std::uint32_t s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+            std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            std::uint32_t temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        mState[0] += a;
+        mState[1] += b;
+        mState[2] += c;
+        mState[3] += d;
+        mState[4] += e;
+        mState[5] += f;
+        mState[6] += g;
+        mState[7] += h;
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/TimeReport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <format>
+#include <memory>
+
+#include <cxxabi.h>
+
+namespace support
+{
+    static thread_local TimeReport* currentReport = nullptr;
+
+    static double WallSeconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static double CpuSeconds()
+    {
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return time.tv_sec + time.tv_nsec / 1e9;
+    }
+
+    static std::string Demangle(const char* name)
+    {
+        int status;
+        std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), &std::free);
+        return status == 0 ? std::string(demangled.get()) : std::string(name);
+    }
+
+
+    TimeReport::Phase::Phase(std::string_view name)
+        : mSpan(name)
+        , mMemoryPhase(name)
+        , mReport(currentReport)
+        , mWallStart(0)
+        , mCpuStart(0)
+    {
+        if (mReport)
+        {
+            mName = name;
+            mWallStart = WallSeconds();
+            mCpuStart = CpuSeconds();
+        }
+    }
+
+    TimeReport::Phase::~Phase()
+    {
+        if (mReport)
+        {
+            mReport->addTime(mName, WallSeconds() - mWallStart, CpuSeconds() - mCpuStart);
+        }
+    }
+
+
+    TimeReport::~TimeReport()
+    {
+        if (currentReport == this)
+        {
+            currentReport = nullptr;
+        }
+    }
+
+    TimeReport* TimeReport::Current()
+    {
+        return currentReport;
+    }
+
+    void TimeReport::makeCurrent()
+    {
+        currentReport = this;
+    }
+
+    TimeReport::Counters& TimeReport::getCounters()
+    {
+        return mCounters;
+    }
+
+    std::uint64_t TimeReport::getAllocationCount() const
+    {
+        std::uint64_t count = 0;
+        for (auto& [type, typeCount] : mAllocations)
+        {
+            count += typeCount;
+        }
+        return count;
+    }
+
+    void TimeReport::print(std::ostream& stream, std::string_view fileName) const
+    {
+        std::string report = std::format("time report for {}:\n", fileName);
+        report += std::format("  {:<48}{:>12}{:>12}{:>8}\n", "phase", "wall (s)", "cpu (s)", "count");
+        for (auto& phase : mPhases)
+        {
+            report += std::format("  {:<48}{:>12.6f}{:>12.6f}{:>8}\n", phase.name, phase.wallSeconds, phase.cpuSeconds, phase.count);
+        }
+
+        auto average = [](std::uint64_t total, std::uint64_t count) {
+            return count == 0 ? 0.0 : static_cast<double>(total) / count;
+        };
+
+        report += "  counters:\n";
+        report += std::format("    {:<46}{:>12}\n", "tokens", mCounters.tokens);
+        report += std::format("    {:<46}{:>12}\n", "identifiers", mCounters.identifiers);
+        report += std::format("    {:<46}{:>12}\n", "types", mCounters.types);
+        report += std::format("    {:<46}{:>12}  (average {:.2f} scopes searched)\n", "variable lookups", mCounters.variableLookups,
+            average(mCounters.variableLookupScopes, mCounters.variableLookups));
+        report += std::format("    {:<46}{:>12}  (average {:.2f} names tried)\n", "function lookups", mCounters.functionLookups,
+            average(mCounters.functionLookupCandidates, mCounters.functionLookups));
+
+        std::vector<std::pair<std::string, std::uint64_t> > allocations;
+        for (auto& [type, count] : mAllocations)
+        {
+            allocations.emplace_back(Demangle(type.name()), count);
+        }
+        std::sort(allocations.begin(), allocations.end());
+
+        report += "  nodes and scopes by kind:\n";
+        for (auto& [name, count] : allocations)
+        {
+            report += std::format("    {:<46}{:>12}\n", name, count);
+        }
+
+        stream << report;
+    }
+
+    void TimeReport::addTime(std::string_view name, double wallSeconds, double cpuSeconds)
+    {
+        auto it = std::find_if(mPhases.begin(), mPhases.end(), [name](const PhaseTime& phase) {
+            return phase.name == name;
+        });
+        if (it == mPhases.end())
+        {
+            mPhases.push_back({std::string(name), wallSeconds, cpuSeconds, 1});
+            return;
+        }
+
+        it->wallSeconds += wallSeconds;
+        it->cpuSeconds += cpuSeconds;
+        ++it->count;
+    }
+}
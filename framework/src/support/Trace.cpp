@@ -0,0 +1,152 @@
+// Copyright 2024 solar-mist
+
+
+#include "support/Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+
+namespace support
+{
+    static thread_local Trace* currentTrace = nullptr;
+
+    static std::uint32_t ThreadId()
+    {
+        static std::atomic<std::uint32_t> nextId = 1;
+        static thread_local std::uint32_t id = nextId++;
+        return id;
+    }
+
+    static std::string EscapeJson(std::string_view text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            switch (c)
+            {
+                case '"':
+                    escaped += "\\\"";
+                    break;
+                case '\\':
+                    escaped += "\\\\";
+                    break;
+                case '\n':
+                    escaped += "\\n";
+                    break;
+                case '\t':
+                    escaped += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        escaped += std::format("\\u{:04x}", static_cast<int>(c));
+                    }
+                    else
+                    {
+                        escaped += c;
+                    }
+                    break;
+            }
+        }
+        return escaped;
+    }
+
+
+    Trace::Span::Span(std::string_view name)
+        : Span(name, {}, {}, -1, -1)
+    {
+    }
+
+    Trace::Span::Span(std::string_view name, std::string_view detail, std::string_view fileName, int tokenStart, int tokenEnd)
+        : mTrace(currentTrace)
+        , mTokenStart(tokenStart)
+        , mTokenEnd(tokenEnd)
+        , mStart(0)
+    {
+        if (mTrace)
+        {
+            mName = name;
+            if (!detail.empty())
+            {
+                mName += ' ';
+                mName += detail;
+            }
+            mFileName = fileName;
+            mStart = mTrace->now();
+        }
+    }
+
+    Trace::Span::~Span()
+    {
+        if (mTrace)
+        {
+            mTrace->addEvent({std::move(mName), std::move(mFileName), mTokenStart, mTokenEnd, mStart, mTrace->now() - mStart, ThreadId()});
+        }
+    }
+
+
+    Trace::Trace()
+        : mStart(0)
+    {
+        mStart = now();
+    }
+
+    Trace::~Trace()
+    {
+        if (currentTrace == this)
+        {
+            currentTrace = nullptr;
+        }
+    }
+
+    Trace* Trace::Current()
+    {
+        return currentTrace;
+    }
+
+    void Trace::makeCurrent()
+    {
+        currentTrace = this;
+    }
+
+    bool Trace::writeFile(const std::filesystem::path& path) const
+    {
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (std::size_t i = 0; i < mEvents.size(); ++i)
+        {
+            const Event& event = mEvents[i];
+            json += std::format("{{\"name\":\"{}\",\"cat\":\"viper\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+                EscapeJson(event.name), event.thread, event.start, event.duration);
+            if (!event.fileName.empty())
+            {
+                json += std::format(",\"args\":{{\"source\":\"{}\"", EscapeJson(event.fileName));
+                if (event.tokenStart != -1)
+                {
+                    json += std::format(",\"tokens\":\"{}-{}\"", event.tokenStart, event.tokenEnd);
+                }
+                json += "}";
+            }
+            json += i + 1 == mEvents.size() ? "}\n" : "},\n";
+        }
+        json += "]}\n";
+
+        std::ofstream stream(path, std::ios::binary);
+        stream << json;
+        return static_cast<bool>(stream);
+    }
+
+    double Trace::now() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count() - mStart;
+    }
+
+    void Trace::addEvent(Event event)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEvents.push_back(std::move(event));
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright 2024 solar-mist
+
+
+#include "symbol/CompilationContext.h"
+
+#include <cassert>
+
+static thread_local CompilationContext* currentContext = nullptr;
+
+CompilationContext::CompilationContext()
+    : mTypes(mIdentifiers)
+{
+}
+
+CompilationContext::~CompilationContext()
+{
+    if (currentContext == this)
+    {
+        currentContext = nullptr;
+    }
+}
+
+CompilationContext& CompilationContext::Current()
+{
+    assert(currentContext && "no compilation context is current on this thread");
+    return *currentContext;
+}
+
+void CompilationContext::makeCurrent()
+{
+    currentContext = this;
+}
+
+symbol::IdentifierTable& CompilationContext::getIdentifiers()
+{
+    return mIdentifiers;
+}
+
+TypeContext& CompilationContext::getTypes()
+{
+    return mTypes;
+}
+
+std::unordered_map<symbol::SymbolID, FunctionSymbol>& CompilationContext::getGlobalFunctions()
+{
+    return mGlobalFunctions;
+}
+
+std::unordered_map<symbol::SymbolID, GlobalSymbol>& CompilationContext::getGlobalVariables()
+{
+    return mGlobalVariables;
+}
+
+std::unordered_map<symbol::SymbolID, intmax_t>& CompilationContext::getConstants()
+{
+    return mConstants;
+}
+
+std::unordered_map<symbol::SymbolID, parser::Function*>& CompilationContext::getConstexprFunctions()
+{
+    return mConstexprFunctions;
+}
+
+std::unordered_map<symbol::SymbolID, parser::InlineFunction*>& CompilationContext::getInlineFunctions()
+{
+    return mInlineFunctions;
+}
\ No newline at end of file
@@ -2,52 +2,156 @@
 
 
 #include "symbol/Identifier.h"
+#include "symbol/CompilationContext.h"
 
-#include <algorithm>
-#include <unordered_map>
+#include "support/MemoryReport.h"
 
 namespace symbol
 {
-    struct Identifier
+    std::size_t IdentifierTable::PathHash::operator()(const std::vector<SymbolID>& path) const
     {
-        std::string mangledName;
+        std::size_t hash = path.size();
+        for (SymbolID id : path)
+        {
+            hash ^= id + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+
+    SymbolID IdentifierTable::intern(std::string_view name)
+    {
+        support::MemoryReport::Owning owning(support::MemoryReport::Owner::Identifiers);
+
+        auto it = mStringIDs.find(name);
+        if (it != mStringIDs.end())
+        {
+            return it->second;
+        }
+
+        SymbolID id = mStrings.size();
+        std::string_view stored = mStrings.emplace_back(name);
+        mStringIDs.emplace(stored, id);
+        return id;
+    }
+
+    SymbolID IdentifierTable::find(std::string_view name) const
+    {
+        auto it = mStringIDs.find(name);
+        if (it != mStringIDs.end())
+        {
+            return it->second;
+        }
+        return InvalidSymbol;
+    }
+
+    std::string_view IdentifierTable::getString(SymbolID id) const
+    {
+        return mStrings[id];
+    }
+
+    std::size_t IdentifierTable::size() const
+    {
+        return mStrings.size();
+    }
 
-        std::vector<std::string> names;
-    };
+    PathID IdentifierTable::internPath(const std::vector<std::string>& names)
+    {
+        support::MemoryReport::Owning owning(support::MemoryReport::Owner::Identifiers);
+
+        std::vector<SymbolID> path;
+        path.reserve(names.size());
+        for (auto& name : names)
+        {
+            path.push_back(intern(name));
+        }
+
+        auto it = mPaths.find(path);
+        if (it != mPaths.end())
+        {
+            return it->second;
+        }
 
-    std::vector<Identifier> identifiers;
+        PathID id = mIdentifiers.size();
+        mPaths.emplace(std::move(path), id);
+        mIdentifiers.emplace_back();
+        return id;
+    }
 
-    void AddIdentifier(std::string mangledName, std::vector<std::string> names)
+    void IdentifierTable::addIdentifier(std::string_view mangledName, const std::vector<std::string>& names)
     {
-        if (std::find_if(identifiers.begin(), identifiers.end(), [&mangledName](const auto& ident){
-                return ident.mangledName == mangledName;
-            }) == identifiers.end())
+        support::MemoryReport::Owning owning(support::MemoryReport::Owner::Identifiers);
+
+        SymbolID id = intern(mangledName);
+        if (mDeclared.insert(id).second)
         {
-            identifiers.push_back({std::move(mangledName), std::move(names)});
+            mIdentifiers[internPath(names)].push_back(id);
         }
     }
 
-    std::vector<std::string> GetSymbol(std::vector<std::string> givenNames, std::vector<std::string> activeNames)
+    std::vector<SymbolID> IdentifierTable::getSymbol(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames) const
     {
-        std::vector<std::string> ret;
+        std::vector<SymbolID> ret;
 
+        // Build the path back to front so that each enclosing namespace can be prepended cheaply
+        std::vector<SymbolID> reversed;
+        reversed.reserve(givenNames.size() + activeNames.size());
+        for (auto it = givenNames.rbegin(); it != givenNames.rend(); ++it)
+        {
+            SymbolID id = find(*it);
+            if (id == InvalidSymbol) return ret; // A name that was never interned can't be part of any declaration
+            reversed.push_back(id);
+        }
+
+        auto active = activeNames.rbegin();
+        std::vector<SymbolID> path;
         while(true)
         {
-            for (auto& ident : identifiers)
-            {
-                if (ident.names == givenNames)
-                {
-                    ret.push_back(ident.mangledName);
-                }
-            }
-            if (!activeNames.empty())
+            path.assign(reversed.rbegin(), reversed.rend());
+            auto it = mPaths.find(path);
+            if (it != mPaths.end())
             {
-                givenNames.insert(givenNames.begin(), activeNames.back());
-                activeNames.pop_back();
+                auto& mangledNames = mIdentifiers[it->second];
+                ret.insert(ret.end(), mangledNames.begin(), mangledNames.end());
             }
-            else break;
+
+            if (active == activeNames.rend()) break;
+
+            SymbolID id = find(*active++);
+            if (id == InvalidSymbol) break;
+            reversed.push_back(id);
         }
 
         return ret;
     }
-}
\ No newline at end of file
+
+
+    SymbolID Intern(std::string_view name)
+    {
+        return CompilationContext::Current().getIdentifiers().intern(name);
+    }
+
+    SymbolID Find(std::string_view name)
+    {
+        return CompilationContext::Current().getIdentifiers().find(name);
+    }
+
+    std::string_view GetString(SymbolID id)
+    {
+        return CompilationContext::Current().getIdentifiers().getString(id);
+    }
+
+    PathID InternPath(const std::vector<std::string>& names)
+    {
+        return CompilationContext::Current().getIdentifiers().internPath(names);
+    }
+
+    void AddIdentifier(std::string_view mangledName, const std::vector<std::string>& names)
+    {
+        CompilationContext::Current().getIdentifiers().addIdentifier(mangledName, names);
+    }
+
+    std::vector<SymbolID> GetSymbol(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames)
+    {
+        return CompilationContext::Current().getIdentifiers().getSymbol(givenNames, activeNames);
+    }
+}
@@ -6,51 +6,217 @@
 #include "lexer/Lexer.h"
 #include "lexer/Token.h"
 
+#include "lexer/TokenStream.h"
+
 #include "parser/Parser.h"
 #include "parser/ImportParser.h"
 
-#include <fstream>
+#include "symbol/ModuleInterface.h"
+#include "symbol/ModuleCache.h"
+
+#include "support/Hash.h"
+#include "support/TimeReport.h"
+#include "support/Trace.h"
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <unordered_set>
 
 namespace symbol
 {
-    ImportManager::ImportManager()
-        : mSearchPaths{"./"}
+    struct ImportManager::Module
+    {
+        std::optional<lexing::TokenStream> tokens; // Imported nodes keep tokens for diagnostics, so the stream lives as long as the module
+        std::vector<parser::GlobalSymbol> symbols;
+        bool loading{ true };
+    };
+
+    ImportManager::ImportManager(lexing::SourceManager& sourceManager, support::Arena& arena)
+        : mSourceManager(sourceManager)
+        , mArena(arena)
+        , mSearchPaths{"./"}
+        , mEmitInterfaces(false)
+        , mModuleCache(nullptr)
     {
     }
 
+    ImportManager::~ImportManager() = default;
+
     void ImportManager::addSearchPath(std::string path)
     {
         mSearchPaths.push_back(path);
     }
 
+    void ImportManager::setEmitInterfaces(bool emitInterfaces)
+    {
+        mEmitInterfaces = emitInterfaces;
+    }
+
+    void ImportManager::setModuleCache(ModuleCache* moduleCache)
+    {
+        mModuleCache = moduleCache;
+    }
+
+    lexing::SourceBuffer* ImportManager::findModule(std::filesystem::path path)
+    {
+        path += ".vpr";
+
+        for (auto searchPath : mSearchPaths)
+        {
+            if (lexing::SourceBuffer* source = mSourceManager.open(searchPath / path))
+            {
+                return source;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<const lexing::SourceBuffer*> ImportManager::ScanDependencies(lexing::SourceBuffer& source, diagnostic::Diagnostics& diag)
+    {
+        std::vector<const lexing::SourceBuffer*> dependencies;
+        std::unordered_set<const lexing::SourceBuffer*> visited{ &source };
+
+        std::vector<lexing::SourceBuffer*> pending{ &source };
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            bool imported = i != 0;
+
+            diagnostic::Diagnostics importerDiag;
+            importerDiag.setErrorSender("viper");
+            importerDiag.setFileName(pending[i]->getPath());
+            importerDiag.setText(pending[i]->getText());
+            importerDiag.setImported(true);
+            importerDiag.setCollected(diag.getCollected());
+            importerDiag.setExitOnError(diag.getExitOnError());
+
+            lexing::Lexer lexer(*pending[i], imported ? importerDiag : diag);
+            lexing::TokenStream tokens = lexer.lex();
+
+            // The import keyword only starts import statements, so no parsing is needed to find them.
+            // Malformed ones are left for the compilation to report
+            for (std::size_t j = 0; j < tokens.size(); ++j)
+            {
+                if (tokens.getTokenType(j) != lexing::TokenType::ImportKeyword) continue;
+                bool exported = j != 0 && tokens.getTokenType(j - 1) == lexing::TokenType::ExportKeyword;
+
+                std::filesystem::path path;
+                while (++j < tokens.size() && tokens.getTokenType(j) == lexing::TokenType::Identifier)
+                {
+                    path /= tokens.getText(j);
+                    if (j + 1 == tokens.size() || tokens.getTokenType(j + 1) != lexing::TokenType::Dot) break;
+                    ++j;
+                }
+
+                if (imported && !exported) continue;
+
+                lexing::SourceBuffer* dependency = findModule(path);
+                if (dependency && visited.insert(dependency).second)
+                {
+                    dependencies.push_back(dependency);
+                    pending.push_back(dependency);
+                }
+            }
+        }
+
+        return dependencies;
+    }
+
+    std::vector<std::filesystem::path> ImportManager::getModulePaths() const
+    {
+        std::vector<std::filesystem::path> paths;
+        for (auto source : mLoadOrder)
+        {
+            paths.push_back(source->getPath());
+        }
+        return paths;
+    }
+
     std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>> ImportManager::ImportSymbols(std::filesystem::path path, diagnostic::Diagnostics& diag)
     {
+        lexing::SourceBuffer* source = findModule(path);
         path += ".vpr";
 
-        std::ifstream stream;
+        if (!source)
+        {
+            return {};
+        }
 
-        for (auto searchPath : mSearchPaths)
+        auto it = mModules.find(source);
+        if (it != mModules.end())
+        {
+            if (it->second->loading)
+            {
+                std::string cycle;
+                auto first = std::find(mImportStack.begin(), mImportStack.end(), source);
+                for (auto module = first; module != mImportStack.end(); ++module)
+                {
+                    cycle += std::format("{}' imports '", (*module)->getPath().string());
+                }
+                diag.fatalError(std::format("import cycle detected: '{}{}'", cycle, source->getPath().string()));
+            }
+            return {std::vector<parser::ASTNodePtr>(), it->second->symbols};
+        }
+
+        support::TimeReport::Phase phase(std::format("import {}", source->getPath().string()));
+
+        Module* module = (mModules[source] = std::make_unique<Module>()).get();
+        mLoadOrder.push_back(source);
+        mImportStack.push_back(source);
+
+        std::uint64_t sourceHash = support::Hash(source->getText());
+        std::filesystem::path interfacePath = source->getPath();
+        interfacePath.replace_extension(".vpi");
+
+        std::optional<std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>>> imported;
+        if (auto cached = mModuleCache ? mModuleCache->find(sourceHash) : nullptr)
+        {
+            imported = ReadModuleInterface(*cached, interfacePath, sourceHash, mArena, *this, diag);
+        }
+        if (!imported)
         {
-            stream.open(searchPath / path);
-            if (stream.is_open()) break;
+            imported = ReadModuleInterface(interfacePath, sourceHash, mArena, *this, diag);
         }
 
-        diagnostic::Diagnostics importerDiag;
+        std::vector<parser::ASTNodePtr> nodes;
+        if (imported)
+        {
+            nodes = std::move(imported->first);
+            module->symbols = std::move(imported->second);
+        }
+        else
+        {
+            diagnostic::Diagnostics importerDiag;
+
+            importerDiag.setErrorSender("viper");
+            importerDiag.setFileName(path);
+            importerDiag.setText(source->getText());
+            importerDiag.setImported(true);
+            importerDiag.setCollected(diag.getCollected());
+            importerDiag.setExitOnError(diag.getExitOnError());
 
-        std::stringstream buf;
-        buf << stream.rdbuf();
+            lexing::Lexer lexer(*source, importerDiag);
+            module->tokens.emplace(lexer.lex());
 
-        importerDiag.setErrorSender("viper");
-        importerDiag.setFileName(path);
-        importerDiag.setText(buf.str());
-        importerDiag.setImported(true);
+            support::Trace::Span span("parse", {}, source->getPath().native(), 0, static_cast<int>(module->tokens->size()));
+            parser::ImportParser parser(*module->tokens, importerDiag, *this, mArena);
+
+            nodes = parser.parse();
+            module->symbols = parser.getSymbols();
+
+            if (mEmitInterfaces)
+            {
+                parser.getInterface().writeFile(interfacePath, sourceHash); // Failing to write is harmless, the module is just parsed again next time
+            }
+            if (mModuleCache)
+            {
+                mModuleCache->insert(sourceHash, parser.getInterface().serialize(sourceHash)); // Two compilations may both parse a module before either inserts it, which only costs the duplicate parse
+            }
+        }
 
-        lexing::Lexer lexer(buf.str(), importerDiag);
-        auto tokens = lexer.lex();
+        module->loading = false;
+        mImportStack.pop_back();
 
-        parser::ImportParser parser(tokens, importerDiag, *this);
-        
-        auto nodes = parser.parse();
-        return {std::move(nodes), parser.getSymbols()};
+        return {std::move(nodes), module->symbols};
     }
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+// Copyright 2024 solar-mist
+
+
+#include "symbol/IncrementalCache.h"
+
+#include "support/BuildId.h"
+#include "support/Hash.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <thread>
+
+#include <unistd.h>
+
+namespace symbol
+{
+    constexpr char CacheMagic[4] = { 'V', 'P', 'C', '\0' };
+    constexpr std::uint32_t CacheFormatVersion = 2;
+
+    static std::uint64_t HashToken(const lexing::TokenStream& tokens, std::size_t index, std::uint64_t seed)
+    {
+        std::uint32_t tokenType = static_cast<std::uint32_t>(tokens.getTokenType(index));
+        seed = support::Hash(std::string_view(reinterpret_cast<const char*>(&tokenType), sizeof(tokenType)), seed);
+        return support::Hash(tokens.getText(index), seed);
+    }
+
+    static std::optional<std::string> ReadWholeFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return std::nullopt;
+
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    IncrementalCache::IncrementalCache(const lexing::TokenStream& tokens, std::vector<std::uint64_t> importHashes, std::uint64_t optionsHash)
+        : mOptionsHash(optionsHash)
+        , mSourceHash(support::HashSeed)
+    {
+        for (std::size_t i = 0; i < tokens.size(); ++i)
+        {
+            mSourceHash = HashToken(tokens, i, mSourceHash);
+        }
+
+        std::sort(importHashes.begin(), importHashes.end()); // The same modules can be found in a different order
+        for (std::uint64_t importHash : importHashes)
+        {
+            mSourceHash = support::Hash(std::string_view(reinterpret_cast<const char*>(&importHash), sizeof(importHash)), mSourceHash);
+        }
+    }
+
+    bool IncrementalCache::isUpToDate(const std::filesystem::path& cachePath, const std::filesystem::path& outputPath) const
+    {
+        auto cache = ReadWholeFile(cachePath);
+        if (!cache) return false;
+
+        auto output = ReadWholeFile(outputPath);
+        if (!output) return false;
+
+        return *cache == serialize(support::Hash(*output));
+    }
+
+    bool IncrementalCache::writeFile(const std::filesystem::path& cachePath, const std::filesystem::path& outputPath) const
+    {
+        auto output = ReadWholeFile(outputPath);
+        if (!output) return false;
+
+        std::filesystem::path temporaryPath = cachePath;
+        temporaryPath += std::format(".{}.{}.tmp", getpid(), std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary);
+            if (!file) return false;
+
+            std::string data = serialize(support::Hash(*output));
+            file.write(data.data(), data.size());
+
+            if (!file)
+            {
+                file.close();
+                std::filesystem::remove(temporaryPath);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporaryPath, cachePath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temporaryPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    std::string IncrementalCache::serialize(std::uint64_t outputHash) const
+    {
+        auto appendU32 = [](std::string& data, std::uint32_t value) {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        auto appendU64 = [](std::string& data, std::uint64_t value) {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+
+        std::string data;
+        data.append(CacheMagic, sizeof(CacheMagic));
+        appendU32(data, CacheFormatVersion);
+        appendU32(data, support::BuildId().size());
+        data.append(support::BuildId());
+        appendU64(data, mOptionsHash);
+        appendU64(data, outputHash);
+        appendU64(data, mSourceHash);
+
+        return data;
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright 2024 solar-mist
+
+
+#include "symbol/ModuleCache.h"
+
+namespace symbol
+{
+    std::shared_ptr<const std::string> ModuleCache::find(std::uint64_t sourceHash)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mInterfaces.find(sourceHash);
+        if (it == mInterfaces.end())
+        {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    void ModuleCache::insert(std::uint64_t sourceHash, std::string interface)
+    {
+        auto data = std::make_shared<const std::string>(std::move(interface));
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mInterfaces.emplace(sourceHash, std::move(data)).second)
+        {
+            mInsertionOrder.push_back(sourceHash);
+        }
+    }
+
+    std::size_t ModuleCache::size()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mInsertionOrder.size();
+    }
+
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<const std::string>>> ModuleCache::getInterfacesSince(std::size_t index)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<const std::string>>> ret;
+        for (std::size_t i = index; i < mInsertionOrder.size(); ++i)
+        {
+            ret.emplace_back(mInsertionOrder[i], mInterfaces[mInsertionOrder[i]]);
+        }
+        return ret;
+    }
+}
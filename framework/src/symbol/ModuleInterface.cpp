@@ -0,0 +1,655 @@
+// Copyright 2024 solar-mist
+
+
+#include "symbol/ModuleInterface.h"
+#include "symbol/Import.h"
+
+#include "parser/Parser.h"
+#include "parser/ast/global/Namespace.h"
+#include "parser/ast/global/GlobalDeclaration.h"
+#include "parser/ast/global/UsingDeclaration.h"
+#include "parser/ast/statement/ConstexprStatement.h"
+
+#include "type/PointerType.h"
+#include "type/ArrayType.h"
+#include "type/FunctionType.h"
+#include "type/StructType.h"
+
+#include "support/BuildId.h"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace symbol
+{
+    constexpr char InterfaceMagic[4] = { 'V', 'P', 'I', '\0' };
+    constexpr std::uint32_t InterfaceFormatVersion = 1;
+
+    enum class InterfaceEntry : std::uint8_t
+    {
+        End,
+        Function,
+        Namespace,
+        Struct,
+        Global,
+        Constexpr,
+        Import,
+        Using,
+        Alias,
+        Enum
+    };
+
+    enum class InterfaceType : std::uint8_t
+    {
+        Named, // Builtin types by name, enums by mangled name
+        Struct,
+        Pointer,
+        Array,
+        Function
+    };
+
+
+    void InterfaceWriter::addFunction(const std::vector<parser::GlobalAttribute>& attributes, std::string_view name, Type* type, const std::vector<parser::FunctionArgument>& arguments, bool hasSymbol)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Function));
+        writeU32(attributes.size());
+        for (auto& attribute : attributes)
+        {
+            writeU8(static_cast<std::uint8_t>(attribute.getType()));
+        }
+        writeString(name);
+        writeType(type);
+        writeArguments(arguments);
+        writeU8(hasSymbol);
+    }
+
+    void InterfaceWriter::beginNamespace(std::string_view name)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Namespace));
+        writeString(name);
+    }
+
+    void InterfaceWriter::endNamespace()
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::End));
+    }
+
+    void InterfaceWriter::addStruct(const std::vector<std::string>& names, const std::vector<parser::StructField>& fields, const std::vector<parser::StructMethod>& methods, bool exported)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Struct));
+        writeNames(names);
+        writeU8(exported);
+
+        writeU32(fields.size());
+        for (auto& field : fields)
+        {
+            writeU8(field.priv);
+            writeString(field.name);
+            writeType(field.type);
+        }
+
+        writeU32(methods.size());
+        for (auto& method : methods)
+        {
+            writeU8(method.priv);
+            writeString(method.name);
+            writeType(method.type);
+            writeArguments(method.arguments);
+        }
+    }
+
+    void InterfaceWriter::addGlobal(const std::vector<std::string>& names, Type* type)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Global));
+        writeNames(names);
+        writeType(type);
+    }
+
+    void InterfaceWriter::addConstexpr(const std::vector<std::string>& names, Type* type)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Constexpr));
+        writeNames(names);
+        writeType(type);
+    }
+
+    void InterfaceWriter::addImport(const std::filesystem::path& path)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Import));
+        writeString(path.generic_string());
+    }
+
+    void InterfaceWriter::addUsing(const std::vector<std::string>& names, Type* type)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Using));
+        writeNames(names);
+        writeType(type);
+    }
+
+    void InterfaceWriter::addAlias(const std::vector<std::string>& names, Type* type)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Alias));
+        writeNames(names);
+        writeType(type);
+    }
+
+    void InterfaceWriter::addEnum(const std::vector<std::string>& names, const std::vector<parser::EnumField>& fields)
+    {
+        writeU8(static_cast<std::uint8_t>(InterfaceEntry::Enum));
+        writeNames(names);
+        writeU32(fields.size());
+        for (auto& field : fields)
+        {
+            writeString(field.name);
+            writeU32(field.value);
+        }
+    }
+
+    std::string InterfaceWriter::serialize(std::uint64_t sourceHash) const
+    {
+        const std::string& buildId = support::BuildId();
+        std::uint32_t versionLength = buildId.size();
+
+        std::string data;
+        data.reserve(sizeof(InterfaceMagic) + sizeof(InterfaceFormatVersion) + sizeof(versionLength) + versionLength + sizeof(sourceHash) + mBuffer.size() + 1);
+        data.append(InterfaceMagic, sizeof(InterfaceMagic));
+        data.append(reinterpret_cast<const char*>(&InterfaceFormatVersion), sizeof(InterfaceFormatVersion));
+        data.append(reinterpret_cast<const char*>(&versionLength), sizeof(versionLength));
+        data.append(buildId);
+        data.append(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+        data.append(mBuffer);
+        data.push_back(static_cast<char>(InterfaceEntry::End));
+
+        return data;
+    }
+
+    bool InterfaceWriter::writeFile(const std::filesystem::path& path, std::uint64_t sourceHash) const
+    {
+        // Several threads may write the same interface, so the temporary name is unique per thread
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += std::format(".{}.{}.tmp", getpid(), std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary);
+            if (!file) return false;
+
+            std::string data = serialize(sourceHash);
+            file.write(data.data(), data.size());
+
+            if (!file)
+            {
+                file.close();
+                std::filesystem::remove(temporaryPath);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporaryPath, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temporaryPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    void InterfaceWriter::writeU8(std::uint8_t value)
+    {
+        mBuffer.push_back(static_cast<char>(value));
+    }
+
+    void InterfaceWriter::writeU32(std::uint32_t value)
+    {
+        mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void InterfaceWriter::writeString(std::string_view value)
+    {
+        writeU32(value.size());
+        mBuffer.append(value);
+    }
+
+    void InterfaceWriter::writeNames(const std::vector<std::string>& names)
+    {
+        writeU32(names.size());
+        for (auto& name : names)
+        {
+            writeString(name);
+        }
+    }
+
+    void InterfaceWriter::writeType(Type* type)
+    {
+        if (type->isStructType())
+        {
+            writeU8(static_cast<std::uint8_t>(InterfaceType::Struct));
+            writeString(type->getMangleID());
+        }
+        else if (type->isPointerType())
+        {
+            writeU8(static_cast<std::uint8_t>(InterfaceType::Pointer));
+            writeType(static_cast<PointerType*>(type)->getBaseType());
+        }
+        else if (type->isArrayType())
+        {
+            ArrayType* arrayType = static_cast<ArrayType*>(type);
+            writeU8(static_cast<std::uint8_t>(InterfaceType::Array));
+            writeU32(arrayType->getCount());
+            writeType(arrayType->getBaseType());
+        }
+        else if (type->isFunctionType())
+        {
+            FunctionType* functionType = static_cast<FunctionType*>(type);
+            writeU8(static_cast<std::uint8_t>(InterfaceType::Function));
+            writeType(functionType->getReturnType());
+            writeU32(functionType->getArgumentTypes().size());
+            for (Type* argumentType : functionType->getArgumentTypes())
+            {
+                writeType(argumentType);
+            }
+        }
+        else
+        {
+            writeU8(static_cast<std::uint8_t>(InterfaceType::Named));
+            writeString(type->isEnumType() ? type->getMangleID() : std::string(type->getName()));
+        }
+    }
+
+    void InterfaceWriter::writeArguments(const std::vector<parser::FunctionArgument>& arguments)
+    {
+        writeU32(arguments.size());
+        for (auto& argument : arguments)
+        {
+            writeString(argument.name);
+            writeType(argument.type);
+        }
+    }
+
+
+    namespace
+    {
+        class MappedFile
+        {
+        public:
+            MappedFile(const std::filesystem::path& path)
+                : mData(nullptr)
+                , mSize(0)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) return;
+
+                struct stat st;
+                if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size != 0)
+                {
+                    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping != MAP_FAILED)
+                    {
+                        mData = static_cast<const char*>(mapping);
+                        mSize = st.st_size;
+                    }
+                }
+                close(fd);
+            }
+
+            ~MappedFile()
+            {
+                if (mData) munmap(const_cast<char*>(mData), mSize);
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            std::string_view getData() const { return std::string_view(mData, mSize); }
+
+        private:
+            const char* mData;
+            std::size_t mSize;
+        };
+
+        class InterfaceReader
+        {
+        public:
+            InterfaceReader(std::string_view data, const std::filesystem::path& path, support::Arena& arena, ImportManager& importManager, diagnostic::Diagnostics& diag)
+                : mData(data)
+                , mPosition(0)
+                , mPath(path)
+                , mArena(arena)
+                , mImportManager(importManager)
+                , mDiag(diag)
+                , mScope(nullptr)
+            {
+            }
+
+            bool readHeader(std::uint64_t sourceHash)
+            {
+                if (mData.size() < sizeof(InterfaceMagic) || std::memcmp(mData.data(), InterfaceMagic, sizeof(InterfaceMagic)) != 0)
+                    return false;
+                mPosition += sizeof(InterfaceMagic);
+
+                std::uint32_t formatVersion;
+                if (!readRaw(formatVersion) || formatVersion != InterfaceFormatVersion)
+                    return false;
+
+                std::uint32_t versionLength;
+                if (!readRaw(versionLength) || mData.size() - mPosition < versionLength || mData.substr(mPosition, versionLength) != support::BuildId())
+                    return false;
+                mPosition += versionLength;
+
+                std::uint64_t hash;
+                return readRaw(hash) && hash == sourceHash;
+            }
+
+            void readDeclarations(std::vector<parser::ASTNodePtr>& nodes)
+            {
+                while (true)
+                {
+                    InterfaceEntry entry = static_cast<InterfaceEntry>(readU8());
+                    switch (entry)
+                    {
+                        case InterfaceEntry::End:
+                            return;
+
+                        case InterfaceEntry::Function:
+                        {
+                            std::vector<parser::GlobalAttribute> attributes;
+                            std::uint32_t attributeCount = readCount();
+                            for (std::uint32_t i = 0; i < attributeCount; ++i)
+                            {
+                                attributes.push_back(parser::GlobalAttribute(static_cast<parser::GlobalAttributeType>(readU8())));
+                            }
+                            std::string name = readString();
+                            Type* type = readType();
+                            std::vector<parser::FunctionArgument> arguments = readArguments();
+
+                            if (readU8())
+                                mSymbols.push_back({name, type});
+                            nodes.push_back(mArena.make<parser::Function>(std::move(attributes), type, std::move(arguments), std::move(name), std::vector<parser::ASTNodePtr>(), nullptr));
+                            break;
+                        }
+
+                        case InterfaceEntry::Namespace:
+                        {
+                            std::string name = readString();
+
+                            Scope* scope = mArena.create<Scope>(mScope, nullptr);
+                            mScope = scope;
+
+                            std::vector<parser::ASTNodePtr> body;
+                            readDeclarations(body);
+
+                            mScope = scope->parent;
+
+                            mSymbols.push_back({name, nullptr});
+                            nodes.push_back(mArena.make<parser::Namespace>(std::move(name), std::move(body), scope));
+                            break;
+                        }
+
+                        case InterfaceEntry::Struct:
+                        {
+                            std::vector<std::string> names = readNames();
+                            bool exported = readU8();
+
+                            StructType* structType = StructType::Create(names, {});
+                            std::vector<StructType::Field>& fieldTypes = structType->getFields();
+
+                            std::vector<parser::StructField> fields;
+                            std::uint32_t fieldCount = readCount();
+                            for (std::uint32_t i = 0; i < fieldCount; ++i)
+                            {
+                                bool priv = readU8();
+                                std::string name = readString();
+                                Type* type = readType();
+
+                                fieldTypes.push_back({priv, name, type});
+                                fields.push_back({priv, std::move(name), type});
+                            }
+
+                            std::vector<parser::StructMethod> methods;
+                            std::uint32_t methodCount = readCount();
+                            for (std::uint32_t i = 0; i < methodCount; ++i)
+                            {
+                                bool priv = readU8();
+                                std::string name = readString();
+                                Type* type = readType();
+                                std::vector<parser::FunctionArgument> arguments = readArguments();
+
+                                methods.push_back({priv, std::move(name), type, std::move(arguments), std::vector<parser::ASTNodePtr>(), nullptr});
+                            }
+
+                            if (!exported)
+                                mStructTypesToRemove.push_back(structType);
+                            nodes.push_back(mArena.make<parser::StructDeclaration>(std::move(names), std::move(fields), std::move(methods), structType));
+                            break;
+                        }
+
+                        case InterfaceEntry::Global:
+                        {
+                            std::vector<std::string> names = readNames();
+                            Type* type = readType();
+
+                            mSymbols.push_back({names.back(), type});
+                            nodes.push_back(mArena.make<parser::GlobalDeclaration>(std::move(names), type, nullptr));
+                            break;
+                        }
+
+                        case InterfaceEntry::Constexpr:
+                        {
+                            std::vector<std::string> names = readNames();
+                            Type* type = readType();
+
+                            mSymbols.push_back({names.back(), type});
+                            nodes.push_back(mArena.make<parser::ConstexprStatement>(type, std::move(names), nullptr, lexing::Token(), true));
+                            break;
+                        }
+
+                        case InterfaceEntry::Import:
+                        {
+                            auto imported = mImportManager.ImportSymbols(readString(), mDiag);
+                            std::move(imported.first.begin(), imported.first.end(), std::back_inserter(nodes));
+                            std::move(imported.second.begin(), imported.second.end(), std::back_inserter(mSymbols));
+                            break;
+                        }
+
+                        case InterfaceEntry::Using:
+                        {
+                            std::vector<std::string> names = readNames();
+                            Type* type = readType();
+
+                            nodes.push_back(mArena.make<parser::UsingDeclaration>(std::move(names), type));
+                            break;
+                        }
+
+                        case InterfaceEntry::Alias:
+                        {
+                            std::vector<std::string> names = readNames();
+                            Type::AddAlias(std::move(names), readType());
+                            break;
+                        }
+
+                        case InterfaceEntry::Enum:
+                        {
+                            std::vector<std::string> names = readNames();
+
+                            std::vector<parser::EnumField> fields;
+                            std::uint32_t fieldCount = readCount();
+                            for (std::uint32_t i = 0; i < fieldCount; ++i)
+                            {
+                                std::string name = readString();
+                                fields.push_back({std::move(name), static_cast<int>(readU32())});
+                            }
+
+                            mSymbols.push_back({names.back(), nullptr});
+                            for (auto& field : fields)
+                            {
+                                mSymbols.push_back({field.name, nullptr});
+                            }
+                            nodes.push_back(mArena.make<parser::EnumDeclaration>(std::move(names), std::move(fields)));
+                            break;
+                        }
+
+                        default:
+                            malformed();
+                    }
+                }
+            }
+
+            std::vector<parser::GlobalSymbol> finish()
+            {
+                for (auto type : mStructTypesToRemove)
+                {
+                    StructType::Erase(type);
+                }
+                return std::move(mSymbols);
+            }
+
+        private:
+            std::string_view mData;
+            std::size_t mPosition;
+            const std::filesystem::path& mPath;
+
+            support::Arena& mArena;
+            ImportManager& mImportManager;
+            diagnostic::Diagnostics& mDiag;
+
+            Scope* mScope;
+            std::vector<parser::GlobalSymbol> mSymbols;
+            std::vector<Type*> mStructTypesToRemove;
+
+            // The header matched this source, so anything unreadable after it is corruption rather than a stale file
+            [[noreturn]] void malformed()
+            {
+                mDiag.fatalError(std::format("{}: malformed module interface", mPath.string()));
+            }
+
+            template <class T>
+            bool readRaw(T& value)
+            {
+                if (mData.size() - mPosition < sizeof(T)) return false;
+
+                std::memcpy(&value, mData.data() + mPosition, sizeof(T));
+                mPosition += sizeof(T);
+                return true;
+            }
+
+            std::uint8_t readU8()
+            {
+                std::uint8_t value;
+                if (!readRaw(value)) malformed();
+                return value;
+            }
+
+            std::uint32_t readU32()
+            {
+                std::uint32_t value;
+                if (!readRaw(value)) malformed();
+                return value;
+            }
+
+            // Every counted item takes at least one byte, so larger counts can only come from corruption
+            std::uint32_t readCount()
+            {
+                std::uint32_t count = readU32();
+                if (count > mData.size() - mPosition) malformed();
+                return count;
+            }
+
+            std::string readString()
+            {
+                std::uint32_t length = readU32();
+                if (mData.size() - mPosition < length) malformed();
+
+                std::string value(mData.substr(mPosition, length));
+                mPosition += length;
+                return value;
+            }
+
+            std::vector<std::string> readNames()
+            {
+                std::vector<std::string> names(readCount());
+                for (auto& name : names)
+                {
+                    name = readString();
+                }
+                if (names.empty()) malformed();
+                return names;
+            }
+
+            Type* readType()
+            {
+                Type* type = nullptr;
+                switch (static_cast<InterfaceType>(readU8()))
+                {
+                    case InterfaceType::Named:
+                        type = Type::Get(readString());
+                        break;
+                    case InterfaceType::Struct:
+                        type = StructType::Get(symbol::Intern(readString()));
+                        break;
+                    case InterfaceType::Pointer:
+                        type = PointerType::Create(readType());
+                        break;
+                    case InterfaceType::Array:
+                    {
+                        int count = readU32();
+                        type = ArrayType::Create(readType(), count);
+                        break;
+                    }
+                    case InterfaceType::Function:
+                    {
+                        Type* returnType = readType();
+                        std::vector<Type*> argumentTypes(readCount());
+                        for (auto& argumentType : argumentTypes)
+                        {
+                            argumentType = readType();
+                        }
+                        type = FunctionType::Create(returnType, std::move(argumentTypes));
+                        break;
+                    }
+                }
+
+                if (!type) malformed();
+                return type;
+            }
+
+            std::vector<parser::FunctionArgument> readArguments()
+            {
+                std::vector<parser::FunctionArgument> arguments;
+                std::uint32_t argumentCount = readCount();
+                for (std::uint32_t i = 0; i < argumentCount; ++i)
+                {
+                    std::string name = readString();
+                    arguments.push_back({std::move(name), readType()});
+                }
+                return arguments;
+            }
+        };
+    }
+
+    std::optional<std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>>> ReadModuleInterface(const std::filesystem::path& path, std::uint64_t sourceHash,
+        support::Arena& arena, ImportManager& importManager, diagnostic::Diagnostics& diag)
+    {
+        MappedFile file(path);
+        return ReadModuleInterface(file.getData(), path, sourceHash, arena, importManager, diag);
+    }
+
+    std::optional<std::pair<std::vector<parser::ASTNodePtr>, std::vector<parser::GlobalSymbol>>> ReadModuleInterface(std::string_view data, const std::filesystem::path& path,
+        std::uint64_t sourceHash, support::Arena& arena, ImportManager& importManager, diagnostic::Diagnostics& diag)
+    {
+        InterfaceReader reader(data, path, arena, importManager, diag);
+        if (!reader.readHeader(sourceHash))
+        {
+            return std::nullopt;
+        }
+
+        std::vector<parser::ASTNodePtr> nodes;
+        reader.readDeclarations(nodes);
+        return std::make_pair(std::move(nodes), reader.finish());
+    }
+}
@@ -0,0 +1,99 @@
+// Copyright 2024 solar-mist
+
+
+#include "symbol/ObjectCache.h"
+
+#include "support/BuildId.h"
+#include "support/Sha256.h"
+
+#include <cstdlib>
+#include <format>
+#include <thread>
+
+#include <unistd.h>
+
+namespace symbol
+{
+    // A hit is used without looking at what produced it, so the key is a SHA-256 of the inputs.
+    // Each piece is preceded by its length, so moving text from one piece to the next changes the key
+    struct KeyHash
+    {
+        support::Sha256 sha;
+
+        void add(std::string_view data)
+        {
+            std::uint64_t size = data.size();
+            sha.update(std::string_view(reinterpret_cast<const char*>(&size), sizeof(size)));
+            sha.update(data);
+        }
+    };
+
+
+    ObjectCache::ObjectCache(std::filesystem::path directory)
+        : mDirectory(std::move(directory))
+    {
+    }
+
+    std::filesystem::path ObjectCache::DefaultDirectory()
+    {
+        if (const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+        {
+            return std::filesystem::path(cacheHome) / "viper";
+        }
+        if (const char* home = std::getenv("HOME"); home && *home)
+        {
+            return std::filesystem::path(home) / ".cache" / "viper";
+        }
+        return std::filesystem::temp_directory_path() / "viper-cache";
+    }
+
+    std::string ObjectCache::key(const lexing::SourceBuffer& source, const std::vector<const lexing::SourceBuffer*>& imports, std::string_view options) const
+    {
+        KeyHash hash;
+        hash.add(support::BuildId());
+        hash.add(options);
+        hash.add(source.getPath().string()); // The output names its source file
+        hash.add(source.getText());
+        for (auto module : imports)
+        {
+            hash.add(module->getPath().filename().string());
+            hash.add(module->getText());
+        }
+        return hash.sha.hexDigest();
+    }
+
+    bool ObjectCache::fetch(const std::string& key, const std::filesystem::path& outputPath) const
+    {
+        std::error_code ec;
+        std::filesystem::copy_file(entryPath(key), outputPath, std::filesystem::copy_options::overwrite_existing, ec);
+        return !ec;
+    }
+
+    bool ObjectCache::store(const std::string& key, const std::filesystem::path& outputPath) const
+    {
+        std::filesystem::path path = entryPath(key);
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += std::format(".{}.{}.tmp", getpid(), std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec) return false;
+
+        std::filesystem::copy_file(outputPath, temporaryPath, std::filesystem::copy_options::overwrite_existing, ec);
+        if (!ec)
+        {
+            std::filesystem::rename(temporaryPath, path, ec);
+        }
+        if (ec)
+        {
+            std::filesystem::remove(temporaryPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    std::filesystem::path ObjectCache::entryPath(const std::string& key) const
+    {
+        return mDirectory / key.substr(0, 2) / key; // Keeps directories small on filesystems that are slow with many entries
+    }
+}
@@ -2,13 +2,13 @@
 
 
 #include "symbol/Scope.h"
+#include "symbol/CompilationContext.h"
 #include "symbol/NameMangling.h"
 #include "symbol/Identifier.h"
 
-#include <algorithm>
+#include "support/TimeReport.h"
 
-std::unordered_map<std::string, FunctionSymbol> GlobalFunctions;
-std::unordered_map<std::string, GlobalSymbol>   GlobalVariables;
+#include <algorithm>
 
 LocalSymbol::LocalSymbol(vipir::AllocaInst* alloca, Type* type)
     : alloca{alloca}
@@ -16,6 +16,11 @@ LocalSymbol::LocalSymbol(vipir::AllocaInst* alloca, Type* type)
 {
 }
 
+bool LocalSymbol::canPromote() const
+{
+    return !needsAlloca && (type->isIntegerType() || type->isBooleanType() || type->isEnumType() || type->isPointerType());
+}
+
 FunctionSymbol::FunctionSymbol(vipir::Function* function, Type* type, bool priv, bool mangle)
     : function(function)
     , priv(priv)
@@ -28,8 +33,9 @@ void FunctionSymbol::Create(vipir::Function* function, std::string mangledName,
 {
     symbol::AddIdentifier(mangledName, names);
 
-    GlobalFunctions[mangledName] = FunctionSymbol(function, type, priv, mangle);
-    GlobalFunctions[mangledName].names = std::move(names);
+    FunctionSymbol& functionSymbol = CompilationContext::Current().getGlobalFunctions()[symbol::Intern(mangledName)];
+    functionSymbol = FunctionSymbol(function, type, priv, mangle);
+    functionSymbol.names = std::move(names);
 }
 
 GlobalSymbol::GlobalSymbol(vipir::Value* global, Type* type)
@@ -38,15 +44,22 @@ GlobalSymbol::GlobalSymbol(vipir::Value* global, Type* type)
 {
 }
 
-FunctionSymbol* FindFunction(std::vector<std::string> givenNames, std::vector<std::string> activeNames, std::vector<Type*> arguments)
+FunctionSymbol* FindFunction(const std::vector<std::string>& givenNames, const std::vector<std::string>& activeNames, std::vector<Type*> arguments)
 {
-    std::vector<std::string> mangledNames = symbol::GetSymbol(givenNames, activeNames);
+    std::vector<symbol::SymbolID> mangledNames = symbol::GetSymbol(givenNames, activeNames);
+    auto& globalFunctions = CompilationContext::Current().getGlobalFunctions();
+
+    support::TimeReport* report = support::TimeReport::Current();
+    if (report) ++report->getCounters().functionLookups;
 
     for (auto name : mangledNames)
     {
-        if (GlobalFunctions.find(name) != GlobalFunctions.end())
+        if (report) ++report->getCounters().functionLookupCandidates;
+
+        auto it = globalFunctions.find(name);
+        if (it != globalFunctions.end())
         {
-            return &GlobalFunctions.at(name);
+            return &it->second;
         }
     }
 
@@ -58,14 +71,20 @@ Scope::Scope(Scope* parent, StructType* owner)
     , owner(owner)
     , breakTo(nullptr)
     , continueTo(nullptr)
+    , inlineReturn(nullptr)
 {
 }
 
 LocalSymbol* Scope::findVariable(const std::string& name)
 {
+    support::TimeReport* report = support::TimeReport::Current();
+    if (report) ++report->getCounters().variableLookups;
+
     Scope* scope = this;
     while (scope)
     {
+        if (report) ++report->getCounters().variableLookupScopes;
+
         if (scope->locals.find(name) != scope->locals.end())
         {
             return &scope->locals.at(name);
@@ -125,6 +144,22 @@ StructType* Scope::findOwner()
     return nullptr;
 }
 
+InlineReturn* Scope::findInlineReturn()
+{
+    Scope* scope = this;
+    while (scope)
+    {
+        if (scope->inlineReturn)
+        {
+            return scope->inlineReturn;
+        }
+
+        scope = scope->parent;
+    }
+
+    return nullptr;
+}
+
 std::vector<std::string> Scope::getNamespaces()
 {
     std::vector<std::string> ret;
@@ -142,4 +177,184 @@ std::vector<std::string> Scope::getNamespaces()
 
     std::reverse(ret.begin(), ret.end());
     return ret;
+}
+
+static vipir::Value* FindSSAValue(const SSAEdge& edge, LocalSymbol* local)
+{
+    auto it = std::find_if(edge.values.begin(), edge.values.end(), [local](const auto& value) {
+        return value.first == local;
+    });
+    return it != edge.values.end() ? it->second : nullptr;
+}
+
+SSAEdge Scope::getSSAEdge(vipir::IRBuilder& builder)
+{
+    SSAEdge edge{ builder.getInsertPoint() };
+
+    Scope* scope = this;
+    while (scope)
+    {
+        for (auto& [name, local] : scope->locals)
+        {
+            if (local.value)
+            {
+                edge.values.emplace_back(&local, local.value);
+            }
+        }
+
+        scope = scope->parent;
+    }
+
+    return edge;
+}
+
+void Scope::restoreSSAEdge(const SSAEdge& edge)
+{
+    for (auto& [local, value] : edge.values)
+    {
+        local->value = value;
+    }
+}
+
+void Scope::addSSAEdge(vipir::IRBuilder& builder, vipir::BasicBlock* to)
+{
+    Scope* scope = this;
+    while (scope)
+    {
+        if (scope->breakTo == to || scope->continueTo == to)
+        {
+            scope->ssaEdges[to].push_back(getSSAEdge(builder));
+            return;
+        }
+
+        scope = scope->parent;
+    }
+}
+
+std::vector<SSAEdge> Scope::takeSSAEdges(vipir::BasicBlock* to)
+{
+    auto it = ssaEdges.find(to);
+    if (it == ssaEdges.end())
+    {
+        return {};
+    }
+
+    std::vector<SSAEdge> edges = std::move(it->second);
+    ssaEdges.erase(it);
+    return edges;
+}
+
+void Scope::branchWithSSAEdge(vipir::IRBuilder& builder, vipir::BasicBlock* to, std::vector<SSAEdge>& edges)
+{
+    if (!isReachable(builder))
+    {
+        endUnreachable(builder);
+        return;
+    }
+
+    edges.push_back(getSSAEdge(builder));
+    builder.CreateBr(to);
+}
+
+bool Scope::isReachable(vipir::IRBuilder& builder)
+{
+    vipir::BasicBlock* block = builder.getInsertPoint();
+    if (block->hasTerminator())
+    {
+        return false;
+    }
+
+    Scope* root = this;
+    while (root->parent) root = root->parent;
+    return !root->unreachableBlocks.contains(block);
+}
+
+void Scope::endUnreachable(vipir::IRBuilder& builder)
+{
+    // Every block needs a terminator, and looping on itself keeps this one out of the phis of any other
+    vipir::BasicBlock* block = builder.getInsertPoint();
+    if (!block->hasTerminator())
+    {
+        builder.CreateBr(block);
+    }
+}
+
+void Scope::joinSSAEdges(vipir::IRBuilder& builder, const std::vector<SSAEdge>& edges)
+{
+    if (edges.empty()) // Nothing reaches the join, so whatever is emitted there never runs
+    {
+        Scope* root = this;
+        while (root->parent) root = root->parent;
+        root->unreachableBlocks.insert(builder.getInsertPoint());
+        return;
+    }
+
+    for (auto& [local, value] : edges.front().values)
+    {
+        bool same = true;
+        bool everywhere = true;
+        for (auto& edge : edges)
+        {
+            vipir::Value* incoming = FindSSAValue(edge, local);
+            everywhere &= incoming != nullptr;
+            same &= incoming == value;
+        }
+
+        if (!everywhere) // Declared on only some of the paths in, so it is out of scope past the join
+        {
+            continue;
+        }
+
+        if (same)
+        {
+            local->value = value;
+            continue;
+        }
+
+        vipir::PhiInst* phi = builder.CreatePhi(local->type->getVipirType());
+        for (auto& edge : edges)
+        {
+            phi->addIncoming(FindSSAValue(edge, local), edge.from);
+        }
+        local->value = phi;
+    }
+}
+
+std::vector<std::pair<LocalSymbol*, vipir::PhiInst*> > Scope::createLoopPhis(vipir::IRBuilder& builder, const SSAEdge& entry)
+{
+    std::vector<std::pair<LocalSymbol*, vipir::PhiInst*> > phis;
+    for (LocalSymbol* local : assignedLocals)
+    {
+        vipir::Value* value = FindSSAValue(entry, local);
+        if (!value) // Kept in memory, or declared inside the loop
+        {
+            continue;
+        }
+
+        vipir::PhiInst* phi = builder.CreatePhi(local->type->getVipirType());
+        phi->addIncoming(value, entry.from);
+        local->value = phi;
+
+        phis.emplace_back(local, phi);
+    }
+    return phis;
+}
+
+void Scope::CompleteLoopPhis(const std::vector<std::pair<LocalSymbol*, vipir::PhiInst*> >& phis, const std::vector<SSAEdge>& backEdges)
+{
+    for (auto& [local, phi] : phis)
+    {
+        for (auto& edge : backEdges)
+        {
+            phi->addIncoming(FindSSAValue(edge, local), edge.from);
+        }
+    }
+}
+
+void Scope::clearSSAValues()
+{
+    for (auto& [name, local] : locals)
+    {
+        local.value = nullptr;
+    }
 }
\ No newline at end of file
@@ -2,20 +2,17 @@
 
 
 #include "type/ArrayType.h"
+#include "type/TypeContext.h"
 
-#include <vector>
 #include <vipir/Type/ArrayType.h>
 
-#include <algorithm>
 #include <format>
-#include <unordered_map>
-
-extern std::unordered_map<std::string, std::unique_ptr<Type>> types;
 
 ArrayType::ArrayType(Type* base, int count)
     : Type(std::format("{}[{}]", base->getName(), count))
     , mBase(base)
     , mCount(count)
+    , mMangleID(base->getMangleID() + std::to_string(count))
 {
 }
 
@@ -24,6 +21,11 @@ Type* ArrayType::getBaseType() const
     return mBase;
 }
 
+int ArrayType::getCount() const
+{
+    return mCount;
+}
+
 int ArrayType::getSize() const
 {
     return mBase->getSize() * mCount;
@@ -36,7 +38,7 @@ vipir::Type* ArrayType::getVipirType() const
 
 std::string ArrayType::getMangleID() const
 {
-    return mBase->getMangleID() + std::to_string(mCount);
+    return mMangleID;
 }
 
 bool ArrayType::isArrayType() const
@@ -46,17 +48,5 @@ bool ArrayType::isArrayType() const
 
 ArrayType* ArrayType::Create(Type* base, int count)
 {
-    static std::vector<std::unique_ptr<ArrayType> > arrayTypes;
-
-    auto it = std::find_if(arrayTypes.begin(), arrayTypes.end(), [base](const std::unique_ptr<ArrayType>& type){
-        return type->getBaseType() == base;
-    });
-
-    if (it != arrayTypes.end())
-    {
-        return it->get();
-    }
-
-    arrayTypes.push_back(std::make_unique<ArrayType>(base, count));
-    return arrayTypes.back().get();
+    return TypeContext::Current().getArrayType(base, count);
 }
\ No newline at end of file
@@ -2,8 +2,7 @@
 
 
 #include "type/EnumType.h"
-
-#include <unordered_map>
+#include "type/TypeContext.h"
 
 EnumType::EnumType(std::vector<std::string> names)
     : Type(names.back())
@@ -38,12 +37,10 @@ bool EnumType::isEnumType() const
     return true;
 }
 
-extern std::unordered_map<std::string, std::unique_ptr<Type>> types;
 EnumType* EnumType::Create(std::vector<std::string> names)
 {
     std::unique_ptr<Type> type = std::make_unique<EnumType>(names);
-    std::string mangleID = type->getMangleID();
-    types[mangleID] = std::move(type);
+    symbol::SymbolID mangleID = symbol::Intern(type->getMangleID());
 
-    return static_cast<EnumType*>(types[mangleID].get());
+    return static_cast<EnumType*>(TypeContext::Current().addNamedType(mangleID, std::move(type)));
 }
\ No newline at end of file
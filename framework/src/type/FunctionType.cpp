@@ -2,10 +2,10 @@
 
 
 #include "type/FunctionType.h"
+#include "type/TypeContext.h"
 
 #include <vipir/Type/FunctionType.h>
 
-#include <algorithm>
 #include <format>
 
 FunctionType::FunctionType(Type* returnType, std::vector<Type*> arguments)
@@ -25,6 +25,12 @@ FunctionType::FunctionType(Type* returnType, std::vector<Type*> arguments)
     {
         mName += ")";
     }
+
+    mMangleID = "F" + mReturnType->getMangleID();
+    for (auto argument : mArguments)
+    {
+        mMangleID += argument->getMangleID();
+    }
 }
 
 Type* FunctionType::getReturnType() const
@@ -54,12 +60,7 @@ vipir::Type* FunctionType::getVipirType() const
 
 std::string FunctionType::getMangleID() const
 {
-    std::string ret = "F" + mReturnType->getMangleID();
-    for (auto argument : mArguments)
-    {
-        ret += argument->getMangleID();
-    }
-    return ret;
+    return mMangleID;
 }
 
 bool FunctionType::isFunctionType() const
@@ -69,16 +70,5 @@ bool FunctionType::isFunctionType() const
 
 FunctionType* FunctionType::Create(Type* returnType, std::vector<Type*> arguments)
 {
-    static std::vector<std::unique_ptr<FunctionType> > functionTypes;
-    auto it = std::find_if(functionTypes.begin(), functionTypes.end(), [returnType, &arguments](const auto& type){
-        return type->getReturnType() == returnType && type->getArgumentTypes() == arguments;
-    });
-
-    if (it != functionTypes.end())
-    {
-        return it->get();
-    }
-
-    functionTypes.push_back(std::make_unique<FunctionType>(returnType, std::move(arguments)));
-    return functionTypes.back().get();
+    return TypeContext::Current().getFunctionType(returnType, std::move(arguments));
 }
\ No newline at end of file
@@ -2,19 +2,16 @@
 
 
 #include "type/PointerType.h"
+#include "type/TypeContext.h"
 
-#include <vector>
 #include <vipir/Type/PointerType.h>
 
-#include <algorithm>
 #include <format>
-#include <unordered_map>
-
-extern std::unordered_map<std::string, std::unique_ptr<Type>> types;
 
 PointerType::PointerType(Type* base)
     : Type(std::format("{}*", base->getName()))
     , mBase(base)
+    , mMangleID(base->getMangleID() + "P")
 {
 }
 
@@ -35,7 +32,7 @@ vipir::Type* PointerType::getVipirType() const
 
 std::string PointerType::getMangleID() const
 {
-    return mBase->getMangleID() + "P";
+    return mMangleID;
 }
 
 bool PointerType::isPointerType() const
@@ -45,17 +42,5 @@ bool PointerType::isPointerType() const
 
 PointerType* PointerType::Create(Type* base)
 {
-    static std::vector<std::unique_ptr<PointerType> > pointerTypes;
-
-    auto it = std::find_if(pointerTypes.begin(), pointerTypes.end(), [base](const std::unique_ptr<PointerType>& type){
-        return type->getBaseType() == base;
-    });
-
-    if (it != pointerTypes.end())
-    {
-        return it->get();
-    }
-
-    pointerTypes.push_back(std::make_unique<PointerType>(base));
-    return pointerTypes.back().get();
+    return TypeContext::Current().getPointerType(base);
 }
\ No newline at end of file
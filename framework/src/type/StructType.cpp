@@ -3,6 +3,7 @@
 
 #include "type/StructType.h"
 #include "type/PointerType.h"
+#include "type/TypeContext.h"
 
 #include "symbol/Identifier.h"
 
@@ -18,7 +19,13 @@ StructType::StructType(std::vector<std::string> names, std::vector<Field> fields
     , mNames(std::move(names))
     , mFields(std::move(fields))
 {
-    symbol::AddIdentifier(getMangleID(), mNames);
+    mMangleID = "S";
+    for (auto& name : mNames)
+    {
+        mMangleID += std::to_string(name.length()) + name;
+    }
+
+    symbol::AddIdentifier(mMangleID, mNames);
 }
 
 std::string_view StructType::getName() const
@@ -90,12 +97,7 @@ vipir::Type* StructType::getVipirType() const
 
 std::string StructType::getMangleID() const
 {
-    std::string ret = "S";
-    for (auto name : mNames)
-    {
-        ret += std::to_string(name.length()) + name;
-    }
-    return ret;
+    return mMangleID;
 }
 
 bool StructType::isStructType() const
@@ -104,37 +106,17 @@ bool StructType::isStructType() const
 }
 
 
-static std::vector<std::unique_ptr<StructType> > structTypes;
-
-StructType* StructType::Get(std::string name)
+StructType* StructType::Get(symbol::SymbolID mangledName)
 {
-    auto it = std::find_if(structTypes.begin(), structTypes.end(), [&name](const auto& type){
-        return type->getMangleID() == name;
-    });
-    if (it == structTypes.end()) return nullptr;
-    return it->get();
+    return TypeContext::Current().findStructType(mangledName);
 }
 
 StructType* StructType::Create(std::vector<std::string> names, std::vector<StructType::Field> fields)
 {
-    auto it = std::find_if(structTypes.begin(), structTypes.end(), [&names](const auto& type){
-        return type->mNames == names;
-    });
-
-    if (it != structTypes.end())
-    {
-        return it->get();
-    }
-
-    structTypes.push_back(std::make_unique<StructType>(names, std::move(fields)));
-    return structTypes.back().get();
+    return TypeContext::Current().getStructType(std::move(names), std::move(fields));
 }
 
 void StructType::Erase(Type* type)
 {
-    auto structType = static_cast<StructType*>(type);
-    
-    structTypes.erase(std::remove_if(structTypes.begin(), structTypes.end(), [structType](const auto& type){
-        return type.get() == structType;
-    }), structTypes.end());
-}
\ No newline at end of file
+    TypeContext::Current().eraseStructType(static_cast<StructType*>(type));
+}
@@ -2,39 +2,13 @@
 
 
 #include "type/Type.h"
-#include "type/IntegerType.h"
-#include "type/VoidType.h"
-#include "type/BooleanType.h"
+#include "type/TypeContext.h"
 
 #include "symbol/Identifier.h"
 
-#include <unordered_map>
-
-std::unordered_map<std::string, std::unique_ptr<Type>> types;
-std::unordered_map<std::string, Type*> aliases;
-
-void Type::Init()
-{
-    types["i8"]  = std::make_unique<IntegerType>(8, true);
-    types["i16"] = std::make_unique<IntegerType>(16, true);
-    types["i32"] = std::make_unique<IntegerType>(32, true);
-    types["i64"] = std::make_unique<IntegerType>(64, true);
-    types["u8"]  = std::make_unique<IntegerType>(8, false);
-    types["u16"] = std::make_unique<IntegerType>(16, false);
-    types["u32"] = std::make_unique<IntegerType>(32, false);
-    types["u64"] = std::make_unique<IntegerType>(64, false);
-
-    types["void"] = std::make_unique<VoidType>();
-    types["bool"] = std::make_unique<BooleanType>();
-}
-
-bool Type::Exists(const std::string& name)
+bool Type::Exists(std::string_view name)
 {
-    auto type = types.find(name);
-    if (type != types.end()) return true;
-
-    auto alias = aliases.find(name);
-    return alias != aliases.end();
+    return Get(name) != nullptr;
 }
 
 void Type::AddAlias(std::vector<std::string> names, Type* type)
@@ -48,16 +22,18 @@ void Type::AddAlias(std::vector<std::string> names, Type* type)
     mangledName += type->getMangleID();
     symbol::AddIdentifier(mangledName, names);
 
-    aliases[mangledName] = type;
+    TypeContext::Current().addAlias(symbol::Intern(mangledName), type);
 }
 
-Type* Type::Get(const std::string& name)
+Type* Type::Get(std::string_view name)
 {
-    auto type = types.find(name);
-    if (type != types.end()) return type->second.get();
+    symbol::SymbolID id = symbol::Find(name);
+    if (id == symbol::InvalidSymbol) return nullptr;
 
-    auto alias =  aliases.find(name);
-    if (alias != aliases.end()) return alias->second;
+    return Get(id);
+}
 
-    return nullptr;
+Type* Type::Get(symbol::SymbolID name)
+{
+    return TypeContext::Current().findNamedType(name);
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+// Copyright 2024 solar-mist
+
+
+#include "type/TypeContext.h"
+#include "type/IntegerType.h"
+#include "type/VoidType.h"
+#include "type/BooleanType.h"
+
+#include "symbol/CompilationContext.h"
+
+#include "support/MemoryReport.h"
+
+#include <functional>
+
+static std::size_t HashCombine(std::size_t seed, std::size_t value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+std::size_t TypeContext::ArrayKeyHash::operator()(const ArrayKey& key) const
+{
+    return HashCombine(std::hash<Type*>()(key.base), std::hash<int>()(key.count));
+}
+
+std::size_t TypeContext::FunctionKeyHash::operator()(const std::vector<Type*>& key) const
+{
+    std::size_t hash = key.size();
+    for (Type* type : key)
+    {
+        hash = HashCombine(hash, std::hash<Type*>()(type));
+    }
+    return hash;
+}
+
+
+TypeContext::TypeContext(symbol::IdentifierTable& identifiers)
+    : mIdentifiers(identifiers)
+{
+    addNamedType(mIdentifiers.intern("i8"),   std::make_unique<IntegerType>(8, true));
+    addNamedType(mIdentifiers.intern("i16"),  std::make_unique<IntegerType>(16, true));
+    addNamedType(mIdentifiers.intern("i32"),  std::make_unique<IntegerType>(32, true));
+    addNamedType(mIdentifiers.intern("i64"),  std::make_unique<IntegerType>(64, true));
+    addNamedType(mIdentifiers.intern("u8"),   std::make_unique<IntegerType>(8, false));
+    addNamedType(mIdentifiers.intern("u16"),  std::make_unique<IntegerType>(16, false));
+    addNamedType(mIdentifiers.intern("u32"),  std::make_unique<IntegerType>(32, false));
+    addNamedType(mIdentifiers.intern("u64"),  std::make_unique<IntegerType>(64, false));
+
+    addNamedType(mIdentifiers.intern("void"), std::make_unique<VoidType>());
+    addNamedType(mIdentifiers.intern("bool"), std::make_unique<BooleanType>());
+}
+
+TypeContext& TypeContext::Current()
+{
+    return CompilationContext::Current().getTypes();
+}
+
+PointerType* TypeContext::getPointerType(Type* base)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    auto& type = mPointerTypes[base];
+    if (!type)
+    {
+        type = std::make_unique<PointerType>(base);
+    }
+    return type.get();
+}
+
+ArrayType* TypeContext::getArrayType(Type* base, int count)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    auto& type = mArrayTypes[{base, count}];
+    if (!type)
+    {
+        type = std::make_unique<ArrayType>(base, count);
+    }
+    return type.get();
+}
+
+FunctionType* TypeContext::getFunctionType(Type* returnType, std::vector<Type*> arguments)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    std::vector<Type*> key;
+    key.reserve(arguments.size() + 1);
+    key.push_back(returnType);
+    key.insert(key.end(), arguments.begin(), arguments.end());
+
+    auto& type = mFunctionTypes[std::move(key)];
+    if (!type)
+    {
+        type = std::make_unique<FunctionType>(returnType, std::move(arguments));
+    }
+    return type.get();
+}
+
+StructType* TypeContext::getStructType(std::vector<std::string> names, std::vector<StructType::Field> fields)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    auto& type = mStructTypes[mIdentifiers.internPath(names)];
+    if (!type)
+    {
+        type = std::make_unique<StructType>(std::move(names), std::move(fields));
+        mStructTypesByMangleID[mIdentifiers.intern(type->getMangleID())] = type.get();
+    }
+    return type.get();
+}
+
+StructType* TypeContext::findStructType(symbol::SymbolID mangledName)
+{
+    auto it = mStructTypesByMangleID.find(mangledName);
+    if (it == mStructTypesByMangleID.end()) return nullptr;
+    return it->second;
+}
+
+void TypeContext::eraseStructType(StructType* type)
+{
+    mStructTypesByMangleID.erase(mIdentifiers.intern(type->getMangleID()));
+    mStructTypes.erase(mIdentifiers.internPath(type->getNames()));
+}
+
+Type* TypeContext::addNamedType(symbol::SymbolID name, std::unique_ptr<Type> type)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    auto& slot = mNamedTypes[name];
+    slot = std::move(type);
+    return slot.get();
+}
+
+void TypeContext::addAlias(symbol::SymbolID mangledName, Type* type)
+{
+    support::MemoryReport::Owning owning(support::MemoryReport::Owner::Types);
+
+    mAliases[mangledName] = type;
+}
+
+Type* TypeContext::findNamedType(symbol::SymbolID name)
+{
+    auto type = mNamedTypes.find(name);
+    if (type != mNamedTypes.end()) return type->second.get();
+
+    auto alias = mAliases.find(name);
+    if (alias != mAliases.end()) return alias->second;
+
+    return nullptr;
+}
+
+std::size_t TypeContext::size() const
+{
+    return mPointerTypes.size() + mArrayTypes.size() + mFunctionTypes.size() + mStructTypes.size() + mNamedTypes.size();
+}
@@ -0,0 +1,54 @@
+// Copyright 2024 solar-mist
+
+// Text that ends inside a token must be reported, not lexed past the end of. The language
+// server lexes function bodies on their own while they are being typed, so this is common there
+
+#include "lexer/Lexer.h"
+
+#include "symbol/CompilationContext.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+// Lexes [start, end) of text like the language server does, and expects a collected error with message
+static void ExpectError(std::string text, int start, int end, std::string_view message)
+{
+    lexing::SourceBuffer source("test.vpr", text);
+
+    std::vector<diagnostic::Diagnostic> diagnostics;
+    diagnostic::Diagnostics diag;
+    diag.setText(source.getText());
+    diag.setCollected(&diagnostics);
+
+    try
+    {
+        lexing::Lexer lexer(source, diag, start, end);
+        lexer.lex();
+    }
+    catch (const diagnostic::CompileError&)
+    {
+    }
+
+    if (diagnostics.empty() || diagnostics.back().message != message)
+    {
+        std::cerr << "lexing '" << text.substr(start, end - start) << "': expected '" << message << "'\n";
+        ++failures;
+    }
+}
+
+int main()
+{
+    CompilationContext context;
+    context.makeCurrent();
+
+    std::string text = "func @f() -> i32 { \"abc }\nfunc @g() -> i32 { return 0; }";
+    ExpectError(text, 17, 25, "unterminated string literal"); // Just the body, as the language server reanalyses it
+    ExpectError(text, 0, text.size(), "unterminated string literal");
+    ExpectError("{ /* abc }", 0, 10, "unterminated comment");
+    ExpectError("{ /* abc * / }", 0, 14, "unterminated comment");
+
+    return failures == 0 ? 0 : 1;
+}